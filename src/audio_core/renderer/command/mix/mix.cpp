@@ -7,26 +7,10 @@
 
 #include "audio_core/adsp/apps/audio_renderer/command_list_processor.h"
 #include "audio_core/renderer/command/mix/mix.h"
+#include "audio_core/renderer/command/mix/mix_ramp.h"
 #include "common/fixed_point.h"
 
 namespace AudioCore::Renderer {
-/**
- * Mix input mix buffer into output mix buffer, with volume applied to the input.
- *
- * @tparam Q           - Number of bits for fixed point operations.
- * @param output       - Output mix buffer.
- * @param input        - Input mix buffer.
- * @param volume       - Volume applied to the input.
- * @param sample_count - Number of samples to process.
- */
-template <size_t Q>
-static void ApplyMix(std::span<s32> output, std::span<const s32> input, const f32 volume_,
-                     const u32 sample_count) {
-    const Common::FixedPoint<64 - Q, Q> volume{volume_};
-    for (u32 i = 0; i < sample_count; i++) {
-        output[i] = (output[i] + input[i] * volume).to_int();
-    }
-}
 
 void MixCommand::Dump([[maybe_unused]] const AudioRenderer::CommandListProcessor& processor,
                       std::string& string) {
@@ -50,11 +34,11 @@ void MixCommand::Process(const AudioRenderer::CommandListProcessor& processor) {
 
     switch (precision) {
     case 15:
-        ApplyMix<15>(output, input, volume, processor.sample_count);
+        ApplyMixRamp<15>(output, input, volume, 0.0f, processor.sample_count);
         break;
 
     case 23:
-        ApplyMix<23>(output, input, volume, processor.sample_count);
+        ApplyMixRamp<23>(output, input, volume, 0.0f, processor.sample_count);
         break;
 
     default:
@@ -1,6 +1,16 @@
 // SPDX-FileCopyrightText: Copyright 2022 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <limits>
+
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
 #include "audio_core/adsp/apps/audio_renderer/command_list_processor.h"
 #include "audio_core/renderer/command/mix/mix_ramp.h"
 #include "common/fixed_point.h"
@@ -8,24 +18,91 @@
 
 namespace AudioCore::Renderer {
 
+#if defined(ARCHITECTURE_x86_64)
+/// Signed 32x32 -> 64 bit multiply of lanes 0 and 2.
+static __m128i MulEvenLanes(__m128i a, __m128i b) {
+#if defined(__SSE4_1__)
+    return _mm_mul_epi32(a, b);
+#else
+    // Unsigned product, minus the contribution of the sign bits to the upper half
+    const __m128i product = _mm_mul_epu32(a, b);
+    const __m128i fixup = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(a, 31), b),
+                                        _mm_and_si128(_mm_srai_epi32(b, 31), a));
+    return _mm_sub_epi64(product, _mm_slli_epi64(fixup, 32));
+#endif
+}
+
+/**
+ * Mix four samples at a time with the same rounding as the scalar fixed point loop.
+ * Only the low 32 bits of the result are kept, so the 64 bit intermediates can use logical
+ * shifts and a zero extended output sample.
+ *
+ * @return Number of samples processed, 0 if the volumes do not fit in 32 bits.
+ */
+template <size_t Q>
+static u32 MixRampSSE2(s32* output, const s32* input, s64 volume, s64 ramp, u32 sample_count) {
+    const auto fits_s32 = [](s64 value) {
+        return value >= std::numeric_limits<s32>::min() && value <= std::numeric_limits<s32>::max();
+    };
+    const u32 count = sample_count & ~3U;
+    if (count == 0 || !fits_s32(volume) || !fits_s32(ramp) ||
+        !fits_s32(volume + ramp * static_cast<s64>(count - 1))) {
+        return 0;
+    }
+
+    const u32 ramp32 = static_cast<u32>(ramp);
+    const u32 volume32 = static_cast<u32>(volume);
+    // Volumes only wrap past the processed samples, so 32 bit lanes stay exact
+    __m128i volumes =
+        _mm_setr_epi32(static_cast<s32>(volume32), static_cast<s32>(volume32 + ramp32),
+                       static_cast<s32>(volume32 + ramp32 * 2),
+                       static_cast<s32>(volume32 + ramp32 * 3));
+    const __m128i volume_step = _mm_set1_epi32(static_cast<s32>(ramp32 * 4));
+    const __m128i low_mask = _mm_set1_epi64x(0xFFFFFFFF);
+    const __m128i fraction_mask = _mm_set1_epi64x((s64{1} << Q) - 1);
+
+    const auto mix = [&](__m128i product, __m128i out) {
+        const __m128i round = _mm_srli_epi64(_mm_and_si128(product, fraction_mask), 1);
+        const __m128i sum = _mm_add_epi64(_mm_add_epi64(_mm_slli_epi64(out, Q), product), round);
+        return _mm_srli_epi64(sum, Q);
+    };
+
+    for (u32 i = 0; i < count; i += 4) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i out = _mm_loadu_si128(reinterpret_cast<const __m128i*>(output + i));
+        const __m128i even = mix(MulEvenLanes(in, volumes), _mm_and_si128(out, low_mask));
+        const __m128i odd =
+            mix(MulEvenLanes(_mm_srli_epi64(in, 32), _mm_srli_epi64(volumes, 32)),
+                _mm_srli_epi64(out, 32));
+        const __m128i result = _mm_or_si128(_mm_and_si128(even, low_mask), _mm_slli_epi64(odd, 32));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), result);
+        volumes = _mm_add_epi32(volumes, volume_step);
+    }
+    return count;
+}
+#endif
+
 template <size_t Q>
 s32 ApplyMixRamp(std::span<s32> output, std::span<const s32> input, const f32 volume_,
                  const f32 ramp_, const u32 sample_count) {
-    Common::FixedPoint<64 - Q, Q> volume{volume_};
-    Common::FixedPoint<64 - Q, Q> sample{0};
-
-    if (ramp_ == 0.0f) {
-        for (u32 i = 0; i < sample_count; i++) {
-            sample = input[i] * volume;
-            output[i] = (output[i] + sample).to_int();
-        }
-    } else {
-        Common::FixedPoint<64 - Q, Q> ramp{ramp_};
-        for (u32 i = 0; i < sample_count; i++) {
-            sample = input[i] * volume;
-            output[i] = (output[i] + sample).to_int();
-            volume += ramp;
-        }
+    using Fixed = Common::FixedPoint<64 - Q, Q>;
+    Fixed volume{volume_};
+    const Fixed ramp{ramp_};
+    Fixed sample{0};
+
+    u32 i = 0;
+#if defined(ARCHITECTURE_x86_64)
+    // Leave at least the last sample to the scalar loop, it also produces the depop sample
+    if (sample_count > 0) {
+        i = MixRampSSE2<Q>(output.data(), input.data(), volume.to_raw(), ramp.to_raw(),
+                           sample_count - 1);
+        volume = Fixed::from_base(volume.to_raw() + ramp.to_raw() * static_cast<s64>(i));
+    }
+#endif
+    for (; i < sample_count; i++) {
+        sample = input[i] * volume;
+        output[i] = (output[i] + sample).to_int();
+        volume += ramp;
     }
     return sample.to_int();
 }
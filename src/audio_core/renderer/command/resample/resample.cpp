@@ -1,10 +1,83 @@
 // SPDX-FileCopyrightText: Copyright 2022 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
+
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#endif
+
 #include "audio_core/renderer/command/resample/resample.h"
 
 namespace AudioCore::Renderer {
 
+#if defined(ARCHITECTURE_x86_64)
+/**
+ * Apply four filter taps to four input samples.
+ * The products are truncated to 8 fractional bits like the scalar FixedPoint<56, 8> path, so the
+ * integer sums match it exactly.
+ */
+static __m128i ApplyTaps(const s16* input, const f32* lut) {
+    const __m128i samples = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input));
+    const __m128 values = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+    const __m128 products = _mm_mul_ps(values, _mm_loadu_ps(lut));
+    return _mm_cvttps_epi32(_mm_mul_ps(products, _mm_set1_ps(256.0f)));
+}
+
+/// Sum the lanes of each of the four vectors, returning the sums in order.
+static __m128i SumLanes(__m128i a, __m128i b, __m128i c, __m128i d) {
+    const __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b), _mm_unpackhi_epi32(a, b));
+    const __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d), _mm_unpackhi_epi32(c, d));
+    return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+}
+#endif
+
+/**
+ * Filter the input with a polyphase lookup table, NUM_TAPS coefficients per phase.
+ * Blocks of four output samples are computed at once when SIMD is available.
+ */
+template <size_t NUM_TAPS>
+static void ResampleFiltered(std::span<s32> output, std::span<const s16> input,
+                             std::span<const f32> lut,
+                             const Common::FixedPoint<49, 15>& sample_rate_ratio,
+                             Common::FixedPoint<49, 15>& fraction, const u32 samples_to_write) {
+    u32 read_index{0};
+    u32 i{0};
+#if defined(ARCHITECTURE_x86_64)
+    for (; i + 4 <= samples_to_write; i += 4) {
+        __m128i sums[4];
+        for (__m128i& sum : sums) {
+            const auto lut_index{(fraction.get_frac() >> 8) * NUM_TAPS};
+            sum = ApplyTaps(&input[read_index], &lut[lut_index]);
+            for (size_t tap = 4; tap < NUM_TAPS; tap += 4) {
+                sum = _mm_add_epi32(sum,
+                                    ApplyTaps(&input[read_index + tap], &lut[lut_index + tap]));
+            }
+            fraction += sample_rate_ratio;
+            read_index += static_cast<u32>(fraction.to_int_floor());
+            fraction.clear_int();
+        }
+        const __m128i result = SumLanes(sums[0], sums[1], sums[2], sums[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[i]), _mm_srai_epi32(result, 8));
+    }
+#endif
+    for (; i < samples_to_write; i++) {
+        const auto lut_index{(fraction.get_frac() >> 8) * NUM_TAPS};
+        Common::FixedPoint<56, 8> sum{0};
+        for (size_t tap = 0; tap < NUM_TAPS; tap++) {
+            sum += Common::FixedPoint<56, 8>{input[read_index + tap] * lut[lut_index + tap]};
+        }
+        output[i] = sum.to_int_floor();
+        fraction += sample_rate_ratio;
+        read_index += static_cast<u32>(fraction.to_int_floor());
+        fraction.clear_int();
+    }
+}
+
 static void ResampleLowQuality(std::span<s32> output, std::span<const s16> input,
                                const Common::FixedPoint<49, 15>& sample_rate_ratio,
                                Common::FixedPoint<49, 15>& fraction, const u32 samples_to_write) {
@@ -292,19 +365,7 @@ static void ResampleNormalQuality(std::span<s32> output, std::span<const s16> in
         }
     };
 
-    auto lut{get_lut()};
-    u32 read_index{0};
-    for (u32 i = 0; i < samples_to_write; i++) {
-        const auto lut_index{(fraction.get_frac() >> 8) * 4};
-        const Common::FixedPoint<56, 8> sample0{input[read_index + 0] * lut[lut_index + 0]};
-        const Common::FixedPoint<56, 8> sample1{input[read_index + 1] * lut[lut_index + 1]};
-        const Common::FixedPoint<56, 8> sample2{input[read_index + 2] * lut[lut_index + 2]};
-        const Common::FixedPoint<56, 8> sample3{input[read_index + 3] * lut[lut_index + 3]};
-        output[i] = (sample0 + sample1 + sample2 + sample3).to_int_floor();
-        fraction += sample_rate_ratio;
-        read_index += static_cast<u32>(fraction.to_int_floor());
-        fraction.clear_int();
-    }
+    ResampleFiltered<4>(output, input, get_lut(), sample_rate_ratio, fraction, samples_to_write);
 }
 
 static void ResampleHighQuality(std::span<s32> output, std::span<const s16> input,
@@ -842,24 +903,7 @@ static void ResampleHighQuality(std::span<s32> output, std::span<const s16> inpu
         }
     };
 
-    auto lut{get_lut()};
-    u32 read_index{0};
-    for (u32 i = 0; i < samples_to_write; i++) {
-        const auto lut_index{(fraction.get_frac() >> 8) * 8};
-        const Common::FixedPoint<56, 8> sample0{input[read_index + 0] * lut[lut_index + 0]};
-        const Common::FixedPoint<56, 8> sample1{input[read_index + 1] * lut[lut_index + 1]};
-        const Common::FixedPoint<56, 8> sample2{input[read_index + 2] * lut[lut_index + 2]};
-        const Common::FixedPoint<56, 8> sample3{input[read_index + 3] * lut[lut_index + 3]};
-        const Common::FixedPoint<56, 8> sample4{input[read_index + 4] * lut[lut_index + 4]};
-        const Common::FixedPoint<56, 8> sample5{input[read_index + 5] * lut[lut_index + 5]};
-        const Common::FixedPoint<56, 8> sample6{input[read_index + 6] * lut[lut_index + 6]};
-        const Common::FixedPoint<56, 8> sample7{input[read_index + 7] * lut[lut_index + 7]};
-        output[i] = (sample0 + sample1 + sample2 + sample3 + sample4 + sample5 + sample6 + sample7)
-                        .to_int_floor();
-        fraction += sample_rate_ratio;
-        read_index += static_cast<u32>(fraction.to_int_floor());
-        fraction.clear_int();
-    }
+    ResampleFiltered<8>(output, input, get_lut(), sample_rate_ratio, fraction, samples_to_write);
 }
 
 void Resample(std::span<s32> output, std::span<const s16> input,
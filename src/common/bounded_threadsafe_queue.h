@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
@@ -81,10 +82,14 @@ private:
             }
         } else if constexpr (Mode == PushMode::Wait) {
             // Wait until we have free slots to write to.
-            std::unique_lock lock{producer_cv_mutex};
-            producer_cv.wait(lock, [this, write_index] {
-                return (write_index - m_read_index.load(std::memory_order::acquire)) < Capacity;
-            });
+            if ((write_index - m_read_index.load(std::memory_order::acquire)) == Capacity) {
+                std::unique_lock lock{producer_cv_mutex};
+                ++m_producers_waiting;
+                producer_cv.wait(lock, [this, write_index] {
+                    return (write_index - m_read_index.load()) < Capacity;
+                });
+                --m_producers_waiting;
+            }
         } else {
             static_assert(Mode < PushMode::Count, "Invalid PushMode.");
         }
@@ -98,9 +103,14 @@ private:
         // Increment the write index.
         ++m_write_index;
 
-        // Notify the consumer that we have pushed into the queue.
-        std::scoped_lock lock{consumer_cv_mutex};
-        consumer_cv.notify_one();
+        // Notify the consumer that we have pushed into the queue, if it is waiting for data.
+        // Waiters register themselves under the mutex before checking the write index, and both
+        // sides use sequentially consistent accesses, so either they see the new element or we
+        // see them waiting.
+        if (m_consumers_waiting.load() != 0) {
+            std::scoped_lock lock{consumer_cv_mutex};
+            consumer_cv.notify_one();
+        }
 
         return true;
     }
@@ -116,16 +126,24 @@ private:
             }
         } else if constexpr (Mode == PopMode::Wait) {
             // Wait until the queue is not empty.
-            std::unique_lock lock{consumer_cv_mutex};
-            consumer_cv.wait(lock, [this, read_index] {
-                return read_index != m_write_index.load(std::memory_order::acquire);
-            });
+            if (read_index == m_write_index.load(std::memory_order::acquire)) {
+                std::unique_lock lock{consumer_cv_mutex};
+                ++m_consumers_waiting;
+                consumer_cv.wait(lock, [this, read_index] {
+                    return read_index != m_write_index.load();
+                });
+                --m_consumers_waiting;
+            }
         } else if constexpr (Mode == PopMode::WaitWithStopToken) {
             // Wait until the queue is not empty.
-            std::unique_lock lock{consumer_cv_mutex};
-            Common::CondvarWait(consumer_cv, lock, stop_token, [this, read_index] {
-                return read_index != m_write_index.load(std::memory_order::acquire);
-            });
+            if (read_index == m_write_index.load(std::memory_order::acquire)) {
+                std::unique_lock lock{consumer_cv_mutex};
+                ++m_consumers_waiting;
+                Common::CondvarWait(consumer_cv, lock, stop_token, [this, read_index] {
+                    return read_index != m_write_index.load();
+                });
+                --m_consumers_waiting;
+            }
             if (stop_token.stop_requested()) {
                 return false;
             }
@@ -142,9 +160,11 @@ private:
         // Increment the read index.
         ++m_read_index;
 
-        // Notify the producer that we have popped off the queue.
-        std::scoped_lock lock{producer_cv_mutex};
-        producer_cv.notify_one();
+        // Notify the producer that we have popped off the queue, if it is waiting for free slots.
+        if (m_producers_waiting.load() != 0) {
+            std::scoped_lock lock{producer_cv_mutex};
+            producer_cv.notify_one();
+        }
 
         return true;
     }
@@ -156,8 +176,10 @@ private:
 
     std::condition_variable_any producer_cv;
     std::mutex producer_cv_mutex;
+    std::atomic_size_t m_producers_waiting{0};
     std::condition_variable_any consumer_cv;
     std::mutex consumer_cv_mutex;
+    std::atomic_size_t m_consumers_waiting{0};
 };
 
 template <typename T, size_t Capacity = detail::DefaultCapacity>
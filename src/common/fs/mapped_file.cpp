@@ -0,0 +1,169 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <utility>
+
+#include "common/fs/file.h"
+#include "common/fs/mapped_file.h"
+#include "common/fs/path_util.h"
+#ifdef ANDROID
+#include "common/fs/fs_android.h"
+#endif
+#include "common/logging/log.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common::FS {
+
+namespace {
+
+#ifdef _WIN32
+
+const u8* MapFile(const std::filesystem::path& path, size_t& out_size) {
+    // Other handles may still write, rename or delete the file while it is mapped. Windows refuses
+    // to truncate a file that has a mapped view, so the view itself can not fault.
+    constexpr DWORD share_mode = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, share_mode, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+    // The view keeps a reference to the mapping object, so the handle can be closed right away.
+    void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr) {
+        return nullptr;
+    }
+    out_size = static_cast<size_t>(file_size.QuadPart);
+    return static_cast<const u8*>(view);
+}
+
+void UnmapFile(const u8* data, [[maybe_unused]] size_t size) {
+    UnmapViewOfFile(data);
+}
+
+#else
+
+const u8* MapFile(const std::filesystem::path& path, size_t& out_size) {
+#ifdef ANDROID
+    if (Android::IsContentUri(path)) {
+        // Content URIs can only be read through the Java layer, use the fallback path instead.
+        return nullptr;
+    }
+#endif
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return nullptr;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t file_size = static_cast<size_t>(st.st_size);
+    void* const view = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the file alive, so the descriptor is no longer needed.
+    close(fd);
+    if (view == MAP_FAILED) {
+        return nullptr;
+    }
+    out_size = file_size;
+    return static_cast<const u8*>(view);
+}
+
+void UnmapFile(const u8* data, size_t size) {
+    munmap(const_cast<u8*>(data), size);
+}
+
+#endif
+
+} // Anonymous namespace
+
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(const std::filesystem::path& path, bool allow_fallback) {
+    size_t mapped_size{};
+    if (const u8* const mapped = MapFile(path, mapped_size)) {
+        data = mapped;
+        size = mapped_size;
+        is_mapped = true;
+        return;
+    }
+    if (!allow_fallback) {
+        return;
+    }
+
+    // Mapping is not available for this file, read the whole contents into memory instead.
+    const IOFile file(path, FileAccessMode::Read, FileType::BinaryFile);
+    if (!file.IsOpen()) {
+        return;
+    }
+    const size_t file_size = static_cast<size_t>(file.GetSize());
+    if (file_size == 0) {
+        return;
+    }
+    fallback_buffer = std::make_unique<u8[]>(file_size);
+    if (file.ReadSpan(std::span<u8>(fallback_buffer.get(), file_size)) != file_size) {
+        LOG_ERROR(Common_Filesystem, "Failed to read the file at path={}", PathToUTF8String(path));
+        fallback_buffer.reset();
+        return;
+    }
+    data = fallback_buffer.get();
+    size = file_size;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+        is_mapped = std::exchange(other.is_mapped, false);
+        fallback_buffer = std::move(other.fallback_buffer);
+    }
+    return *this;
+}
+
+void MappedFile::Close() {
+    if (is_mapped) {
+        UnmapFile(data, size);
+    }
+    data = nullptr;
+    size = 0;
+    is_mapped = false;
+    fallback_buffer.reset();
+}
+
+bool MappedFile::IsOpen() const {
+    return data != nullptr;
+}
+
+bool MappedFile::IsMemoryMapped() const {
+    return is_mapped;
+}
+
+} // namespace Common::FS
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <span>
+
+#include "common/common_types.h"
+
+namespace Common::FS {
+
+/**
+ * A read-only view of the whole contents of a file.
+ * The file is memory mapped when the host supports it, otherwise its contents are read into a
+ * heap allocation once on construction. Either way, the returned span stays valid for the
+ * lifetime of the MappedFile object and may be read concurrently from any thread.
+ *
+ * A memory mapped view follows later writes to the file. On POSIX hosts, reading a page past the
+ * end of a file that was truncated after mapping raises SIGBUS, so the MappedFile must be closed
+ * before the file is truncated or rewritten.
+ */
+class MappedFile final {
+public:
+    MappedFile();
+
+    /**
+     * Maps the file at path for reading.
+     * Use IsOpen() to check whether the mapping succeeded.
+     *
+     * @param path Filesystem path
+     * @param allow_fallback Whether to read the file into memory when it can not be mapped
+     */
+    explicit MappedFile(const std::filesystem::path& path, bool allow_fallback = true);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// Unmaps the file if it is mapped.
+    void Close();
+
+    /**
+     * Checks whether the file is mapped.
+     * Empty files are never considered open.
+     *
+     * @returns True if the file is mapped, false otherwise.
+     */
+    [[nodiscard]] bool IsOpen() const;
+
+    /**
+     * Checks whether the contents are backed by a memory mapping rather than a heap copy.
+     *
+     * @returns True if the contents are memory mapped, false otherwise.
+     */
+    [[nodiscard]] bool IsMemoryMapped() const;
+
+    /**
+     * Gets the mapped contents of the file.
+     *
+     * @returns A span over the contents of the file, empty if the file is not open.
+     */
+    [[nodiscard]] std::span<const u8> Data() const {
+        return {data, size};
+    }
+
+    /**
+     * Gets the size of the mapped file.
+     *
+     * @returns The size of the file in bytes.
+     */
+    [[nodiscard]] size_t Size() const {
+        return size;
+    }
+
+private:
+    const u8* data{};
+    size_t size{};
+    bool is_mapped{};
+    std::unique_ptr<u8[]> fallback_buffer;
+};
+
+} // namespace Common::FS
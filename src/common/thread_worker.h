@@ -3,15 +3,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <functional>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <type_traits>
 #include <vector>
-#include <queue>
 
 #include "common/polyfill_thread.h"
 #include "common/thread.h"
@@ -19,6 +23,14 @@
 
 namespace Common {
 
+/**
+ * Pool of worker threads with optional per-worker state.
+ *
+ * Every worker owns a task deque guarded by its own lock. Submitted work is spread over the
+ * deques, workers drain their own deque in FIFO order and steal from the others when it runs
+ * dry, so producers and workers rarely contend on the same lock. A pool with a single worker
+ * runs its tasks in submission order.
+ */
 template <class StateType = void>
 class StatefulThreadWorker {
     static constexpr bool with_state = !std::is_same_v<StateType, void>;
@@ -33,42 +45,40 @@ class StatefulThreadWorker {
         std::conditional_t<with_state, UniqueFunction<void, StateType*>, UniqueFunction<void>>;
     using StateMaker = std::conditional_t<with_state, std::function<StateType()>, DummyCallable>;
 
+    struct alignas(128) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
 public:
     explicit StatefulThreadWorker(size_t num_workers, std::string name, StateMaker func = {})
-        : workers_queued{num_workers}, thread_name{std::move(name)} {
-        const auto lambda = [this, func](std::stop_token stop_token) {
+        : queues(std::max<size_t>(num_workers, 1)), workers_queued{num_workers},
+          thread_name{std::move(name)} {
+        const auto lambda = [this, func](std::stop_token stop_token, size_t worker_index) {
             Common::SetCurrentThreadName(thread_name.c_str());
             {
                 [[maybe_unused]] std::conditional_t<with_state, StateType, int> state{func()};
                 while (!stop_token.stop_requested()) {
                     Task task;
-                    {
-                        std::unique_lock lock{queue_mutex};
-                        if (requests.empty()) {
-                            wait_condition.notify_all();
-                        }
-                        Common::CondvarWait(condition, lock, stop_token,
-                                            [this] { return !requests.empty(); });
-                        if (stop_token.stop_requested()) {
-                            break;
-                        }
-                        task = std::move(requests.front());
-                        requests.pop();
+                    if (!TryPopTask(worker_index, task)) {
+                        WaitForTasks(stop_token);
+                        continue;
                     }
                     if constexpr (with_state) {
                         task(&state);
                     } else {
                         task();
                     }
-                    ++work_done;
+                    FinishTask();
                 }
             }
             ++workers_stopped;
+            std::scoped_lock lock{wait_mutex};
             wait_condition.notify_all();
         };
         threads.reserve(num_workers);
         for (size_t i = 0; i < num_workers; ++i) {
-            threads.emplace_back(lambda);
+            threads.emplace_back(lambda, i);
         }
     }
 
@@ -79,30 +89,141 @@ public:
     StatefulThreadWorker(StatefulThreadWorker&&) = delete;
 
     void QueueWork(Task work) {
+        ++work_scheduled;
+        WorkerQueue& queue = queues[next_queue.fetch_add(1, std::memory_order_relaxed) %
+                                    queues.size()];
         {
-            std::unique_lock lock{queue_mutex};
-            requests.emplace(std::move(work));
-            ++work_scheduled;
+            std::scoped_lock lock{queue.mutex};
+            queue.tasks.push_back(std::move(work));
+        }
+        PublishTasks(1);
+    }
+
+    /// Queues many tasks at once, taking each worker lock once and waking workers once
+    void QueueWorkBatch(std::vector<Task> works) {
+        if (works.empty()) {
+            return;
+        }
+        work_scheduled += works.size();
+        const size_t num_queues = queues.size();
+        const size_t first_queue = next_queue.fetch_add(num_queues, std::memory_order_relaxed);
+        const size_t per_queue = (works.size() + num_queues - 1) / num_queues;
+        auto it = works.begin();
+        for (size_t i = 0; i < num_queues && it != works.end(); ++i) {
+            const auto end = it + std::min<std::ptrdiff_t>(per_queue, works.end() - it);
+            WorkerQueue& queue = queues[(first_queue + i) % num_queues];
+            std::scoped_lock lock{queue.mutex};
+            queue.tasks.insert(queue.tasks.end(), std::make_move_iterator(it),
+                               std::make_move_iterator(end));
+            it = end;
         }
-        condition.notify_one();
+        PublishTasks(works.size());
     }
 
+    /**
+     * Waits until all queued work has finished.
+     * Stateless pools with more than one worker run pending tasks on the calling thread while
+     * waiting instead of sleeping. Pools with per-worker state or a single worker never run tasks
+     * outside of their workers, keeping their state and ordering guarantees.
+     */
     void WaitForRequests(std::stop_token stop_token = {}) {
         std::stop_callback callback(stop_token, [this] {
             for (auto& thread : threads) {
                 thread.request_stop();
             }
         });
-        std::unique_lock lock{queue_mutex};
-        wait_condition.wait(lock, [this] {
+        const auto is_done = [this] {
             return workers_stopped >= workers_queued || work_done >= work_scheduled;
-        });
+        };
+        if constexpr (!with_state) {
+            if (threads.size() > 1) {
+                while (!is_done() && !stop_token.stop_requested()) {
+                    Task task;
+                    if (!TryPopTask(queues.size(), task)) {
+                        break;
+                    }
+                    task();
+                    FinishTask();
+                }
+            }
+        }
+        std::unique_lock lock{wait_mutex};
+        wait_condition.wait(lock, is_done);
     }
 
 private:
-    std::queue<Task> requests;
-    std::mutex queue_mutex;
+    /**
+     * Takes a task from the worker's own deque, or steals one from another worker.
+     * Tasks are published after they are pushed, so pending_tasks may briefly drop below zero
+     * when a worker takes a task that has not been counted yet.
+     */
+    bool TryPopTask(size_t worker_index, Task& task) {
+        if (pending_tasks.load() <= 0) {
+            return false;
+        }
+        const size_t num_queues = queues.size();
+        if (worker_index < num_queues) {
+            WorkerQueue& queue = queues[worker_index];
+            std::scoped_lock lock{queue.mutex};
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                --pending_tasks;
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset <= num_queues; ++offset) {
+            WorkerQueue& queue = queues[(worker_index + offset) % num_queues];
+            std::scoped_lock lock{queue.mutex};
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                --pending_tasks;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WaitForTasks(std::stop_token stop_token) {
+        std::unique_lock lock{sleep_mutex};
+        ++sleeping_workers;
+        Common::CondvarWait(condition, lock, stop_token,
+                            [this] { return pending_tasks.load() > 0; });
+        --sleeping_workers;
+    }
+
+    void PublishTasks(size_t count) {
+        pending_tasks += static_cast<std::ptrdiff_t>(count);
+        // Sleeping workers check pending_tasks under the sleep lock, taking it here ensures the
+        // notification can not be missed between their check and their wait.
+        if (sleeping_workers.load() == 0) {
+            return;
+        }
+        {
+            std::scoped_lock lock{sleep_mutex};
+        }
+        if (count == 1) {
+            condition.notify_one();
+        } else {
+            condition.notify_all();
+        }
+    }
+
+    void FinishTask() {
+        if (++work_done >= work_scheduled) {
+            std::scoped_lock lock{wait_mutex};
+            wait_condition.notify_all();
+        }
+    }
+
+    std::vector<WorkerQueue> queues;
+    std::atomic<size_t> next_queue{};
+    std::atomic<std::ptrdiff_t> pending_tasks{};
+    std::atomic<size_t> sleeping_workers{};
+    std::mutex sleep_mutex;
     std::condition_variable_any condition;
+    std::mutex wait_mutex;
     std::condition_variable wait_condition;
     std::atomic<size_t> work_scheduled{};
     std::atomic<size_t> work_done{};
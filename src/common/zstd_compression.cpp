@@ -46,4 +46,10 @@ std::vector<u8> DecompressDataZSTD(std::span<const u8> compressed) {
     return decompressed;
 }
 
+bool DecompressDataZSTD(std::span<const u8> compressed, std::span<u8> decompressed) {
+    const std::size_t result_size = ZSTD_decompress(decompressed.data(), decompressed.size(),
+                                                    compressed.data(), compressed.size());
+    return !ZSTD_isError(result_size) && result_size == decompressed.size();
+}
+
 } // namespace Common::Compression
@@ -42,4 +42,14 @@ namespace Common::Compression {
  */
 [[nodiscard]] std::vector<u8> DecompressDataZSTD(std::span<const u8> compressed);
 
+/**
+ * Decompresses a source memory region with Zstandard into a caller provided memory region.
+ *
+ * @param compressed   the compressed source memory region.
+ * @param decompressed the destination memory region, sized to the expected decompressed size.
+ *
+ * @return true if the data was decompressed and filled the destination exactly.
+ */
+[[nodiscard]] bool DecompressDataZSTD(std::span<const u8> compressed, std::span<u8> decompressed);
+
 } // namespace Common::Compression
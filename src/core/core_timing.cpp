@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <bit>
+#include <limits>
 #include <mutex>
 #include <string>
 #include <tuple>
@@ -26,12 +28,22 @@ std::shared_ptr<EventType> CreateEvent(std::string name, TimedCallback&& callbac
     return std::make_shared<EventType>(std::move(callback), std::move(name));
 }
 
-struct CoreTiming::Event {
+struct Event {
     s64 time;
     u64 fifo_order;
     std::weak_ptr<EventType> type;
     s64 reschedule_time;
-    heap_t::handle_type handle{};
+
+    /// Links inside a timer wheel slot, or inside the inbox.
+    Event* prev{};
+    Event* next{};
+    /// Links among the pending events of the same type.
+    Event* type_prev{};
+    Event* type_next{};
+    u32 level{};
+    u32 slot{};
+    /// Set when the event is unscheduled while it sits in the ready heap.
+    bool cancelled{};
 
     // Sort by time, unless the times are the same, in which case sort by
     // the order added to the queue
@@ -44,10 +56,18 @@ struct CoreTiming::Event {
     }
 };
 
+namespace {
+/// Level used by events in the ready heap instead of a timer wheel slot.
+constexpr u32 READY_LEVEL = ~0U;
+
+constexpr auto ReadyCompare = [](const Event* left, const Event* right) { return *left > *right; };
+} // Anonymous namespace
+
 CoreTiming::CoreTiming() : clock{Common::CreateOptimalClock()} {}
 
 CoreTiming::~CoreTiming() {
     Reset();
+    FreeAllEvents();
 }
 
 void CoreTiming::ThreadEntry(CoreTiming& instance) {
@@ -73,7 +93,7 @@ void CoreTiming::Initialize(std::function<void()>&& on_thread_init_) {
 
 void CoreTiming::ClearPendingEvents() {
     std::scoped_lock lock{advance_lock, basic_lock};
-    event_queue.clear();
+    FreeAllEvents();
     event.Set();
 }
 
@@ -112,18 +132,13 @@ bool CoreTiming::IsRunning() const {
 
 bool CoreTiming::HasPendingEvents() const {
     std::scoped_lock lock{basic_lock};
-    return !(wait_set && event_queue.empty());
+    return !(wait_set && num_events == 0 && inbox.load() == nullptr);
 }
 
 void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
                                const std::shared_ptr<EventType>& event_type, bool absolute_time) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
-
-        auto h{event_queue.emplace(Event{next_time.count(), event_fifo_id++, event_type, 0})};
-        (*h).handle = h;
-    }
+    const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
+    PushEvent(next_time.count(), event_type, 0);
 
     event.Set();
 }
@@ -132,14 +147,8 @@ void CoreTiming::ScheduleLoopingEvent(std::chrono::nanoseconds start_time,
                                       std::chrono::nanoseconds resched_time,
                                       const std::shared_ptr<EventType>& event_type,
                                       bool absolute_time) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
-
-        auto h{event_queue.emplace(
-            Event{next_time.count(), event_fifo_id++, event_type, resched_time.count()})};
-        (*h).handle = h;
-    }
+    const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
+    PushEvent(next_time.count(), event_type, resched_time.count());
 
     event.Set();
 }
@@ -148,17 +157,10 @@ void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
                                  UnscheduleEventType type) {
     {
         std::scoped_lock lk{basic_lock};
+        DrainInbox();
 
-        std::vector<heap_t::handle_type> to_remove;
-        for (auto itr = event_queue.begin(); itr != event_queue.end(); itr++) {
-            const Event& e = *itr;
-            if (e.type.lock().get() == event_type.get()) {
-                to_remove.push_back(itr->handle);
-            }
-        }
-
-        for (auto& h : to_remove) {
-            event_queue.erase(h);
+        while (Event* const evt = event_type->scheduled_events) {
+            RemoveEvent(evt, *event_type);
         }
 
         event_type->sequence_number++;
@@ -170,6 +172,223 @@ void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
     }
 }
 
+void CoreTiming::PushEvent(s64 time, const std::shared_ptr<EventType>& event_type,
+                           s64 reschedule_time) {
+    Event* const evt = new Event{time, 0, event_type, reschedule_time};
+
+    std::unique_lock lk{basic_lock, std::try_to_lock};
+    if (!lk) {
+        // The queue is busy, leave the event in the inbox for the lock owner or the next Advance
+        // instead of waiting for it.
+        evt->next = inbox.load(std::memory_order_relaxed);
+        while (!inbox.compare_exchange_weak(evt->next, evt, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+        return;
+    }
+    // Keep the events of the inbox ahead of this one, they were scheduled before it
+    DrainInbox();
+    evt->fifo_order = event_fifo_id++;
+    InsertEvent(evt, *event_type);
+}
+
+void CoreTiming::DrainInbox() {
+    Event* evt = inbox.exchange(nullptr, std::memory_order_acquire);
+    if (!evt) {
+        return;
+    }
+    // The inbox is a stack, reverse it to assign FIFO ids in scheduling order
+    Event* reversed = nullptr;
+    while (evt) {
+        Event* const next = evt->next;
+        evt->next = reversed;
+        reversed = evt;
+        evt = next;
+    }
+    while (reversed) {
+        Event* const next = reversed->next;
+        if (const auto event_type{reversed->type.lock()}) {
+            reversed->fifo_order = event_fifo_id++;
+            InsertEvent(reversed, *event_type);
+        } else {
+            delete reversed;
+        }
+        reversed = next;
+    }
+}
+
+void CoreTiming::InsertEvent(Event* evt, EventType& event_type) {
+    evt->cancelled = false;
+    evt->type_prev = nullptr;
+    evt->type_next = event_type.scheduled_events;
+    if (evt->type_next) {
+        evt->type_next->type_prev = evt;
+    }
+    event_type.scheduled_events = evt;
+    ++num_events;
+
+    InsertIntoWheel(evt);
+}
+
+void CoreTiming::InsertIntoWheel(Event* evt) {
+    const u64 tick = static_cast<u64>(std::max<s64>(evt->time, 0)) >> TICK_SHIFT;
+    if (tick <= wheel_tick) {
+        evt->level = READY_LEVEL;
+        ready_events.push_back(evt);
+        std::push_heap(ready_events.begin(), ready_events.end(), ReadyCompare);
+        return;
+    }
+    // Place the event at the level of the highest slot index that differs from the current
+    // tick, every level below it is reached before the event is due.
+    const u32 level = static_cast<u32>(std::bit_width(tick ^ wheel_tick) - 1) / WHEEL_SLOT_BITS;
+    const u32 slot = static_cast<u32>(tick >> (level * WHEEL_SLOT_BITS)) & (WHEEL_SLOTS - 1);
+    Event*& head = wheel[level][slot];
+    evt->level = level;
+    evt->slot = slot;
+    evt->prev = nullptr;
+    evt->next = head;
+    if (head) {
+        head->prev = evt;
+    }
+    head = evt;
+    wheel_occupied[level] |= u64{1} << slot;
+}
+
+void CoreTiming::UnlinkEvent(Event* evt, EventType& event_type) {
+    if (evt->type_prev) {
+        evt->type_prev->type_next = evt->type_next;
+    } else {
+        event_type.scheduled_events = evt->type_next;
+    }
+    if (evt->type_next) {
+        evt->type_next->type_prev = evt->type_prev;
+    }
+    --num_events;
+}
+
+void CoreTiming::RemoveEvent(Event* evt, EventType& event_type) {
+    UnlinkEvent(evt, event_type);
+
+    if (evt->level == READY_LEVEL) {
+        // Removing from the middle of the heap is not possible, it is dropped when it is popped
+        evt->cancelled = true;
+        return;
+    }
+    if (evt->prev) {
+        evt->prev->next = evt->next;
+    } else {
+        wheel[evt->level][evt->slot] = evt->next;
+        if (!evt->next) {
+            wheel_occupied[evt->level] &= ~(u64{1} << evt->slot);
+        }
+    }
+    if (evt->next) {
+        evt->next->prev = evt->prev;
+    }
+    delete evt;
+}
+
+Event* CoreTiming::PopDueEvent(s64 time) {
+    const u64 tick = static_cast<u64>(std::max<s64>(time, 0)) >> TICK_SHIFT;
+    DrainInbox();
+    while (true) {
+        while (!ready_events.empty() && ready_events.front()->cancelled) {
+            std::pop_heap(ready_events.begin(), ready_events.end(), ReadyCompare);
+            delete ready_events.back();
+            ready_events.pop_back();
+        }
+        if (!ready_events.empty()) {
+            // Events left in the wheel are past the ready ones, nothing else can be due
+            Event* const evt = ready_events.front();
+            if (evt->time > time) {
+                return nullptr;
+            }
+            std::pop_heap(ready_events.begin(), ready_events.end(), ReadyCompare);
+            ready_events.pop_back();
+            return evt;
+        }
+        if (!AdvanceWheel(tick)) {
+            return nullptr;
+        }
+    }
+}
+
+bool CoreTiming::AdvanceWheel(u64 tick) {
+    const auto level_it = std::find_if(wheel_occupied.begin(), wheel_occupied.end(),
+                                       [](u64 occupied) { return occupied != 0; });
+    if (level_it == wheel_occupied.end()) {
+        return false;
+    }
+    // The lowest occupied slot of the lowest occupied level holds the earliest events
+    const u32 level = static_cast<u32>(level_it - wheel_occupied.begin());
+    const u32 slot = static_cast<u32>(std::countr_zero(*level_it));
+    const u32 shift = level * WHEEL_SLOT_BITS;
+    const u64 upper_mask = ~((u64{1} << (shift + WHEEL_SLOT_BITS)) - 1);
+    const u64 slot_tick = (wheel_tick & upper_mask) | (u64{slot} << shift);
+    if (slot_tick > tick) {
+        return false;
+    }
+    wheel_tick = slot_tick;
+
+    // Cascade the events of the slot to the lower levels, or to the ready heap
+    Event* evt = wheel[level][slot];
+    wheel[level][slot] = nullptr;
+    wheel_occupied[level] &= ~(u64{1} << slot);
+    while (evt) {
+        Event* const next = evt->next;
+        InsertIntoWheel(evt);
+        evt = next;
+    }
+    return true;
+}
+
+std::optional<s64> CoreTiming::NextEventTime() {
+    while (!ready_events.empty() && ready_events.front()->cancelled) {
+        std::pop_heap(ready_events.begin(), ready_events.end(), ReadyCompare);
+        delete ready_events.back();
+        ready_events.pop_back();
+    }
+    if (!ready_events.empty()) {
+        return ready_events.front()->time;
+    }
+    const auto level_it = std::find_if(wheel_occupied.begin(), wheel_occupied.end(),
+                                       [](u64 occupied) { return occupied != 0; });
+    if (level_it == wheel_occupied.end()) {
+        return std::nullopt;
+    }
+    const size_t level = static_cast<size_t>(level_it - wheel_occupied.begin());
+    s64 next_time = std::numeric_limits<s64>::max();
+    for (Event* evt = wheel[level][std::countr_zero(*level_it)]; evt; evt = evt->next) {
+        next_time = std::min(next_time, evt->time);
+    }
+    return next_time;
+}
+
+void CoreTiming::FreeAllEvents() {
+    const auto free_event = [](Event* evt) {
+        if (const auto event_type{evt->type.lock()}) {
+            event_type->scheduled_events = nullptr;
+        }
+        delete evt;
+    };
+    DrainInbox();
+    for (Event* const evt : ready_events) {
+        free_event(evt);
+    }
+    ready_events.clear();
+    for (u32 level = 0; level < WHEEL_LEVELS; ++level) {
+        for (Event*& head : wheel[level]) {
+            while (head) {
+                Event* const next = head->next;
+                free_event(head);
+                head = next;
+            }
+        }
+        wheel_occupied[level] = 0;
+    }
+    num_events = 0;
+}
+
 void CoreTiming::AddTicks(u64 ticks_to_add) {
     cpu_ticks += ticks_to_add;
     downcount -= static_cast<s64>(cpu_ticks);
@@ -201,59 +420,65 @@ std::optional<s64> CoreTiming::Advance() {
     std::scoped_lock lock{advance_lock, basic_lock};
     global_timer = GetGlobalTimeNs().count();
 
-    while (!event_queue.empty() && event_queue.top().time <= global_timer) {
-        const Event& evt = event_queue.top();
+    while (Event* const evt = PopDueEvent(global_timer)) {
+        const auto event_type{evt->type.lock()};
+        if (!event_type) {
+            // The other events of a destroyed type are never walked through its links
+            --num_events;
+            delete evt;
+            global_timer = GetGlobalTimeNs().count();
+            continue;
+        }
+        UnlinkEvent(evt, *event_type);
 
-        if (const auto event_type{evt.type.lock()}) {
-            const auto evt_time = evt.time;
-            const auto evt_sequence_num = event_type->sequence_number;
+        const auto evt_time = evt->time;
+        const auto evt_sequence_num = event_type->sequence_number;
 
-            if (evt.reschedule_time == 0) {
-                event_queue.pop();
+        if (evt->reschedule_time == 0) {
+            delete evt;
 
-                basic_lock.unlock();
+            basic_lock.unlock();
 
-                event_type->callback(
-                    evt_time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time});
+            event_type->callback(evt_time,
+                                 std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time});
 
-                basic_lock.lock();
-            } else {
-                basic_lock.unlock();
+            basic_lock.lock();
+        } else {
+            basic_lock.unlock();
 
-                const auto new_schedule_time{event_type->callback(
-                    evt_time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time})};
+            const auto new_schedule_time{event_type->callback(
+                evt_time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time})};
 
-                basic_lock.lock();
+            basic_lock.lock();
 
-                if (evt_sequence_num != event_type->sequence_number) {
-                    // Heap handle is invalidated after external modification.
-                    continue;
-                }
-
-                const auto next_schedule_time{new_schedule_time.has_value()
-                                                  ? new_schedule_time.value().count()
-                                                  : evt.reschedule_time};
+            if (evt_sequence_num != event_type->sequence_number) {
+                // The event was unscheduled while its callback ran.
+                delete evt;
+                global_timer = GetGlobalTimeNs().count();
+                continue;
+            }
 
-                // If this event was scheduled into a pause, its time now is going to be way
-                // behind. Re-set this event to continue from the end of the pause.
-                auto next_time{evt.time + next_schedule_time};
-                if (evt.time < pause_end_time) {
-                    next_time = pause_end_time + next_schedule_time;
-                }
+            const auto next_schedule_time{new_schedule_time.has_value()
+                                              ? new_schedule_time.value().count()
+                                              : evt->reschedule_time};
 
-                event_queue.update(evt.handle, Event{next_time, event_fifo_id++, evt.type,
-                                                     next_schedule_time, evt.handle});
+            // If this event was scheduled into a pause, its time now is going to be way
+            // behind. Re-set this event to continue from the end of the pause.
+            auto next_time{evt->time + next_schedule_time};
+            if (evt->time < pause_end_time) {
+                next_time = pause_end_time + next_schedule_time;
             }
+
+            evt->time = next_time;
+            evt->fifo_order = event_fifo_id++;
+            evt->reschedule_time = next_schedule_time;
+            InsertEvent(evt, *event_type);
         }
 
         global_timer = GetGlobalTimeNs().count();
     }
 
-    if (!event_queue.empty()) {
-        return event_queue.top().time;
-    } else {
-        return std::nullopt;
-    }
+    return NextEventTime();
 }
 
 void CoreTiming::ThreadLoop() {
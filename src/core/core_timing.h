@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <functional>
@@ -11,8 +12,7 @@
 #include <optional>
 #include <string>
 #include <thread>
-
-#include <boost/heap/fibonacci_heap.hpp>
+#include <vector>
 
 #include "common/common_types.h"
 #include "common/thread.h"
@@ -20,6 +20,8 @@
 
 namespace Core::Timing {
 
+struct Event;
+
 /// A callback that may be scheduled for a particular core timing event.
 using TimedCallback = std::function<std::optional<std::chrono::nanoseconds>(
     s64 time, std::chrono::nanoseconds ns_late)>;
@@ -36,6 +38,8 @@ struct EventType {
     /// A monotonic sequence number, incremented when this event is
     /// changed externally.
     size_t sequence_number;
+    /// Pending events of this type, linked by CoreTiming so they can be unscheduled directly.
+    Event* scheduled_events{};
 };
 
 enum class UnscheduleEventType {
@@ -139,13 +143,31 @@ public:
 #endif
 
 private:
-    struct Event;
+    /// Number of bits of a timestamp in nanoseconds covered by a single timer wheel tick.
+    static constexpr u32 TICK_SHIFT = 10;
+    /// Number of bits of a tick indexed by each timer wheel level.
+    static constexpr u32 WHEEL_SLOT_BITS = 6;
+    static constexpr u32 WHEEL_SLOTS = 1U << WHEEL_SLOT_BITS;
+    static constexpr u32 WHEEL_LEVELS = 9;
+
+    using WheelLevel = std::array<Event*, WHEEL_SLOTS>;
 
     static void ThreadEntry(CoreTiming& instance);
     void ThreadLoop();
 
     void Reset();
 
+    void PushEvent(s64 time, const std::shared_ptr<EventType>& event_type, s64 reschedule_time);
+    void DrainInbox();
+    void InsertEvent(Event* evt, EventType& event_type);
+    void InsertIntoWheel(Event* evt);
+    void UnlinkEvent(Event* evt, EventType& event_type);
+    void RemoveEvent(Event* evt, EventType& event_type);
+    Event* PopDueEvent(s64 time);
+    bool AdvanceWheel(u64 tick);
+    std::optional<s64> NextEventTime();
+    void FreeAllEvents();
+
     std::unique_ptr<Common::WallClock> clock;
 
     s64 global_timer = 0;
@@ -154,12 +176,18 @@ private:
     s64 timer_resolution_ns;
 #endif
 
-    using heap_t =
-        boost::heap::fibonacci_heap<CoreTiming::Event, boost::heap::compare<std::greater<>>>;
-
-    heap_t event_queue;
+    /// Hierarchical timer wheel, level N slots span 2^(N * WHEEL_SLOT_BITS) ticks.
+    std::array<WheelLevel, WHEEL_LEVELS> wheel{};
+    std::array<u64, WHEEL_LEVELS> wheel_occupied{};
+    u64 wheel_tick = 0;
+    /// Events whose tick has been reached, kept as a min-heap ordered by time.
+    std::vector<Event*> ready_events;
+    size_t num_events = 0;
     u64 event_fifo_id = 0;
 
+    /// Events scheduled while basic_lock was held by another thread.
+    std::atomic<Event*> inbox{};
+
     Common::Event event{};
     Common::Event pause_event{};
     mutable std::mutex basic_lock;
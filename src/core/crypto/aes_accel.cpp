@@ -0,0 +1,399 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+
+#include "common/assert.h"
+#include "common/swap.h"
+#include "core/crypto/aes_accel.h"
+
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#include "common/x64/cpu_detect.h"
+#define HAS_AES_ACCEL 1
+#elif defined(ARCHITECTURE_arm64) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#define HAS_AES_ACCEL 1
+#endif
+
+// AES-NI is enabled per function so that the rest of the build keeps its baseline ISA. The ARMv8
+// path is only built when the compiler targets the Cryptography Extension.
+#if defined(ARCHITECTURE_x86_64) && !defined(_MSC_VER)
+#define AES_TARGET __attribute__((target("aes")))
+#else
+#define AES_TARGET
+#endif
+
+namespace Core::Crypto::AesAccel {
+
+#ifdef HAS_AES_ACCEL
+namespace {
+/// Number of independent blocks kept in flight
+constexpr std::size_t Lanes = 8;
+
+constexpr std::array<u8, 256> MakeSubstitutionBox() {
+    const auto rotate = [](u8 value, int shift) {
+        return static_cast<u8>((value << shift) | (value >> (8 - shift)));
+    };
+    std::array<u8, 256> sbox{};
+    u8 p = 1;
+    u8 q = 1;
+    // p walks the multiplicative group by powers of 3, q by powers of its inverse
+    do {
+        p = static_cast<u8>(p ^ (p << 1) ^ ((p & 0x80) != 0 ? 0x1B : 0));
+        q = static_cast<u8>(q ^ (q << 1));
+        q = static_cast<u8>(q ^ (q << 2));
+        q = static_cast<u8>(q ^ (q << 4));
+        if ((q & 0x80) != 0) {
+            q = static_cast<u8>(q ^ 0x09);
+        }
+        const u8 affine = static_cast<u8>(q ^ rotate(q, 1) ^ rotate(q, 2) ^ rotate(q, 3) ^
+                                          rotate(q, 4));
+        sbox[p] = static_cast<u8>(affine ^ 0x63);
+    } while (p != 1);
+    sbox[0] = 0x63;
+    return sbox;
+}
+
+constexpr std::array<u8, 256> SubstitutionBox = MakeSubstitutionBox();
+
+#if defined(ARCHITECTURE_x86_64)
+using Block = __m128i;
+
+AES_TARGET Block Load(const void* src) {
+    return _mm_loadu_si128(static_cast<const __m128i*>(src));
+}
+
+AES_TARGET void Store(void* dest, Block block) {
+    _mm_storeu_si128(static_cast<__m128i*>(dest), block);
+}
+
+AES_TARGET Block Xor(Block a, Block b) {
+    return _mm_xor_si128(a, b);
+}
+
+/// Builds a block from two little endian 64 bit halves
+AES_TARGET Block FromWords(u64 low, u64 high) {
+    return _mm_set_epi64x(static_cast<s64>(high), static_cast<s64>(low));
+}
+
+AES_TARGET Block InverseMixColumns(Block block) {
+    return _mm_aesimc_si128(block);
+}
+
+template <std::size_t N>
+AES_TARGET void EncryptBlocks(const Block* round_keys, Block* blocks) {
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_xor_si128(blocks[i], round_keys[0]);
+    }
+    for (std::size_t round = 1; round < NumRounds; ++round) {
+        for (std::size_t i = 0; i < N; ++i) {
+            blocks[i] = _mm_aesenc_si128(blocks[i], round_keys[round]);
+        }
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_aesenclast_si128(blocks[i], round_keys[NumRounds]);
+    }
+}
+
+template <std::size_t N>
+AES_TARGET void DecryptBlocks(const Block* round_keys, Block* blocks) {
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_xor_si128(blocks[i], round_keys[0]);
+    }
+    for (std::size_t round = 1; round < NumRounds; ++round) {
+        for (std::size_t i = 0; i < N; ++i) {
+            blocks[i] = _mm_aesdec_si128(blocks[i], round_keys[round]);
+        }
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_aesdeclast_si128(blocks[i], round_keys[NumRounds]);
+    }
+}
+#else
+using Block = uint8x16_t;
+
+Block Load(const void* src) {
+    return vld1q_u8(static_cast<const u8*>(src));
+}
+
+void Store(void* dest, Block block) {
+    vst1q_u8(static_cast<u8*>(dest), block);
+}
+
+Block Xor(Block a, Block b) {
+    return veorq_u8(a, b);
+}
+
+/// Builds a block from two little endian 64 bit halves
+Block FromWords(u64 low, u64 high) {
+    return vcombine_u8(vcreate_u8(low), vcreate_u8(high));
+}
+
+Block InverseMixColumns(Block block) {
+    return vaesimcq_u8(block);
+}
+
+// AESE and AESD add the round key before substituting, so the last key is applied separately
+template <std::size_t N>
+void EncryptBlocks(const Block* round_keys, Block* blocks) {
+    for (std::size_t round = 0; round < NumRounds - 1; ++round) {
+        for (std::size_t i = 0; i < N; ++i) {
+            blocks[i] = vaesmcq_u8(vaeseq_u8(blocks[i], round_keys[round]));
+        }
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] =
+            veorq_u8(vaeseq_u8(blocks[i], round_keys[NumRounds - 1]), round_keys[NumRounds]);
+    }
+}
+
+template <std::size_t N>
+void DecryptBlocks(const Block* round_keys, Block* blocks) {
+    for (std::size_t round = 0; round < NumRounds - 1; ++round) {
+        for (std::size_t i = 0; i < N; ++i) {
+            blocks[i] = vaesimcq_u8(vaesdq_u8(blocks[i], round_keys[round]));
+        }
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] =
+            veorq_u8(vaesdq_u8(blocks[i], round_keys[NumRounds - 1]), round_keys[NumRounds]);
+    }
+}
+#endif
+
+struct RoundKeys {
+    Block keys[NumRounds + 1];
+};
+
+using RoundKeyBytes = std::array<std::array<u8, BlockSize>, NumRounds + 1>;
+
+AES_TARGET RoundKeys LoadRoundKeys(const RoundKeyBytes& src) {
+    RoundKeys round_keys;
+    for (std::size_t round = 0; round <= NumRounds; ++round) {
+        round_keys.keys[round] = Load(src[round].data());
+    }
+    return round_keys;
+}
+
+template <std::size_t N>
+AES_TARGET void TranscodeBlocks(const RoundKeys& round_keys, Block* blocks, bool encrypt) {
+    if (encrypt) {
+        EncryptBlocks<N>(round_keys.keys, blocks);
+    } else {
+        DecryptBlocks<N>(round_keys.keys, blocks);
+    }
+}
+
+/// Big endian 128 bit counter split in two native halves
+struct Counter {
+    u64 high;
+    u64 low;
+
+    void Increment() {
+        if (++low == 0) {
+            ++high;
+        }
+    }
+
+    AES_TARGET Block ToBlock() const {
+        return FromWords(Common::swap64(high), Common::swap64(low));
+    }
+};
+
+/// XTS tweak, a little endian element of GF(2^128)
+struct Tweak {
+    u64 low;
+    u64 high;
+
+    void MultiplyByX() {
+        const u64 carry = high >> 63;
+        high = (high << 1) | (low >> 63);
+        low = (low << 1) ^ (carry * 0x87);
+    }
+
+    AES_TARGET Block ToBlock() const {
+        return FromWords(low, high);
+    }
+};
+} // Anonymous namespace
+
+bool IsSupported() {
+#if defined(ARCHITECTURE_x86_64)
+    return Common::GetCPUCaps().aes;
+#else
+    return true;
+#endif
+}
+
+AES_TARGET void ExpandKey(KeySchedule& schedule, const u8* key) {
+    std::array<u8, BlockSize*(NumRounds + 1)> words;
+    std::memcpy(words.data(), key, BlockSize);
+
+    u8 round_constant = 1;
+    for (std::size_t i = BlockSize; i < words.size(); i += 4) {
+        std::array<u8, 4> temp;
+        std::memcpy(temp.data(), words.data() + i - 4, temp.size());
+        if (i % BlockSize == 0) {
+            temp = {
+                static_cast<u8>(SubstitutionBox[temp[1]] ^ round_constant),
+                SubstitutionBox[temp[2]],
+                SubstitutionBox[temp[3]],
+                SubstitutionBox[temp[0]],
+            };
+            round_constant =
+                static_cast<u8>((round_constant << 1) ^ ((round_constant & 0x80) != 0 ? 0x1B : 0));
+        }
+        for (std::size_t j = 0; j < temp.size(); ++j) {
+            words[i + j] = static_cast<u8>(words[i + j - BlockSize] ^ temp[j]);
+        }
+    }
+    for (std::size_t round = 0; round <= NumRounds; ++round) {
+        std::memcpy(schedule.encrypt[round].data(), words.data() + round * BlockSize, BlockSize);
+    }
+
+    // Equivalent inverse cipher keys: reversed, with InvMixColumns applied to the inner rounds
+    schedule.decrypt[0] = schedule.encrypt[NumRounds];
+    for (std::size_t round = 1; round < NumRounds; ++round) {
+        Store(schedule.decrypt[round].data(),
+              InverseMixColumns(Load(schedule.encrypt[NumRounds - round].data())));
+    }
+    schedule.decrypt[NumRounds] = schedule.encrypt[0];
+}
+
+AES_TARGET void TranscodeECB(const KeySchedule& schedule, const u8* src, u8* dest,
+                             std::size_t num_blocks, bool encrypt) {
+    const RoundKeys round_keys = LoadRoundKeys(encrypt ? schedule.encrypt : schedule.decrypt);
+    std::size_t block = 0;
+    for (; block + Lanes <= num_blocks; block += Lanes) {
+        Block blocks[Lanes];
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            blocks[i] = Load(src + (block + i) * BlockSize);
+        }
+        TranscodeBlocks<Lanes>(round_keys, blocks, encrypt);
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            Store(dest + (block + i) * BlockSize, blocks[i]);
+        }
+    }
+    for (; block < num_blocks; ++block) {
+        Block single = Load(src + block * BlockSize);
+        TranscodeBlocks<1>(round_keys, &single, encrypt);
+        Store(dest + block * BlockSize, single);
+    }
+}
+
+AES_TARGET void TranscodeCTR(const KeySchedule& schedule, u8* counter, const u8* src, u8* dest,
+                             std::size_t size) {
+    const RoundKeys round_keys = LoadRoundKeys(schedule.encrypt);
+    Counter ctr;
+    std::memcpy(&ctr.high, counter, sizeof(u64));
+    std::memcpy(&ctr.low, counter + sizeof(u64), sizeof(u64));
+    ctr.high = Common::swap64(ctr.high);
+    ctr.low = Common::swap64(ctr.low);
+
+    const std::size_t num_blocks = size / BlockSize;
+    std::size_t block = 0;
+    for (; block + Lanes <= num_blocks; block += Lanes) {
+        Block keystream[Lanes];
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            keystream[i] = ctr.ToBlock();
+            ctr.Increment();
+        }
+        EncryptBlocks<Lanes>(round_keys.keys, keystream);
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            const std::size_t offset = (block + i) * BlockSize;
+            Store(dest + offset, Xor(Load(src + offset), keystream[i]));
+        }
+    }
+    for (; block < num_blocks; ++block) {
+        Block keystream = ctr.ToBlock();
+        ctr.Increment();
+        EncryptBlocks<1>(round_keys.keys, &keystream);
+        const std::size_t offset = block * BlockSize;
+        Store(dest + offset, Xor(Load(src + offset), keystream));
+    }
+    if (const std::size_t tail = size % BlockSize; tail != 0) {
+        Block keystream = ctr.ToBlock();
+        ctr.Increment();
+        EncryptBlocks<1>(round_keys.keys, &keystream);
+        std::array<u8, BlockSize> bytes;
+        Store(bytes.data(), keystream);
+        const std::size_t offset = num_blocks * BlockSize;
+        for (std::size_t i = 0; i < tail; ++i) {
+            dest[offset + i] = static_cast<u8>(src[offset + i] ^ bytes[i]);
+        }
+    }
+
+    ctr.high = Common::swap64(ctr.high);
+    ctr.low = Common::swap64(ctr.low);
+    std::memcpy(counter, &ctr.high, sizeof(u64));
+    std::memcpy(counter + sizeof(u64), &ctr.low, sizeof(u64));
+}
+
+AES_TARGET void TranscodeXTS(const KeySchedule& data_key, const KeySchedule& tweak_key,
+                             const u8* iv, const u8* src, u8* dest, std::size_t size,
+                             bool encrypt) {
+    ASSERT(size != 0 && size % BlockSize == 0);
+
+    Block encrypted_iv = Load(iv);
+    EncryptBlocks<1>(LoadRoundKeys(tweak_key.encrypt).keys, &encrypted_iv);
+    std::array<u8, BlockSize> iv_bytes;
+    Store(iv_bytes.data(), encrypted_iv);
+    Tweak tweak;
+    std::memcpy(&tweak.low, iv_bytes.data(), sizeof(u64));
+    std::memcpy(&tweak.high, iv_bytes.data() + sizeof(u64), sizeof(u64));
+
+    const RoundKeys round_keys = LoadRoundKeys(encrypt ? data_key.encrypt : data_key.decrypt);
+    const std::size_t num_blocks = size / BlockSize;
+    std::size_t block = 0;
+    for (; block + Lanes <= num_blocks; block += Lanes) {
+        Block tweaks[Lanes];
+        Block blocks[Lanes];
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            tweaks[i] = tweak.ToBlock();
+            tweak.MultiplyByX();
+            blocks[i] = Xor(Load(src + (block + i) * BlockSize), tweaks[i]);
+        }
+        TranscodeBlocks<Lanes>(round_keys, blocks, encrypt);
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            Store(dest + (block + i) * BlockSize, Xor(blocks[i], tweaks[i]));
+        }
+    }
+    for (; block < num_blocks; ++block) {
+        const Block current_tweak = tweak.ToBlock();
+        tweak.MultiplyByX();
+        Block single = Xor(Load(src + block * BlockSize), current_tweak);
+        TranscodeBlocks<1>(round_keys, &single, encrypt);
+        Store(dest + block * BlockSize, Xor(single, current_tweak));
+    }
+}
+#else
+bool IsSupported() {
+    return false;
+}
+
+void ExpandKey(KeySchedule& schedule, const u8* key) {
+    UNREACHABLE();
+}
+
+void TranscodeECB(const KeySchedule& schedule, const u8* src, u8* dest, std::size_t num_blocks,
+                  bool encrypt) {
+    UNREACHABLE();
+}
+
+void TranscodeCTR(const KeySchedule& schedule, u8* counter, const u8* src, u8* dest,
+                  std::size_t size) {
+    UNREACHABLE();
+}
+
+void TranscodeXTS(const KeySchedule& data_key, const KeySchedule& tweak_key, const u8* iv,
+                  const u8* src, u8* dest, std::size_t size, bool encrypt) {
+    UNREACHABLE();
+}
+#endif
+
+} // namespace Core::Crypto::AesAccel
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "common/common_types.h"
+
+/**
+ * AES-128 implemented with the host AES instructions (AES-NI on x86-64, the ARMv8 Cryptography
+ * Extension on arm64). Independent blocks are processed eight at a time so that several blocks
+ * are in flight in the AES units.
+ */
+namespace Core::Crypto::AesAccel {
+
+constexpr std::size_t BlockSize = 0x10;
+constexpr std::size_t NumRounds = 10;
+
+/// Expanded round keys of an AES-128 key, for both directions.
+struct KeySchedule {
+    alignas(16) std::array<std::array<u8, BlockSize>, NumRounds + 1> encrypt;
+    alignas(16) std::array<std::array<u8, BlockSize>, NumRounds + 1> decrypt;
+};
+
+/// Returns whether the host CPU supports the accelerated implementation.
+bool IsSupported();
+
+/// Expands a 16 byte key. Only valid when IsSupported() is true, as are all functions below.
+void ExpandKey(KeySchedule& schedule, const u8* key);
+
+/// Encrypts or decrypts num_blocks independent blocks.
+void TranscodeECB(const KeySchedule& schedule, const u8* src, u8* dest, std::size_t num_blocks,
+                  bool encrypt);
+
+/**
+ * XORs size bytes with the keystream of the big endian 128 bit counter. A partial last block
+ * consumes a whole counter value. The counter is advanced past the blocks used.
+ */
+void TranscodeCTR(const KeySchedule& schedule, u8* counter, const u8* src, u8* dest,
+                  std::size_t size);
+
+/**
+ * Encrypts or decrypts a single XTS data unit. The tweak is the encrypted iv and is multiplied
+ * by x in GF(2^128) for each block. size must be a non-zero multiple of the block size.
+ */
+void TranscodeXTS(const KeySchedule& data_key, const KeySchedule& tweak_key, const u8* iv,
+                  const u8* src, u8* dest, std::size_t size, bool encrypt);
+
+} // namespace Core::Crypto::AesAccel
@@ -1,10 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2018 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <mbedtls/cipher.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "core/crypto/aes_accel.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 
@@ -36,6 +39,13 @@ static_assert(static_cast<std::size_t>(Mode::XTS) ==
 struct CipherContext {
     mbedtls_cipher_context_t encryption_context;
     mbedtls_cipher_context_t decryption_context;
+
+    // AES-128 keys for the hardware path, only used when use_accel is set. XTS uses both keys.
+    bool use_accel;
+    Mode mode;
+    AesAccel::KeySchedule data_key;
+    AesAccel::KeySchedule tweak_key;
+    std::array<u8, AesAccel::BlockSize> iv;
 };
 
 template <typename Key, std::size_t KeySize>
@@ -57,6 +67,17 @@ Crypto::AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode)
     ASSERT(
         !mbedtls_cipher_setkey(&ctx->decryption_context, key.data(), KeySize * 8, MBEDTLS_DECRYPT));
     //"Failed to set key on mbedtls ciphers.");
+
+    // Every mode is AES-128 on the hardware path, XTS splits its key in a data and a tweak key
+    ctx->mode = mode;
+    ctx->use_accel = AesAccel::IsSupported() && KeySize == (mode == Mode::XTS ? 0x20 : 0x10);
+    ctx->iv = {};
+    if (ctx->use_accel) {
+        AesAccel::ExpandKey(ctx->data_key, key.data());
+        if (mode == Mode::XTS) {
+            AesAccel::ExpandKey(ctx->tweak_key, key.data() + AesAccel::BlockSize);
+        }
+    }
 }
 
 template <typename Key, std::size_t KeySize>
@@ -67,6 +88,10 @@ AESCipher<Key, KeySize>::~AESCipher() {
 
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* dest, Op op) const {
+    if (ctx->use_accel && TranscodeAccelerated(src, size, dest, op)) {
+        return;
+    }
+
     auto* const context = op == Op::Encrypt ? &ctx->encryption_context : &ctx->decryption_context;
 
     mbedtls_cipher_reset(context);
@@ -106,6 +131,40 @@ void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* des
     }
 }
 
+template <typename Key, std::size_t KeySize>
+bool AESCipher<Key, KeySize>::TranscodeAccelerated(const u8* src, std::size_t size, u8* dest,
+                                                   Op op) const {
+    const bool encrypt = op == Op::Encrypt;
+    switch (ctx->mode) {
+    case Mode::CTR:
+        // The counter carries over to the next call like the mbedtls context does
+        AesAccel::TranscodeCTR(ctx->data_key, ctx->iv.data(), src, dest, size);
+        return true;
+    case Mode::ECB: {
+        const std::size_t num_blocks = size / AesAccel::BlockSize;
+        AesAccel::TranscodeECB(ctx->data_key, src, dest, num_blocks, encrypt);
+        // A partial last block is zero padded
+        if (const std::size_t tail = size % AesAccel::BlockSize; tail != 0) {
+            const std::size_t offset = num_blocks * AesAccel::BlockSize;
+            std::array<u8, AesAccel::BlockSize> block{};
+            std::memcpy(block.data(), src + offset, tail);
+            AesAccel::TranscodeECB(ctx->data_key, block.data(), block.data(), 1, encrypt);
+            std::memcpy(dest + offset, block.data(), tail);
+        }
+        return true;
+    }
+    case Mode::XTS:
+        // Ciphertext stealing is left to mbedtls
+        if (size == 0 || size % AesAccel::BlockSize != 0) {
+            return false;
+        }
+        AesAccel::TranscodeXTS(ctx->data_key, ctx->tweak_key, ctx->iv.data(), src, dest, size,
+                               encrypt);
+        return true;
+    }
+    return false;
+}
+
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::XTSTranscode(const u8* src, std::size_t size, u8* dest,
                                            std::size_t sector_id, std::size_t sector_size, Op op) {
@@ -122,6 +181,9 @@ void AESCipher<Key, KeySize>::SetIV(std::span<const u8> data) {
     ASSERT_MSG((mbedtls_cipher_set_iv(&ctx->encryption_context, data.data(), data.size()) ||
                 mbedtls_cipher_set_iv(&ctx->decryption_context, data.data(), data.size())) == 0,
                "Failed to set IV on mbedtls ciphers.");
+
+    ctx->iv = {};
+    std::memcpy(ctx->iv.data(), data.data(), std::min(data.size(), ctx->iv.size()));
 }
 
 template class AESCipher<Key128>;
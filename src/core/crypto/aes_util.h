@@ -57,6 +57,9 @@ public:
                       std::size_t sector_size, Op op);
 
 private:
+    /// Transcodes with the host AES instructions, returns false if the request is not supported.
+    bool TranscodeAccelerated(const u8* src, std::size_t size, u8* dest, Op op) const;
+
     std::unique_ptr<CipherContext> ctx;
 };
 } // namespace Core::Crypto
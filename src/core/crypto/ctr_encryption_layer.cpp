@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 #include "core/crypto/ctr_encryption_layer.h"
 
 namespace Core::Crypto {
@@ -17,16 +18,20 @@ std::size_t CTREncryptionLayer::Read(u8* data, std::size_t length, std::size_t o
 
     const auto sector_offset = offset & 0xF;
     if (sector_offset == 0) {
-        UpdateIV(base_offset + offset);
         std::vector<u8> raw = base->ReadBytes(length, offset);
+        std::scoped_lock lk{cipher_mutex};
+        UpdateIV(base_offset + offset);
         cipher.Transcode(raw.data(), raw.size(), data, Op::Decrypt);
         return length;
     }
 
     // offset does not fall on block boundary (0x10)
     std::vector<u8> block = base->ReadBytes(0x10, offset - sector_offset);
-    UpdateIV(base_offset + offset - sector_offset);
-    cipher.Transcode(block.data(), block.size(), block.data(), Op::Decrypt);
+    {
+        std::scoped_lock lk{cipher_mutex};
+        UpdateIV(base_offset + offset - sector_offset);
+        cipher.Transcode(block.data(), block.size(), block.data(), Op::Decrypt);
+    }
     std::size_t read = 0x10 - sector_offset;
 
     if (length + sector_offset < 0x10) {
@@ -639,6 +639,7 @@ KeyManager::KeyManager() {
 }
 
 void KeyManager::ReloadKeys() {
+    std::scoped_lock lock{key_mutex};
     // Initialize keys
     const auto sudachi_keys_dir = Common::FS::GetSudachiPath(Common::FS::SudachiPath::KeysDir);
 
@@ -804,14 +805,17 @@ bool KeyManager::BaseDeriveNecessary() const {
 }
 
 bool KeyManager::HasKey(S128KeyType id, u64 field1, u64 field2) const {
+    std::scoped_lock lock{key_mutex};
     return s128_keys.find({id, field1, field2}) != s128_keys.end();
 }
 
 bool KeyManager::HasKey(S256KeyType id, u64 field1, u64 field2) const {
+    std::scoped_lock lock{key_mutex};
     return s256_keys.find({id, field1, field2}) != s256_keys.end();
 }
 
 Key128 KeyManager::GetKey(S128KeyType id, u64 field1, u64 field2) const {
+    std::scoped_lock lock{key_mutex};
     if (!HasKey(id, field1, field2)) {
         return {};
     }
@@ -819,6 +823,7 @@ Key128 KeyManager::GetKey(S128KeyType id, u64 field1, u64 field2) const {
 }
 
 Key256 KeyManager::GetKey(S256KeyType id, u64 field1, u64 field2) const {
+    std::scoped_lock lock{key_mutex};
     if (!HasKey(id, field1, field2)) {
         return {};
     }
@@ -826,6 +831,7 @@ Key256 KeyManager::GetKey(S256KeyType id, u64 field1, u64 field2) const {
 }
 
 Key256 KeyManager::GetBISKey(u8 partition_id) const {
+    std::scoped_lock lock{key_mutex};
     Key256 out{};
 
     for (const auto& bis_type : {BISKeyType::Crypto, BISKeyType::Tweak}) {
@@ -860,6 +866,7 @@ void KeyManager::WriteKeyToFile(KeyCategory category, std::string_view keyname,
 }
 
 void KeyManager::SetKey(S128KeyType id, Key128 key, u64 field1, u64 field2) {
+    std::scoped_lock lock{key_mutex};
     if (s128_keys.find({id, field1, field2}) != s128_keys.end() || key == Key128{}) {
         return;
     }
@@ -913,6 +920,7 @@ void KeyManager::SetKey(S128KeyType id, Key128 key, u64 field1, u64 field2) {
 }
 
 void KeyManager::SetKey(S256KeyType id, Key256 key, u64 field1, u64 field2) {
+    std::scoped_lock lock{key_mutex};
     if (s256_keys.find({id, field1, field2}) != s256_keys.end() || key == Key256{}) {
         return;
     }
@@ -1170,6 +1178,7 @@ void KeyManager::DeriveETicket(PartitionDataManager& data,
 }
 
 void KeyManager::PopulateTickets() {
+    std::scoped_lock lock{key_mutex};
     if (ticket_databases_loaded) {
         return;
     }
@@ -1201,6 +1210,7 @@ void KeyManager::PopulateTickets() {
 }
 
 void KeyManager::SynthesizeTickets() {
+    std::scoped_lock lock{key_mutex};
     for (const auto& key : s128_keys) {
         if (key.first.type != S128KeyType::Titlekey) {
             continue;
@@ -1320,15 +1330,18 @@ void KeyManager::PopulateFromPartitionData(PartitionDataManager& data) {
     DeriveBase();
 }
 
-const std::map<u128, Ticket>& KeyManager::GetCommonTickets() const {
+std::map<u128, Ticket> KeyManager::GetCommonTickets() const {
+    std::scoped_lock lock{key_mutex};
     return common_tickets;
 }
 
-const std::map<u128, Ticket>& KeyManager::GetPersonalizedTickets() const {
+std::map<u128, Ticket> KeyManager::GetPersonalizedTickets() const {
+    std::scoped_lock lock{key_mutex};
     return personal_tickets;
 }
 
 bool KeyManager::AddTicket(const Ticket& ticket) {
+    std::scoped_lock lock{key_mutex};
     if (!ticket.IsValid()) {
         LOG_WARNING(Crypto, "Attempted to add invalid ticket.");
         return false;
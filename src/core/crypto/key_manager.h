@@ -6,6 +6,7 @@
 #include <array>
 #include <filesystem>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <string>
@@ -287,8 +288,9 @@ public:
 
     void PopulateFromPartitionData(PartitionDataManager& data);
 
-    const std::map<u128, Ticket>& GetCommonTickets() const;
-    const std::map<u128, Ticket>& GetPersonalizedTickets() const;
+    // Copies of the ticket maps, as tickets may be added by other threads
+    std::map<u128, Ticket> GetCommonTickets() const;
+    std::map<u128, Ticket> GetPersonalizedTickets() const;
 
     bool AddTicket(const Ticket& ticket);
 
@@ -298,6 +300,10 @@ public:
 private:
     KeyManager();
 
+    // Games are loaded from several threads while scanning game directories, and loading a
+    // package can add tickets and title keys. Recursive since setting a key reloads the key file.
+    mutable std::recursive_mutex key_mutex;
+
     std::map<KeyIndex<S128KeyType>, Key128> s128_keys;
     std::map<KeyIndex<S256KeyType>, Key256> s256_keys;
 
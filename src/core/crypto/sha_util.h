@@ -3,17 +3,37 @@
 
 #pragma once
 
-#include "common/assert.h"
-#include "core/file_sys/vfs.h"
-#include "key_manager.h"
-#include "mbedtls/cipher.h"
+#include <array>
+#include <span>
+#include "common/common_types.h"
 
-namespace Crypto {
-typedef std::array<u8, 0x20> SHA256Hash;
+namespace Core::Crypto {
 
-inline SHA256Hash operator"" _HASH(const char* data, size_t len) {
-    if (len != 0x40)
-        return {};
-}
+using SHA256Hash = std::array<u8, 0x20>;
 
-} // namespace Crypto
+/**
+ * Incremental SHA-256. Blocks are compressed with the SHA extensions on x86-64 or the ARMv8
+ * SHA2 instructions when the host has them, and with portable code otherwise.
+ */
+class SHA256 {
+public:
+    static constexpr std::size_t BlockSize = 0x40;
+
+    SHA256();
+
+    void Update(std::span<const u8> data);
+
+    /// Returns the digest of all data passed to Update. The object must not be reused afterwards.
+    SHA256Hash Finish();
+
+    /// Hashes data in one call.
+    static SHA256Hash Hash(std::span<const u8> data);
+
+private:
+    std::array<u32, 8> state;
+    std::array<u8, BlockSize> buffer{};
+    std::size_t buffered_size = 0;
+    u64 total_size = 0;
+};
+
+} // namespace Core::Crypto
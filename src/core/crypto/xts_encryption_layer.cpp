@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 #include "core/crypto/xts_encryption_layer.h"
 
 namespace Core::Crypto {
@@ -20,6 +21,7 @@ std::size_t XTSEncryptionLayer::Read(u8* data, std::size_t length, std::size_t o
     if (sector_offset == 0) {
         if (length % XTS_SECTOR_SIZE == 0) {
             std::vector<u8> raw = base->ReadBytes(length, offset);
+            std::scoped_lock lk{cipher_mutex};
             cipher.XTSTranscode(raw.data(), raw.size(), data, offset / XTS_SECTOR_SIZE,
                                 XTS_SECTOR_SIZE, Op::Decrypt);
             return raw.size();
@@ -32,8 +34,11 @@ std::size_t XTSEncryptionLayer::Read(u8* data, std::size_t length, std::size_t o
         std::vector<u8> buffer = base->ReadBytes(XTS_SECTOR_SIZE, offset);
         if (buffer.size() < XTS_SECTOR_SIZE)
             buffer.resize(XTS_SECTOR_SIZE);
-        cipher.XTSTranscode(buffer.data(), buffer.size(), buffer.data(), offset / XTS_SECTOR_SIZE,
-                            XTS_SECTOR_SIZE, Op::Decrypt);
+        {
+            std::scoped_lock lk{cipher_mutex};
+            cipher.XTSTranscode(buffer.data(), buffer.size(), buffer.data(),
+                                offset / XTS_SECTOR_SIZE, XTS_SECTOR_SIZE, Op::Decrypt);
+        }
         std::memcpy(data, buffer.data(), std::min(buffer.size(), length));
         return std::min(buffer.size(), length);
     }
@@ -42,8 +47,12 @@ std::size_t XTSEncryptionLayer::Read(u8* data, std::size_t length, std::size_t o
     std::vector<u8> block = base->ReadBytes(0x4000, offset - sector_offset);
     if (block.size() < XTS_SECTOR_SIZE)
         block.resize(XTS_SECTOR_SIZE);
-    cipher.XTSTranscode(block.data(), block.size(), block.data(),
-                        (offset - sector_offset) / XTS_SECTOR_SIZE, XTS_SECTOR_SIZE, Op::Decrypt);
+    {
+        std::scoped_lock lk{cipher_mutex};
+        cipher.XTSTranscode(block.data(), block.size(), block.data(),
+                            (offset - sector_offset) / XTS_SECTOR_SIZE, XTS_SECTOR_SIZE,
+                            Op::Decrypt);
+    }
     const std::size_t read = XTS_SECTOR_SIZE - sector_offset;
 
     if (length + sector_offset < XTS_SECTOR_SIZE) {
@@ -17,9 +17,13 @@ BISFactory::BISFactory(VirtualDir nand_root_, VirtualDir load_root_, VirtualDir
     : nand_root(std::move(nand_root_)), load_root(std::move(load_root_)),
       dump_root(std::move(dump_root_)),
       sysnand_cache(std::make_unique<RegisteredCache>(
-          GetOrCreateDirectoryRelative(nand_root, "/system/Contents/registered"))),
+          GetOrCreateDirectoryRelative(nand_root, "/system/Contents/registered"),
+          Common::FS::GetSudachiPath(Common::FS::SudachiPath::CacheDir) / "registered_cache" /
+              "system_nand.bin")),
       usrnand_cache(std::make_unique<RegisteredCache>(
-          GetOrCreateDirectoryRelative(nand_root, "/user/Contents/registered"))),
+          GetOrCreateDirectoryRelative(nand_root, "/user/Contents/registered"),
+          Common::FS::GetSudachiPath(Common::FS::SudachiPath::CacheDir) / "registered_cache" /
+              "user_nand.bin")),
       sysnand_placeholder(std::make_unique<PlaceholderCache>(
           GetOrCreateDirectoryRelative(nand_root, "/system/Contents/placehld"))),
       usrnand_placeholder(std::make_unique<PlaceholderCache>(
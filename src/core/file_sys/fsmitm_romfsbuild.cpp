@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <cstring>
+#include <functional>
+#include <mutex>
 #include <span>
 #include <string_view>
 #include "common/alignment.h"
@@ -60,7 +62,7 @@ struct RomFSBuildDirectoryContext {
     u32 cur_path_ofs = 0;
     u32 path_len = 0;
     u32 entry_offset = 0;
-    std::shared_ptr<RomFSBuildDirectoryContext> parent;
+    RomFSBuildDirectoryContext* parent = nullptr;
     std::shared_ptr<RomFSBuildDirectoryContext> child;
     std::shared_ptr<RomFSBuildDirectoryContext> sibling;
     std::shared_ptr<RomFSBuildFileContext> file;
@@ -73,7 +75,7 @@ struct RomFSBuildFileContext {
     u32 entry_offset = 0;
     u64 offset = 0;
     u64 size = 0;
-    std::shared_ptr<RomFSBuildDirectoryContext> parent;
+    RomFSBuildDirectoryContext* parent = nullptr;
     std::shared_ptr<RomFSBuildFileContext> sibling;
     VirtualFile source;
 };
@@ -106,6 +108,141 @@ static u64 romfs_get_hash_table_count(u64 num_entries) {
     return count;
 }
 
+namespace {
+
+// A read-only file of known size whose contents are only produced once they are first read.
+class LazyVfsFile : public VfsFile {
+public:
+    LazyVfsFile(std::string name_, std::size_t size_, std::function<VirtualFile()> open_)
+        : name{std::move(name_)}, size{size_}, open{std::move(open_)} {}
+
+    std::string GetName() const override {
+        return name;
+    }
+    std::size_t GetSize() const override {
+        return size;
+    }
+    bool Resize(std::size_t new_size) override {
+        return false;
+    }
+    VirtualDir GetContainingDirectory() const override {
+        return nullptr;
+    }
+    bool IsWritable() const override {
+        return false;
+    }
+    bool IsReadable() const override {
+        return true;
+    }
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        std::call_once(open_flag, [this] {
+            file = open();
+            open = nullptr;
+        });
+        if (offset >= size) {
+            return 0;
+        }
+        return file->Read(data, std::min(length, size - offset), offset);
+    }
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override {
+        return 0;
+    }
+    bool Rename(std::string_view new_name) override {
+        return false;
+    }
+
+private:
+    std::string name;
+    std::size_t size;
+    mutable std::once_flag open_flag;
+    mutable std::function<VirtualFile()> open;
+    mutable VirtualFile file;
+};
+
+} // Anonymous namespace
+
+static std::vector<u8> BuildMetadata(
+    const std::shared_ptr<RomFSBuildDirectoryContext>& root,
+    std::span<const std::shared_ptr<RomFSBuildDirectoryContext>> directories,
+    std::span<const std::shared_ptr<RomFSBuildFileContext>> files, u64 dir_hash_table_entry_count,
+    u64 file_hash_table_entry_count, u64 dir_table_size, u64 file_table_size) {
+    const u64 dir_hash_table_size = 4 * dir_hash_table_entry_count;
+    const u64 file_hash_table_size = 4 * file_hash_table_entry_count;
+
+    // Assign metadata pointers.
+    std::vector<u8> metadata(file_hash_table_size + file_table_size + dir_hash_table_size +
+                             dir_table_size);
+    u32* const dir_hash_table_pointer = reinterpret_cast<u32*>(metadata.data());
+    u8* const dir_table_pointer = metadata.data() + dir_hash_table_size;
+    u32* const file_hash_table_pointer =
+        reinterpret_cast<u32*>(metadata.data() + dir_hash_table_size + dir_table_size);
+    u8* const file_table_pointer =
+        metadata.data() + dir_hash_table_size + dir_table_size + file_hash_table_size;
+
+    std::span<u32> dir_hash_table(dir_hash_table_pointer, dir_hash_table_entry_count);
+    std::span<u32> file_hash_table(file_hash_table_pointer, file_hash_table_entry_count);
+    std::span<u8> dir_table(dir_table_pointer, dir_table_size);
+    std::span<u8> file_table(file_table_pointer, file_table_size);
+
+    // Initialize hash tables.
+    std::memset(dir_hash_table.data(), 0xFF, dir_hash_table.size_bytes());
+    std::memset(file_hash_table.data(), 0xFF, file_hash_table.size_bytes());
+
+    // Populate file tables.
+    for (const auto& cur_file : files) {
+        RomFSFileEntry cur_entry{};
+
+        cur_entry.parent = cur_file->parent->entry_offset;
+        cur_entry.sibling =
+            cur_file->sibling == nullptr ? ROMFS_ENTRY_EMPTY : cur_file->sibling->entry_offset;
+        cur_entry.offset = cur_file->offset;
+        cur_entry.size = cur_file->size;
+
+        const auto name_size = cur_file->path_len - cur_file->cur_path_ofs;
+        const auto hash = romfs_calc_path_hash(cur_file->parent->entry_offset, cur_file->path,
+                                               cur_file->cur_path_ofs, name_size);
+        cur_entry.hash = file_hash_table[hash % file_hash_table_entry_count];
+        file_hash_table[hash % file_hash_table_entry_count] = cur_file->entry_offset;
+
+        cur_entry.name_size = name_size;
+
+        std::memcpy(file_table.data() + cur_file->entry_offset, &cur_entry, sizeof(RomFSFileEntry));
+        std::memset(file_table.data() + cur_file->entry_offset + sizeof(RomFSFileEntry), 0,
+                    Common::AlignUp(cur_entry.name_size, 4));
+        std::memcpy(file_table.data() + cur_file->entry_offset + sizeof(RomFSFileEntry),
+                    cur_file->path.data() + cur_file->cur_path_ofs, name_size);
+    }
+
+    // Populate dir tables.
+    for (const auto& cur_dir : directories) {
+        RomFSDirectoryEntry cur_entry{};
+
+        cur_entry.parent = cur_dir == root ? 0 : cur_dir->parent->entry_offset;
+        cur_entry.sibling =
+            cur_dir->sibling == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->sibling->entry_offset;
+        cur_entry.child =
+            cur_dir->child == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->child->entry_offset;
+        cur_entry.file = cur_dir->file == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->file->entry_offset;
+
+        const auto name_size = cur_dir->path_len - cur_dir->cur_path_ofs;
+        const auto hash = romfs_calc_path_hash(cur_dir == root ? 0 : cur_dir->parent->entry_offset,
+                                               cur_dir->path, cur_dir->cur_path_ofs, name_size);
+        cur_entry.hash = dir_hash_table[hash % dir_hash_table_entry_count];
+        dir_hash_table[hash % dir_hash_table_entry_count] = cur_dir->entry_offset;
+
+        cur_entry.name_size = name_size;
+
+        std::memcpy(dir_table.data() + cur_dir->entry_offset, &cur_entry,
+                    sizeof(RomFSDirectoryEntry));
+        std::memset(dir_table.data() + cur_dir->entry_offset + sizeof(RomFSDirectoryEntry), 0,
+                    Common::AlignUp(cur_entry.name_size, 4));
+        std::memcpy(dir_table.data() + cur_dir->entry_offset + sizeof(RomFSDirectoryEntry),
+                    cur_dir->path.data() + cur_dir->cur_path_ofs, name_size);
+    }
+
+    return metadata;
+}
+
 void RomFSBuildContext::VisitDirectory(VirtualDir romfs_dir, VirtualDir ext_dir,
                                        std::shared_ptr<RomFSBuildDirectoryContext> parent) {
     for (auto& child_romfs_file : romfs_dir->GetFiles()) {
@@ -125,16 +262,20 @@ void RomFSBuildContext::VisitDirectory(VirtualDir romfs_dir, VirtualDir ext_dir,
 
         child->source = std::move(child_romfs_file);
 
+        child->size = child->source->GetSize();
+
         if (ext_dir != nullptr) {
-            if (const auto ips = ext_dir->GetFile(name + ".ips")) {
-                if (auto patched = PatchIPS(child->source, ips)) {
-                    child->source = std::move(patched);
-                }
+            if (auto ips = ext_dir->GetFile(name + ".ips")) {
+                // Patches never change the size of a file, so they are applied on first access
+                auto source = std::move(child->source);
+                child->source = std::make_shared<LazyVfsFile>(
+                    name, child->size, [source, ips = std::move(ips)]() -> VirtualFile {
+                        auto patched = PatchIPS(source, ips);
+                        return patched != nullptr ? patched : source;
+                    });
             }
         }
 
-        child->size = child->source->GetSize();
-
         AddFile(parent, std::move(child));
     }
 
@@ -168,7 +309,7 @@ bool RomFSBuildContext::AddDirectory(std::shared_ptr<RomFSBuildDirectoryContext>
     num_dirs++;
     dir_table_size +=
         sizeof(RomFSDirectoryEntry) + Common::AlignUp(dir_ctx->path_len - dir_ctx->cur_path_ofs, 4);
-    dir_ctx->parent = std::move(parent_dir_ctx);
+    dir_ctx->parent = parent_dir_ctx.get();
     directories.emplace_back(std::move(dir_ctx));
 
     return true;
@@ -180,7 +321,7 @@ bool RomFSBuildContext::AddFile(std::shared_ptr<RomFSBuildDirectoryContext> pare
     num_files++;
     file_table_size +=
         sizeof(RomFSFileEntry) + Common::AlignUp(file_ctx->path_len - file_ctx->cur_path_ofs, 4);
-    file_ctx->parent = std::move(parent_dir_ctx);
+    file_ctx->parent = parent_dir_ctx.get();
     files.emplace_back(std::move(file_ctx));
 
     return true;
@@ -205,27 +346,8 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
     dir_hash_table_size = 4 * dir_hash_table_entry_count;
     file_hash_table_size = 4 * file_hash_table_entry_count;
 
-    // Assign metadata pointers.
     RomFSHeader header{};
 
-    std::vector<u8> metadata(file_hash_table_size + file_table_size + dir_hash_table_size +
-                             dir_table_size);
-    u32* const dir_hash_table_pointer = reinterpret_cast<u32*>(metadata.data());
-    u8* const dir_table_pointer = metadata.data() + dir_hash_table_size;
-    u32* const file_hash_table_pointer =
-        reinterpret_cast<u32*>(metadata.data() + dir_hash_table_size + dir_table_size);
-    u8* const file_table_pointer =
-        metadata.data() + dir_hash_table_size + dir_table_size + file_hash_table_size;
-
-    std::span<u32> dir_hash_table(dir_hash_table_pointer, dir_hash_table_entry_count);
-    std::span<u32> file_hash_table(file_hash_table_pointer, file_hash_table_entry_count);
-    std::span<u8> dir_table(dir_table_pointer, dir_table_size);
-    std::span<u8> file_table(file_table_pointer, file_table_size);
-
-    // Initialize hash tables.
-    std::memset(dir_hash_table.data(), 0xFF, dir_hash_table.size_bytes());
-    std::memset(file_hash_table.data(), 0xFF, file_hash_table.size_bytes());
-
     // Sort tables by name.
     std::sort(files.begin(), files.end(),
               [](const auto& a, const auto& b) { return a->path < b->path; });
@@ -234,7 +356,6 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
 
     // Determine file offsets.
     u32 entry_offset = 0;
-    std::shared_ptr<RomFSBuildFileContext> prev_file = nullptr;
     for (const auto& cur_file : files) {
         file_partition_size = Common::AlignUp(file_partition_size, 16);
         cur_file->offset = file_partition_size;
@@ -243,7 +364,6 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
         entry_offset +=
             static_cast<u32>(sizeof(RomFSFileEntry) +
                              Common::AlignUp(cur_file->path_len - cur_file->cur_path_ofs, 4));
-        prev_file = cur_file;
     }
     // Assign deferred parent/sibling ownership.
     for (auto it = files.rbegin(); it != files.rend(); ++it) {
@@ -287,62 +407,26 @@ std::vector<std::pair<u64, VirtualFile>> RomFSBuildContext::Build() {
     std::memcpy(header_data.data(), &header, header_data.size());
     out.emplace_back(0, std::make_shared<VectorVfsFile>(std::move(header_data)));
 
-    // Populate file tables.
+    // File data is read straight from the source files.
     for (const auto& cur_file : files) {
-        RomFSFileEntry cur_entry{};
-
-        cur_entry.parent = cur_file->parent->entry_offset;
-        cur_entry.sibling =
-            cur_file->sibling == nullptr ? ROMFS_ENTRY_EMPTY : cur_file->sibling->entry_offset;
-        cur_entry.offset = cur_file->offset;
-        cur_entry.size = cur_file->size;
-
-        const auto name_size = cur_file->path_len - cur_file->cur_path_ofs;
-        const auto hash = romfs_calc_path_hash(cur_file->parent->entry_offset, cur_file->path,
-                                               cur_file->cur_path_ofs, name_size);
-        cur_entry.hash = file_hash_table[hash % file_hash_table_entry_count];
-        file_hash_table[hash % file_hash_table_entry_count] = cur_file->entry_offset;
-
-        cur_entry.name_size = name_size;
-
         out.emplace_back(cur_file->offset + ROMFS_FILEPARTITION_OFS, std::move(cur_file->source));
-        std::memcpy(file_table.data() + cur_file->entry_offset, &cur_entry, sizeof(RomFSFileEntry));
-        std::memset(file_table.data() + cur_file->entry_offset + sizeof(RomFSFileEntry), 0,
-                    Common::AlignUp(cur_entry.name_size, 4));
-        std::memcpy(file_table.data() + cur_file->entry_offset + sizeof(RomFSFileEntry),
-                    cur_file->path.data() + cur_file->cur_path_ofs, name_size);
-    }
-
-    // Populate dir tables.
-    for (const auto& cur_dir : directories) {
-        RomFSDirectoryEntry cur_entry{};
-
-        cur_entry.parent = cur_dir == root ? 0 : cur_dir->parent->entry_offset;
-        cur_entry.sibling =
-            cur_dir->sibling == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->sibling->entry_offset;
-        cur_entry.child =
-            cur_dir->child == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->child->entry_offset;
-        cur_entry.file = cur_dir->file == nullptr ? ROMFS_ENTRY_EMPTY : cur_dir->file->entry_offset;
-
-        const auto name_size = cur_dir->path_len - cur_dir->cur_path_ofs;
-        const auto hash = romfs_calc_path_hash(cur_dir == root ? 0 : cur_dir->parent->entry_offset,
-                                               cur_dir->path, cur_dir->cur_path_ofs, name_size);
-        cur_entry.hash = dir_hash_table[hash % dir_hash_table_entry_count];
-        dir_hash_table[hash % dir_hash_table_entry_count] = cur_dir->entry_offset;
-
-        cur_entry.name_size = name_size;
-
-        std::memcpy(dir_table.data() + cur_dir->entry_offset, &cur_entry,
-                    sizeof(RomFSDirectoryEntry));
-        std::memset(dir_table.data() + cur_dir->entry_offset + sizeof(RomFSDirectoryEntry), 0,
-                    Common::AlignUp(cur_entry.name_size, 4));
-        std::memcpy(dir_table.data() + cur_dir->entry_offset + sizeof(RomFSDirectoryEntry),
-                    cur_dir->path.data() + cur_dir->cur_path_ofs, name_size);
     }
 
-    // Write metadata.
-    out.emplace_back(header.dir_hash_table_ofs,
-                     std::make_shared<VectorVfsFile>(std::move(metadata)));
+    // The metadata tables are only generated once they are first read, the build contexts are
+    // released afterwards.
+    const u64 metadata_size =
+        file_hash_table_size + file_table_size + dir_hash_table_size + dir_table_size;
+    out.emplace_back(
+        header.dir_hash_table_ofs,
+        std::make_shared<LazyVfsFile>(
+            "", metadata_size,
+            [root = root, directories = std::move(directories), files = std::move(files),
+             dir_hash_table_entry_count, file_hash_table_entry_count,
+             dir_table_size = dir_table_size, file_table_size = file_table_size]() {
+                return std::make_shared<VectorVfsFile>(
+                    BuildMetadata(root, directories, files, dir_hash_table_entry_count,
+                                  file_hash_table_entry_count, dir_table_size, file_table_size));
+            }));
 
     // Sort the output.
     std::sort(out.begin(), out.end(),
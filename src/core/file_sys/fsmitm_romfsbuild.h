@@ -21,7 +21,8 @@ public:
     explicit RomFSBuildContext(VirtualDir base, VirtualDir ext = nullptr);
     ~RomFSBuildContext();
 
-    // This finalizes the context.
+    // This finalizes the context. File data is read straight from the source files and the
+    // metadata tables are only generated when they are first read.
     std::vector<std::pair<u64, VirtualFile>> Build();
 
 private:
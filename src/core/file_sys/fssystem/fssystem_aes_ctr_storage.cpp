@@ -57,6 +57,7 @@ size_t AesCtrStorage::Read(u8* buffer, size_t size, size_t offset) const {
     AddCounter(ctr.data(), IvSize, offset / BlockSize);
 
     // Decrypt.
+    std::scoped_lock lk{m_mutex};
     m_cipher->SetIV(ctr);
     m_cipher->Transcode(buffer, size, buffer, Core::Crypto::Op::Decrypt);
 
@@ -104,9 +105,12 @@ size_t AesCtrStorage::Write(const u8* buffer, size_t size, size_t offset) {
         }
 
         // Encrypt the data.
-        m_cipher->SetIV(ctr);
-        m_cipher->Transcode(buffer, write_size, reinterpret_cast<u8*>(write_buf),
-                            Core::Crypto::Op::Encrypt);
+        {
+            std::scoped_lock lk{m_mutex};
+            m_cipher->SetIV(ctr);
+            m_cipher->Transcode(buffer, write_size, reinterpret_cast<u8*>(write_buf),
+                                Core::Crypto::Op::Encrypt);
+        }
 
         // Write the encrypted data.
         m_base_storage->Write(reinterpret_cast<u8*>(write_buf), write_size, offset + cur_offset);
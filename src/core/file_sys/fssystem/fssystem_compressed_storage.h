@@ -3,6 +3,10 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "common/literals.h"
 
 #include "core/file_sys/errors.h"
@@ -16,6 +20,69 @@ namespace FileSys {
 
 using namespace Common::Literals;
 
+/// Least recently used cache of decompressed data, keyed by virtual offset.
+class CompressedBlockCache {
+public:
+    void Initialize(size_t entry_size, size_t max_entries) {
+        m_entry_size = entry_size;
+        m_entries.clear();
+        m_entries.resize(entry_size != 0 ? max_entries : 0);
+    }
+
+    size_t GetEntrySize() const {
+        return m_entry_size;
+    }
+
+    bool Read(s64 virtual_offset, size_t skip_size, char* dst, size_t size) {
+        for (auto& entry : m_entries) {
+            if (entry.virtual_offset == virtual_offset && skip_size + size <= entry.size) {
+                entry.last_use = ++m_use_counter;
+                std::memcpy(dst, entry.buffer.get() + skip_size, size);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Store(s64 virtual_offset, const char* src, size_t size) {
+        if (m_entries.empty()) {
+            return;
+        }
+        ASSERT(size <= m_entry_size);
+
+        // Reuse the entry of the same data if any, otherwise evict the oldest one.
+        CacheEntry* target = std::addressof(m_entries.front());
+        for (auto& entry : m_entries) {
+            if (entry.virtual_offset == virtual_offset) {
+                target = std::addressof(entry);
+                break;
+            }
+            if (entry.last_use < target->last_use) {
+                target = std::addressof(entry);
+            }
+        }
+        if (!target->buffer) {
+            target->buffer = std::make_unique<char[]>(m_entry_size);
+        }
+        std::memcpy(target->buffer.get(), src, size);
+        target->virtual_offset = virtual_offset;
+        target->size = size;
+        target->last_use = ++m_use_counter;
+    }
+
+private:
+    struct CacheEntry {
+        s64 virtual_offset = -1;
+        size_t size = 0;
+        u64 last_use = 0;
+        std::unique_ptr<char[]> buffer;
+    };
+
+    std::vector<CacheEntry> m_entries;
+    size_t m_entry_size = 0;
+    u64 m_use_counter = 0;
+};
+
 class CompressedStorage : public IReadOnlyStorage {
     SUDACHI_NON_COPYABLE(CompressedStorage);
     SUDACHI_NON_MOVEABLE(CompressedStorage);
@@ -694,11 +761,21 @@ private:
         CacheManager() = default;
 
     public:
+        /**
+         * Blocks that decompress to at most cache_size_0 bytes are cached whole, larger blocks
+         * are cached as fragments of cache_size_1 bytes. Each cache holds up to max_cache_entries
+         * entries.
+         */
         Result Initialize(s64 storage_size, size_t cache_size_0, size_t cache_size_1,
                           size_t max_cache_entries) {
             // Set our fields.
             m_storage_size = storage_size;
 
+            // Initialize our caches.
+            std::scoped_lock lk{m_mutex};
+            m_block_cache.Initialize(cache_size_0, max_cache_entries);
+            m_fragment_cache.Initialize(cache_size_1, max_cache_entries);
+
             R_SUCCEED();
         }
 
@@ -782,10 +859,10 @@ private:
             char* cur_dst = static_cast<char*>(buffer);
 
             // Determine our alignment.
-            const bool head_unaligned = head_range.is_block_alignment_required &&
-                                        (cur_offset != head_range.virtual_offset ||
-                                         static_cast<s64>(cur_size) < head_range.virtual_size);
-            const bool tail_unaligned = [&]() -> bool {
+            bool head_unaligned = head_range.is_block_alignment_required &&
+                                  (cur_offset != head_range.virtual_offset ||
+                                   static_cast<s64>(cur_size) < head_range.virtual_size);
+            bool tail_unaligned = [&]() -> bool {
                 if (tail_range.is_block_alignment_required) {
                     if (static_cast<s64>(cur_size + cur_offset) ==
                         tail_range.GetEndVirtualOffset()) {
@@ -801,10 +878,38 @@ private:
                 }
             }();
 
+            // Serve the unaligned head and tail from the cache if we can, so that their blocks
+            // are neither read nor decompressed again.
+            bool is_head_cached = false;
+            if (head_unaligned) {
+                const size_t copy_size = std::min<size_t>(
+                    cur_size, head_range.GetEndVirtualOffset() - cur_offset);
+                if (this->ReadFromCache(head_range, cur_offset, cur_dst, copy_size)) {
+                    cur_dst += copy_size;
+                    cur_offset += copy_size;
+                    cur_size -= copy_size;
+                    head_unaligned = false;
+                    is_head_cached = true;
+                }
+            }
+            bool is_tail_cached = false;
+            if (tail_unaligned) {
+                const size_t copy_size =
+                    static_cast<size_t>(cur_offset + cur_size - tail_range.virtual_offset);
+                if (this->ReadFromCache(tail_range, tail_range.virtual_offset,
+                                        cur_dst + cur_size - copy_size, copy_size)) {
+                    cur_size -= copy_size;
+                    tail_unaligned = false;
+                    is_tail_cached = true;
+                }
+            }
+            R_SUCCEED_IF(cur_size == 0);
+
             // Determine start/end offsets.
-            const s64 start_offset =
-                head_range.is_block_alignment_required ? head_range.virtual_offset : cur_offset;
-            const s64 end_offset = tail_range.is_block_alignment_required
+            const s64 start_offset = head_range.is_block_alignment_required && !is_head_cached
+                                         ? head_range.virtual_offset
+                                         : cur_offset;
+            const s64 end_offset = tail_range.is_block_alignment_required && !is_tail_cached
                                        ? tail_range.GetEndVirtualOffset()
                                        : cur_offset + cur_size;
 
@@ -872,6 +977,9 @@ private:
                             R_THROW(rc);
                         }
 
+                        // Keep the decompressed block around for the next unaligned access.
+                        this->StoreToCache(*unaligned_range, pooled_buffer.GetBuffer());
+
                         // Copy the data we read to the destination.
                         const size_t skip_size = cur_offset - unaligned_range->virtual_offset;
                         const size_t copy_size = std::min<size_t>(
@@ -891,8 +999,57 @@ private:
             R_SUCCEED();
         }
 
+    private:
+        bool ReadFromCache(const AccessRange& range, s64 offset, char* dst, size_t size) {
+            std::scoped_lock lk{m_mutex};
+            size_t skip_size = static_cast<size_t>(offset - range.virtual_offset);
+            if (static_cast<size_t>(range.virtual_size) <= m_block_cache.GetEntrySize()) {
+                return m_block_cache.Read(range.virtual_offset, skip_size, dst, size);
+            }
+
+            // Every fragment overlapping the access must be cached.
+            const size_t fragment_size = m_fragment_cache.GetEntrySize();
+            if (fragment_size == 0) {
+                return false;
+            }
+            while (size > 0) {
+                const size_t fragment_skip = skip_size % fragment_size;
+                const size_t copy_size = std::min(size, fragment_size - fragment_skip);
+                const s64 fragment_offset =
+                    range.virtual_offset + static_cast<s64>(skip_size - fragment_skip);
+                if (!m_fragment_cache.Read(fragment_offset, fragment_skip, dst, copy_size)) {
+                    return false;
+                }
+                dst += copy_size;
+                skip_size += copy_size;
+                size -= copy_size;
+            }
+            return true;
+        }
+
+        void StoreToCache(const AccessRange& range, const char* data) {
+            std::scoped_lock lk{m_mutex};
+            const size_t block_size = static_cast<size_t>(range.virtual_size);
+            if (block_size <= m_block_cache.GetEntrySize()) {
+                m_block_cache.Store(range.virtual_offset, data, block_size);
+                return;
+            }
+
+            const size_t fragment_size = m_fragment_cache.GetEntrySize();
+            if (fragment_size == 0) {
+                return;
+            }
+            for (size_t offset = 0; offset < block_size; offset += fragment_size) {
+                m_fragment_cache.Store(range.virtual_offset + static_cast<s64>(offset),
+                                       data + offset, std::min(fragment_size, block_size - offset));
+            }
+        }
+
     private:
         s64 m_storage_size = 0;
+        std::mutex m_mutex;
+        CompressedBlockCache m_block_cache;
+        CompressedBlockCache m_fragment_cache;
     };
 
 public:
@@ -2,10 +2,14 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <cstring>
 #include <random>
 #include <regex>
 #include <mbedtls/sha256.h>
 #include "common/assert.h"
+#include "common/common_funcs.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
 #include "common/fs/path_util.h"
 #include "common/hex_util.h"
 #include "common/logging/log.h"
@@ -18,6 +22,7 @@
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/submission_package.h"
 #include "core/file_sys/vfs/vfs_concat.h"
+#include "core/file_sys/vfs/vfs_vector.h"
 #include "core/loader/loader.h"
 
 namespace FileSys {
@@ -25,6 +30,9 @@ namespace FileSys {
 // The size of blocks to use when vfs raw copying into nand.
 constexpr size_t VFS_RC_LARGE_COPY_BLOCK = 0x400000;
 
+constexpr u32 NCA_INDEX_MAGIC = Common::MakeMagic('R', 'C', 'I', 'X');
+constexpr u32 NCA_INDEX_VERSION = 1;
+
 std::string ContentProviderEntry::DebugInfo() const {
     return fmt::format("title_id={:016X}, content_type={:02X}", title_id, static_cast<u8>(type));
 }
@@ -412,28 +420,172 @@ std::vector<NcaID> RegisteredCache::AccumulateFiles() const {
     return ids;
 }
 
+std::optional<RegisteredCache::IndexedNca> RegisteredCache::ParseNca(const VirtualFile& file,
+                                                                      const NcaID& id) const {
+    const auto nca = std::make_shared<NCA>(parser(file, id));
+    if (nca->GetStatus() != Loader::ResultStatus::Success) {
+        // Not indexed, so that it is parsed again once e.g. missing keys are provided
+        return std::nullopt;
+    }
+
+    IndexedNca indexed{
+        .size = file->GetSize(),
+        .title_id = nca->GetTitleId(),
+        .cnmt = {},
+    };
+    if (nca->GetType() != NCAContentType::Meta || nca->GetSubdirectories().empty()) {
+        return indexed;
+    }
+
+    const auto section0 = nca->GetSubdirectories()[0];
+    for (const auto& section0_file : section0->GetFiles()) {
+        if (section0_file->GetExtension() == "cnmt") {
+            indexed.cnmt = section0_file->ReadAllBytes();
+            break;
+        }
+    }
+    return indexed;
+}
+
 void RegisteredCache::ProcessFiles(const std::vector<NcaID>& ids) {
+    std::map<NcaID, IndexedNca> new_index;
+    bool index_changed = false;
+
+    meta.clear();
+    meta_id.clear();
     for (const auto& id : ids) {
         const auto file = GetFileAtID(id);
 
         if (file == nullptr)
             continue;
-        const auto nca = std::make_shared<NCA>(parser(file, id));
-        if (nca->GetStatus() != Loader::ResultStatus::Success ||
-            nca->GetType() != NCAContentType::Meta || nca->GetSubdirectories().empty()) {
-            continue;
+
+        // NcaIDs are derived from the hash of the content, so an NCA that is still the same size
+        // does not have to be parsed again.
+        auto it = new_index.find(id);
+        if (it == new_index.end()) {
+            auto node = nca_index.extract(id);
+            if (!node.empty() && node.mapped().size == file->GetSize()) {
+                it = new_index.insert(std::move(node)).position;
+            } else {
+                // A resized NCA loses its old entry even if it no longer parses
+                index_changed |= !node.empty();
+                auto parsed = ParseNca(file, id);
+                if (!parsed) {
+                    continue;
+                }
+                it = new_index.emplace(id, std::move(*parsed)).first;
+                index_changed = true;
+            }
+        }
+
+        const IndexedNca& nca = it->second;
+        if (!nca.cnmt.empty()) {
+            meta.insert_or_assign(nca.title_id, CNMT(std::make_shared<VectorVfsFile>(nca.cnmt)));
+            meta_id.insert_or_assign(nca.title_id, id);
         }
+    }
 
-        const auto section0 = nca->GetSubdirectories()[0];
+    // Whatever is left in the old index has been removed from the directory
+    index_changed |= !nca_index.empty();
+    nca_index = std::move(new_index);
 
-        for (const auto& section0_file : section0->GetFiles()) {
-            if (section0_file->GetExtension() != "cnmt")
-                continue;
+    if (index_changed) {
+        SaveIndex();
+    }
+}
 
-            meta.insert_or_assign(nca->GetTitleId(), CNMT(section0_file));
-            meta_id.insert_or_assign(nca->GetTitleId(), id);
-            break;
+void RegisteredCache::LoadIndex() {
+    if (index_path.empty() || !Common::FS::Exists(index_path)) {
+        return;
+    }
+
+    Common::FS::IOFile file{index_path, Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    std::vector<u8> data(file.IsOpen() ? file.GetSize() : 0);
+    if (file.ReadSpan<u8>(data) != data.size()) {
+        return;
+    }
+
+    std::size_t offset = 0;
+    const auto read = [&data, &offset](void* out, std::size_t size) {
+        if (data.size() - offset < size) {
+            return false;
         }
+        std::memcpy(out, data.data() + offset, size);
+        offset += size;
+        return true;
+    };
+
+    u32 magic{};
+    u32 version{};
+    u64 path_size{};
+    if (!read(&magic, sizeof(magic)) || !read(&version, sizeof(version)) ||
+        magic != NCA_INDEX_MAGIC || version != NCA_INDEX_VERSION ||
+        !read(&path_size, sizeof(path_size))) {
+        LOG_WARNING(Loader, "Ignoring NCA index with unknown format: {}",
+                    Common::FS::PathToUTF8String(index_path));
+        return;
+    }
+
+    // The index belongs to another directory if e.g. the NAND directory was moved
+    std::string path(std::min<u64>(path_size, data.size() - offset), '\0');
+    u64 num_entries{};
+    if (!read(path.data(), path.size()) || path != dir->GetFullPath() ||
+        !read(&num_entries, sizeof(num_entries))) {
+        return;
+    }
+
+    std::map<NcaID, IndexedNca> entries;
+    for (u64 i = 0; i < num_entries; ++i) {
+        NcaID id{};
+        IndexedNca entry;
+        u64 cnmt_size{};
+        if (!read(id.data(), id.size()) || !read(&entry.size, sizeof(entry.size)) ||
+            !read(&entry.title_id, sizeof(entry.title_id)) ||
+            !read(&cnmt_size, sizeof(cnmt_size)) || cnmt_size > data.size() - offset) {
+            return;
+        }
+        entry.cnmt.resize(cnmt_size);
+        void(read(entry.cnmt.data(), entry.cnmt.size()));
+        entries.insert_or_assign(id, std::move(entry));
+    }
+    nca_index = std::move(entries);
+}
+
+void RegisteredCache::SaveIndex() const {
+    if (index_path.empty()) {
+        return;
+    }
+
+    std::vector<u8> data;
+    const auto write = [&data](const void* in, std::size_t size) {
+        const auto* const bytes = static_cast<const u8*>(in);
+        data.insert(data.end(), bytes, bytes + size);
+    };
+
+    const auto path = dir->GetFullPath();
+    const u64 path_size = path.size();
+    const u64 num_entries = nca_index.size();
+    write(&NCA_INDEX_MAGIC, sizeof(NCA_INDEX_MAGIC));
+    write(&NCA_INDEX_VERSION, sizeof(NCA_INDEX_VERSION));
+    write(&path_size, sizeof(path_size));
+    write(path.data(), path.size());
+    write(&num_entries, sizeof(num_entries));
+    for (const auto& [id, entry] : nca_index) {
+        const u64 cnmt_size = entry.cnmt.size();
+        write(id.data(), id.size());
+        write(&entry.size, sizeof(entry.size));
+        write(&entry.title_id, sizeof(entry.title_id));
+        write(&cnmt_size, sizeof(cnmt_size));
+        write(entry.cnmt.data(), entry.cnmt.size());
+    }
+
+    void(Common::FS::CreateParentDirs(index_path));
+    Common::FS::IOFile file{index_path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || file.WriteSpan<u8>(data) != data.size()) {
+        LOG_ERROR(Loader, "Failed to write NCA index: {}",
+                  Common::FS::PathToUTF8String(index_path));
     }
 }
 
@@ -464,7 +616,15 @@ void RegisteredCache::Refresh() {
 }
 
 RegisteredCache::RegisteredCache(VirtualDir dir_, ContentProviderParsingFunction parsing_function)
-    : dir(std::move(dir_)), parser(std::move(parsing_function)) {
+    : RegisteredCache(std::move(dir_), {}, std::move(parsing_function)) {}
+
+RegisteredCache::RegisteredCache(VirtualDir dir_, std::filesystem::path index_path_,
+                                 ContentProviderParsingFunction parsing_function)
+    : dir(std::move(dir_)), parser(std::move(parsing_function)),
+      index_path(std::move(index_path_)) {
+    if (dir != nullptr) {
+        LoadIndex();
+    }
     Refresh();
 }
 
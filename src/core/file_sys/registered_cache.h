@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <filesystem>
 #include <functional>
 #include <memory>
 #include <string>
@@ -137,6 +138,12 @@ public:
     explicit RegisteredCache(
         VirtualDir dir, ContentProviderParsingFunction parsing_function =
                             [](const VirtualFile& file, const NcaID& id) { return file; });
+    // The NCAs found by Refresh are kept in a persistent index at index_path, so that only new
+    // or changed NCAs have to be parsed on later boots.
+    RegisteredCache(
+        VirtualDir dir, std::filesystem::path index_path,
+        ContentProviderParsingFunction parsing_function =
+            [](const VirtualFile& file, const NcaID& id) { return file; });
     ~RegisteredCache() override;
 
     void Refresh() override;
@@ -178,12 +185,22 @@ public:
     bool RemoveExistingEntry(u64 title_id) const;
 
 private:
+    struct IndexedNca {
+        u64 size{};
+        u64 title_id{};
+        // Raw CNMT of meta NCAs, empty for any other content
+        std::vector<u8> cnmt;
+    };
+
     template <typename T>
     void IterateAllMetadata(std::vector<T>& out,
                             std::function<T(const CNMT&, const ContentRecord&)> proc,
                             std::function<bool(const CNMT&, const ContentRecord&)> filter) const;
     std::vector<NcaID> AccumulateFiles() const;
     void ProcessFiles(const std::vector<NcaID>& ids);
+    std::optional<IndexedNca> ParseNca(const VirtualFile& file, const NcaID& id) const;
+    void LoadIndex();
+    void SaveIndex() const;
     void AccumulateSudachiMeta();
     std::optional<NcaID> GetNcaIDFromMetadata(u64 title_id, ContentRecordType type) const;
     VirtualFile GetFileAtID(NcaID id) const;
@@ -194,7 +211,10 @@ private:
 
     VirtualDir dir;
     ContentProviderParsingFunction parser;
+    std::filesystem::path index_path;
 
+    // maps NcaID -> parsed NCA, for every NCA of the directory that could be parsed
+    std::map<NcaID, IndexedNca> nca_index;
     // maps tid -> NcaID of meta
     std::map<u64, NcaID> meta_id;
     // maps tid -> meta
@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "common/thread_worker.h"
+#include "common/zstd_compression.h"
+#include "core/file_sys/vfs/vfs_block_compressed.h"
+
+namespace FileSys {
+
+namespace {
+
+Common::ThreadWorker& GetDecompressionWorkers() {
+    static Common::ThreadWorker workers(std::clamp(std::thread::hardware_concurrency(), 2U, 8U),
+                                        "FS:Decompress");
+    return workers;
+}
+
+bool DecompressBlock(std::span<const u8> compressed, std::span<u8> out) {
+    if (compressed.size() == out.size()) {
+        std::memcpy(out.data(), compressed.data(), out.size());
+        return true;
+    }
+    return Common::Compression::DecompressDataZSTD(compressed, out);
+}
+
+} // Anonymous namespace
+
+VirtualFile BlockCompressedVfsFile::Open(VirtualFile base) {
+    if (base == nullptr) {
+        return nullptr;
+    }
+
+    BlockCompressedHeader header{};
+    if (base->ReadObject(&header) != sizeof(BlockCompressedHeader) || header.magic != Magic) {
+        return nullptr;
+    }
+    if (header.version != Version || header.compression_type != CompressionTypeZstd ||
+        header.block_size_exponent < MinBlockSizeExponent ||
+        header.block_size_exponent > MaxBlockSizeExponent) {
+        LOG_ERROR(Loader, "Unsupported block compressed image {} (version={}, type={}, block={})",
+                  base->GetName(), header.version, header.compression_type,
+                  header.block_size_exponent);
+        return nullptr;
+    }
+
+    const u64 block_size = u64{1} << header.block_size_exponent;
+    const u64 decompressed_size = header.decompressed_size;
+    const u64 num_blocks = (decompressed_size >> header.block_size_exponent) +
+                           ((decompressed_size & (block_size - 1)) != 0 ? 1 : 0);
+    if (num_blocks != header.num_blocks) {
+        LOG_ERROR(Loader, "Block compressed image {} has a bad block count", base->GetName());
+        return nullptr;
+    }
+
+    const u64 table_size = u64{header.num_blocks} * sizeof(u32);
+    if (sizeof(BlockCompressedHeader) + table_size > base->GetSize()) {
+        LOG_ERROR(Loader, "Block compressed image {} is truncated", base->GetName());
+        return nullptr;
+    }
+    std::vector<u32_le> compressed_sizes(header.num_blocks);
+    if (base->ReadArray(compressed_sizes.data(), compressed_sizes.size(),
+                        sizeof(BlockCompressedHeader)) != table_size) {
+        return nullptr;
+    }
+
+    std::vector<u64> block_offsets(header.num_blocks + 1);
+    block_offsets[0] = sizeof(BlockCompressedHeader) + table_size;
+    for (u32 i = 0; i < header.num_blocks; ++i) {
+        const u64 size = std::min(block_size, decompressed_size - u64{i} * block_size);
+        if (compressed_sizes[i] == 0 || compressed_sizes[i] > size) {
+            LOG_ERROR(Loader, "Block compressed image {} has a bad size for block {}",
+                      base->GetName(), i);
+            return nullptr;
+        }
+        block_offsets[i + 1] = block_offsets[i] + compressed_sizes[i];
+    }
+    if (block_offsets.back() > base->GetSize()) {
+        LOG_ERROR(Loader, "Block compressed image {} is truncated", base->GetName());
+        return nullptr;
+    }
+
+    return std::shared_ptr<BlockCompressedVfsFile>(
+        new BlockCompressedVfsFile(std::move(base), header, std::move(block_offsets)));
+}
+
+BlockCompressedVfsFile::BlockCompressedVfsFile(VirtualFile base_,
+                                               const BlockCompressedHeader& header,
+                                               std::vector<u64> block_offsets_)
+    : base{std::move(base_)}, size{header.decompressed_size},
+      block_size_exponent{header.block_size_exponent}, block_offsets{std::move(block_offsets_)},
+      cache_capacity{std::max<std::size_t>(MaxCachedBytes >> block_size_exponent, 4)} {}
+
+BlockCompressedVfsFile::~BlockCompressedVfsFile() = default;
+
+std::string BlockCompressedVfsFile::GetName() const {
+    std::string name = base->GetName();
+    const std::string_view extension = Common::FS::GetExtensionFromFilename(name);
+    if (Common::ToLower(std::string(extension)) == Extension) {
+        name.resize(name.size() - extension.size() - 1);
+    }
+    return name;
+}
+
+std::size_t BlockCompressedVfsFile::GetSize() const {
+    return size;
+}
+
+bool BlockCompressedVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+VirtualDir BlockCompressedVfsFile::GetContainingDirectory() const {
+    return base->GetContainingDirectory();
+}
+
+bool BlockCompressedVfsFile::IsWritable() const {
+    return false;
+}
+
+bool BlockCompressedVfsFile::IsReadable() const {
+    return true;
+}
+
+std::size_t BlockCompressedVfsFile::GetBlockSize(u32 index) const {
+    const std::size_t block_offset = static_cast<std::size_t>(index) << block_size_exponent;
+    return std::min(std::size_t{1} << block_size_exponent, size - block_offset);
+}
+
+bool BlockCompressedVfsFile::LoadBlocks(std::span<const u32> indices, std::span<Block> out) const {
+    struct Job {
+        std::span<const u8> compressed;
+        std::vector<u8>* decompressed;
+    };
+    std::vector<std::vector<u8>> compressed_runs;
+    std::vector<std::shared_ptr<std::vector<u8>>> blocks(indices.size());
+    std::vector<Job> jobs;
+    jobs.reserve(indices.size());
+
+    // Read every run of consecutive blocks from the base file at once
+    for (std::size_t run_begin = 0; run_begin < indices.size();) {
+        std::size_t run_end = run_begin + 1;
+        while (run_end < indices.size() && indices[run_end] == indices[run_end - 1] + 1) {
+            ++run_end;
+        }
+
+        const u64 run_offset = block_offsets[indices[run_begin]];
+        auto& run = compressed_runs.emplace_back(block_offsets[indices[run_end - 1] + 1] -
+                                                 run_offset);
+        {
+            std::scoped_lock lk{base_mutex};
+            if (base->Read(run.data(), run.size(), run_offset) != run.size()) {
+                LOG_ERROR(Loader, "Failed to read blocks of {}", base->GetName());
+                return false;
+            }
+        }
+
+        for (std::size_t i = run_begin; i < run_end; ++i) {
+            const u32 index = indices[i];
+            blocks[i] = std::make_shared<std::vector<u8>>(GetBlockSize(index));
+            jobs.push_back({
+                .compressed = std::span<const u8>(run).subspan(
+                    block_offsets[index] - run_offset,
+                    block_offsets[index + 1] - block_offsets[index]),
+                .decompressed = blocks[i].get(),
+            });
+        }
+        run_begin = run_end;
+    }
+
+    // Decompress all but the last block on the workers while this thread handles the last one
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t remaining = jobs.size() - 1;
+    bool success = true;
+    const auto decompress = [&](const Job& job) {
+        const bool result = DecompressBlock(job.compressed, *job.decompressed);
+        std::scoped_lock lk{mutex};
+        success = success && result;
+    };
+
+    for (std::size_t i = 0; i + 1 < jobs.size(); ++i) {
+        GetDecompressionWorkers().QueueWork([&, i] {
+            decompress(jobs[i]);
+            // Notify under the lock, the waiting thread destroys the condition variable once woken
+            std::scoped_lock lk{mutex};
+            --remaining;
+            done.notify_one();
+        });
+    }
+    decompress(jobs.back());
+
+    std::unique_lock lk{mutex};
+    done.wait(lk, [&remaining] { return remaining == 0; });
+    if (!success) {
+        LOG_ERROR(Loader, "Failed to decompress blocks of {}", base->GetName());
+        return false;
+    }
+    std::copy(blocks.begin(), blocks.end(), out.begin());
+    return true;
+}
+
+std::size_t BlockCompressedVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (offset >= size || length == 0) {
+        return 0;
+    }
+    length = std::min(length, size - offset);
+
+    const u32 first_block = static_cast<u32>(offset >> block_size_exponent);
+    const u32 last_block = static_cast<u32>((offset + length - 1) >> block_size_exponent);
+    std::vector<Block> blocks(last_block - first_block + 1);
+    std::vector<u32> missing_indices;
+
+    {
+        std::scoped_lock lk{cache_mutex};
+        for (u32 index = first_block; index <= last_block; ++index) {
+            const auto it = cache_lookup.find(index);
+            if (it == cache_lookup.end()) {
+                missing_indices.push_back(index);
+                continue;
+            }
+            cache.splice(cache.begin(), cache, it->second);
+            blocks[index - first_block] = it->second->second;
+        }
+    }
+
+    std::vector<Block> missing_blocks(missing_indices.size());
+    if (!missing_indices.empty() && LoadBlocks(missing_indices, missing_blocks)) {
+        std::scoped_lock lk{cache_mutex};
+        for (std::size_t i = 0; i < missing_indices.size(); ++i) {
+            const u32 index = missing_indices[i];
+            blocks[index - first_block] = missing_blocks[i];
+
+            // Another read may have loaded the same block meanwhile
+            if (cache_lookup.contains(index)) {
+                continue;
+            }
+            cache.emplace_front(index, missing_blocks[i]);
+            cache_lookup.emplace(index, cache.begin());
+            if (cache.size() > cache_capacity) {
+                cache_lookup.erase(cache.back().first);
+                cache.pop_back();
+            }
+        }
+    }
+
+    // Copy out of the blocks up to the first one that could not be loaded
+    std::size_t read_size = 0;
+    for (u32 index = first_block; index <= last_block; ++index) {
+        const Block& block = blocks[index - first_block];
+        if (!block) {
+            break;
+        }
+        const std::size_t position = offset + read_size;
+        const std::size_t block_offset = position - (static_cast<std::size_t>(index)
+                                                     << block_size_exponent);
+        const std::size_t copy_size = std::min(length - read_size, block->size() - block_offset);
+        std::memcpy(data + read_size, block->data() + block_offset, copy_size);
+        read_size += copy_size;
+    }
+    return read_size;
+}
+
+std::size_t BlockCompressedVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+bool BlockCompressedVfsFile::Rename(std::string_view new_name) {
+    return false;
+}
+
+} // namespace FileSys
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_funcs.h"
+#include "common/swap.h"
+#include "core/file_sys/vfs/vfs.h"
+
+namespace FileSys {
+
+struct BlockCompressedHeader {
+    u32_le magic;
+    u8 version;
+    u8 compression_type;
+    u8 reserved;
+    u8 block_size_exponent;
+    u32_le num_blocks;
+    INSERT_PADDING_BYTES(4);
+    u64_le decompressed_size;
+};
+static_assert(sizeof(BlockCompressedHeader) == 0x18, "BlockCompressedHeader has incorrect size.");
+
+// A read-only view of a whole image, such as an NSP or XCI, stored as independently zstd compressed
+// blocks of equal size in a sudachi specific container using the .zblk extension. This is not the
+// NSZ/XCZ format, which compresses the NCAs inside of the image instead. The header is followed by
+// the compressed size of every block and then by the blocks themselves; a block whose compressed
+// size equals its size is stored uncompressed. The blocks covered by a read are decompressed in
+// parallel, and recently used blocks are kept in a bounded cache so that the small scattered reads
+// of RomFS accesses stay cheap. The view is named after the image, without the .zblk extension.
+class BlockCompressedVfsFile : public VfsFile {
+public:
+    static constexpr u32 Magic = Common::MakeMagic('Z', 'B', 'L', 'K');
+    static constexpr std::string_view Extension = "zblk";
+    static constexpr u8 Version = 1;
+    static constexpr u8 CompressionTypeZstd = 1;
+    static constexpr u8 MinBlockSizeExponent = 14;
+    static constexpr u8 MaxBlockSizeExponent = 24;
+    static constexpr std::size_t MaxCachedBytes = 0x2000000;
+
+    /// Returns a decompressed view of the file, or nullptr if it is not a block compressed image
+    static VirtualFile Open(VirtualFile base);
+
+    ~BlockCompressedVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    VirtualDir GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view new_name) override;
+
+private:
+    using Block = std::shared_ptr<const std::vector<u8>>;
+    using CacheList = std::list<std::pair<u32, Block>>;
+
+    BlockCompressedVfsFile(VirtualFile base, const BlockCompressedHeader& header,
+                           std::vector<u64> block_offsets);
+
+    std::size_t GetBlockSize(u32 index) const;
+
+    /// Reads and decompresses the given blocks, returns false if any of them is corrupted
+    bool LoadBlocks(std::span<const u32> indices, std::span<Block> out) const;
+
+    VirtualFile base;
+    std::size_t size;
+    u8 block_size_exponent;
+    // Offset of every block in the base file, followed by the end of the last block
+    std::vector<u64> block_offsets;
+
+    // Held while a run of compressed blocks is read from the base file. Concurrent reads that miss
+    // the cache take turns fetching their runs, the decompression that follows runs unlocked.
+    mutable std::mutex base_mutex;
+
+    mutable std::mutex cache_mutex;
+    // Cached blocks, most recently used first
+    mutable CacheList cache;
+    mutable std::unordered_map<u32, CacheList::iterator> cache_lookup;
+    std::size_t cache_capacity;
+};
+
+} // namespace FileSys
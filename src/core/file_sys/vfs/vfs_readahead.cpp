@@ -0,0 +1,236 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+#include "common/alignment.h"
+#include "common/thread_worker.h"
+#include "core/file_sys/vfs/vfs_readahead.h"
+
+namespace FileSys {
+
+namespace {
+
+// Number of back to back sequential reads after which a stream starts being prefetched
+constexpr u32 SequentialReadsToPrefetch = 2;
+
+Common::ThreadWorker& GetReadAheadWorkers() {
+    static Common::ThreadWorker workers(2, "FS:ReadAhead");
+    return workers;
+}
+
+} // Anonymous namespace
+
+struct ReadAheadVfsFile::State : std::enable_shared_from_this<State> {
+    enum class ChunkStatus {
+        Pending,
+        Reading,
+        Ready,
+    };
+
+    struct Chunk {
+        std::size_t offset{};
+        std::size_t size{};
+        std::unique_ptr<u8[]> data;
+        std::size_t data_size{};
+        ChunkStatus status{ChunkStatus::Pending};
+    };
+
+    explicit State(VirtualFile base_) : base{std::move(base_)} {}
+
+    std::size_t ReadBase(u8* data, std::size_t length, std::size_t offset) {
+        std::scoped_lock lk{base_mutex};
+        return base->Read(data, length, offset);
+    }
+
+    /// Drops the chunks of the stream, pending ones are never read. Requires mutex to be held.
+    void CancelChunks() {
+        chunks.clear();
+        pending.clear();
+    }
+
+    /// Queues a chunk on this file's queue, scheduling it on the pool if it is idle.
+    /// Requires mutex to be held.
+    void QueueChunk(std::shared_ptr<Chunk> chunk) {
+        pending.push_back(std::move(chunk));
+        if (!is_scheduled) {
+            is_scheduled = true;
+            GetReadAheadWorkers().QueueWork([self = shared_from_this()] { self->ReadNextChunk(); });
+        }
+    }
+
+    /// Reads the oldest pending chunk. Only one chunk of a file is read at a time and the file
+    /// goes back to the end of the pool queue afterwards, so slow files do not hold up others.
+    void ReadNextChunk() {
+        std::unique_lock lk{mutex};
+        if (pending.empty()) {
+            is_scheduled = false;
+            return;
+        }
+        const auto chunk = std::move(pending.front());
+        pending.pop_front();
+        chunk->status = ChunkStatus::Reading;
+        lk.unlock();
+
+        auto buffer = std::unique_ptr<u8[]>(new u8[chunk->size]);
+        const std::size_t data_size = ReadBase(buffer.get(), chunk->size, chunk->offset);
+
+        lk.lock();
+        chunk->data = std::move(buffer);
+        chunk->data_size = data_size;
+        chunk->status = ChunkStatus::Ready;
+        chunk_ready.notify_all();
+        if (pending.empty()) {
+            is_scheduled = false;
+            return;
+        }
+        GetReadAheadWorkers().QueueWork([self = shared_from_this()] { self->ReadNextChunk(); });
+    }
+
+    VirtualFile base;
+    std::mutex base_mutex;
+
+    std::mutex mutex;
+    std::condition_variable chunk_ready;
+    /// Chunks ahead of the stream position, in any status
+    std::deque<std::shared_ptr<Chunk>> chunks;
+    /// Chunks not read yet, in the order they will be read
+    std::deque<std::shared_ptr<Chunk>> pending;
+    bool is_scheduled{};
+    std::size_t next_offset{};
+    u32 sequential_reads{};
+};
+
+ReadAheadVfsFile::ReadAheadVfsFile(VirtualFile base)
+    : state{std::make_shared<State>(std::move(base))}, size{state->base->GetSize()} {}
+
+ReadAheadVfsFile::~ReadAheadVfsFile() {
+    std::scoped_lock lk{state->mutex};
+    state->CancelChunks();
+}
+
+std::string ReadAheadVfsFile::GetName() const {
+    return state->base->GetName();
+}
+
+std::size_t ReadAheadVfsFile::GetSize() const {
+    return size;
+}
+
+bool ReadAheadVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+VirtualDir ReadAheadVfsFile::GetContainingDirectory() const {
+    return state->base->GetContainingDirectory();
+}
+
+bool ReadAheadVfsFile::IsWritable() const {
+    return false;
+}
+
+bool ReadAheadVfsFile::IsReadable() const {
+    return true;
+}
+
+std::size_t ReadAheadVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (offset >= size) {
+        return 0;
+    }
+    length = std::min(length, size - offset);
+    const std::size_t end = offset + length;
+
+    std::unique_lock lk{state->mutex};
+    if (offset == state->next_offset) {
+        ++state->sequential_reads;
+    } else {
+        // The stream moved elsewhere, a chunk still being read is dropped once it finishes
+        state->sequential_reads = 0;
+        state->CancelChunks();
+    }
+    state->next_offset = end;
+
+    // Copy as much of the start of the request as possible from prefetched chunks
+    std::size_t read_size = 0;
+    while (read_size < length) {
+        const std::size_t position = offset + read_size;
+        const auto it = std::find_if(state->chunks.begin(), state->chunks.end(),
+                                     [position](const auto& chunk) {
+                                         return position >= chunk->offset &&
+                                                position < chunk->offset + ChunkSize;
+                                     });
+        if (it == state->chunks.end()) {
+            break;
+        }
+        const auto chunk = *it;
+        if (chunk->status == State::ChunkStatus::Pending) {
+            // Reading it here is faster than waiting for the pool to get to it
+            std::erase(state->pending, chunk);
+            state->chunks.erase(it);
+            break;
+        }
+        state->chunk_ready.wait(
+            lk, [&chunk] { return chunk->status == State::ChunkStatus::Ready; });
+
+        const std::size_t chunk_offset = position - chunk->offset;
+        if (chunk_offset >= chunk->data_size) {
+            break;
+        }
+        const std::size_t copy_size = std::min(length - read_size, chunk->data_size - chunk_offset);
+        std::memcpy(data + read_size, chunk->data.get() + chunk_offset, copy_size);
+        read_size += copy_size;
+    }
+
+    // Chunks that end before the request does have been consumed
+    const auto consumed = [end](const auto& chunk) { return chunk->offset + ChunkSize <= end; };
+    std::erase_if(state->chunks, consumed);
+    std::erase_if(state->pending, consumed);
+    const bool prefetch = state->sequential_reads >= SequentialReadsToPrefetch;
+    lk.unlock();
+
+    if (read_size < length) {
+        read_size += state->ReadBase(data + read_size, length - read_size, offset + read_size);
+    }
+    if (!prefetch) {
+        return read_size;
+    }
+
+    // Queue the chunks following the request that are not prefetched yet
+    lk.lock();
+    if (state->next_offset != end) {
+        // Another read moved the stream while this one was reading
+        return read_size;
+    }
+    const std::size_t window_end = std::min(size, end + ChunkSize * MaxChunksAhead);
+    for (std::size_t chunk_offset = Common::AlignDown(end, ChunkSize); chunk_offset < window_end;
+         chunk_offset += ChunkSize) {
+        const bool queued = std::any_of(
+            state->chunks.begin(), state->chunks.end(),
+            [chunk_offset](const auto& chunk) { return chunk->offset == chunk_offset; });
+        if (queued) {
+            continue;
+        }
+
+        auto chunk = std::make_shared<State::Chunk>();
+        chunk->offset = chunk_offset;
+        chunk->size = std::min(ChunkSize, size - chunk_offset);
+        state->chunks.push_back(chunk);
+        state->QueueChunk(std::move(chunk));
+    }
+
+    return read_size;
+}
+
+std::size_t ReadAheadVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+bool ReadAheadVfsFile::Rename(std::string_view new_name) {
+    return false;
+}
+
+} // namespace FileSys
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+
+#include "core/file_sys/vfs/vfs.h"
+
+namespace FileSys {
+
+// A read-only VfsFile that detects sequential reads of the file it wraps and reads the data that
+// follows on a background thread. Later reads of that data are copied out of a bounded set of
+// prefetched chunks, so decryption and decompression in the layers below overlap with the caller.
+// Each file prefetches through its own queue, one chunk at a time, and a seek cancels the chunks
+// that have not started reading. Reads of the wrapped file are serialized.
+class ReadAheadVfsFile : public VfsFile {
+public:
+    static constexpr std::size_t ChunkSize = 0x40000;
+    static constexpr std::size_t MaxChunksAhead = 8;
+
+    explicit ReadAheadVfsFile(VirtualFile base);
+    ~ReadAheadVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    VirtualDir GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view new_name) override;
+
+private:
+    struct State;
+
+    // Shared with the background reads, which may outlive the file
+    std::shared_ptr<State> state;
+    std::size_t size;
+};
+
+} // namespace FileSys
@@ -2,14 +2,20 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
+#include <thread>
 #include <utility>
 #include "common/assert.h"
 #include "common/fs/file.h"
 #include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
 #include "common/fs/path_util.h"
+#include "common/literals.h"
 #include "common/logging/log.h"
+#include "common/string_util.h"
 #include "core/file_sys/vfs/vfs.h"
 #include "core/file_sys/vfs/vfs_real.h"
 
@@ -27,11 +33,15 @@
 namespace FileSys {
 
 namespace FS = Common::FS;
+using namespace Common::Literals;
 
 namespace {
 
 constexpr size_t MaxOpenFiles = 512;
 
+// Smaller images are read just as fast through a stream and are not worth an address space range
+constexpr u64 MinMappedImageSize = 1_MiB;
+
 constexpr FS::FileAccessMode ModeFlagsToFileAccessMode(OpenMode mode) {
     switch (mode) {
     case OpenMode::Read:
@@ -46,6 +56,23 @@ constexpr FS::FileAccessMode ModeFlagsToFileAccessMode(OpenMode mode) {
     }
 }
 
+/// Read-only game images that are worth memory mapping instead of reading through a stream
+bool IsMappableImage(std::string_view path) {
+    static constexpr std::array<std::string_view, 6> extensions{"nsp", "xci", "nca",
+                                                                "nsz", "xcz", "zblk"};
+    const auto extension = Common::ToLower(std::string(FS::GetExtensionFromFilename(path)));
+    return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+}
+
+std::shared_ptr<const FS::MappedFile> MapImage(const std::string& path) {
+    if (FS::GetSize(path) < MinMappedImageSize) {
+        return nullptr;
+    }
+    // Without the fallback, files that can not be mapped keep using the regular reads
+    auto file = std::make_shared<const FS::MappedFile>(path, false);
+    return file->IsMemoryMapped() ? std::move(file) : nullptr;
+}
+
 } // Anonymous namespace
 
 RealVfsFilesystem::RealVfsFilesystem() : VfsFilesystem(nullptr) {}
@@ -107,10 +134,7 @@ VirtualFile RealVfsFilesystem::OpenFile(std::string_view path_, OpenMode perms)
 
 VirtualFile RealVfsFilesystem::CreateFile(std::string_view path_, OpenMode perms) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
-    {
-        std::scoped_lock lk{list_lock};
-        cache.erase(path);
-    }
+    this->RemoveFromCache(path);
 
     // Current usages of CreateFile expect to delete the contents of an existing file.
     if (FS::IsFile(path)) {
@@ -140,11 +164,8 @@ VirtualFile RealVfsFilesystem::CopyFile(std::string_view old_path_, std::string_
 VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_view new_path_) {
     const auto old_path = FS::SanitizePath(old_path_, FS::DirectorySeparator::PlatformDefault);
     const auto new_path = FS::SanitizePath(new_path_, FS::DirectorySeparator::PlatformDefault);
-    {
-        std::scoped_lock lk{list_lock};
-        cache.erase(old_path);
-        cache.erase(new_path);
-    }
+    this->RemoveFromCache(old_path);
+    this->RemoveFromCache(new_path);
     if (!FS::RenameFile(old_path, new_path)) {
         return nullptr;
     }
@@ -153,10 +174,7 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
 
 bool RealVfsFilesystem::DeleteFile(std::string_view path_) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
-    {
-        std::scoped_lock lk{list_lock};
-        cache.erase(path);
-    }
+    this->RemoveFromCache(path);
     return FS::RemoveFile(path);
 }
 
@@ -220,6 +238,31 @@ std::unique_lock<std::mutex> RealVfsFilesystem::RefreshReference(const std::stri
     return lk;
 }
 
+std::shared_ptr<const FS::MappedFile> RealVfsFilesystem::RefreshMapping(
+    const std::string& path, FileReference& reference) {
+    std::scoped_lock lk{list_lock};
+
+    // Temporarily remove from list.
+    this->RemoveReferenceFromListLocked(reference);
+
+    // Restore mapping if needed, the path may have stopped being mapped since the caller checked.
+    if (!reference.mapping && reference.use_mapping) {
+        reference.mapping = MapImage(path);
+        if (reference.mapping) {
+            this->EvictSingleReferenceLocked();
+            num_open_files++;
+        } else {
+            reference.use_mapping = false;
+        }
+    }
+
+    // Reinsert into list.
+    this->InsertReferenceIntoListLocked(reference);
+
+    // Readers keep their own reference, so an eviction does not unmap data being copied.
+    return reference.mapping;
+}
+
 void RealVfsFilesystem::DropReference(std::unique_ptr<FileReference>&& reference) {
     std::scoped_lock lk{list_lock};
 
@@ -227,9 +270,43 @@ void RealVfsFilesystem::DropReference(std::unique_ptr<FileReference>&& reference
     this->RemoveReferenceFromListLocked(*reference);
 
     // Close the file.
-    if (reference->file) {
-        reference->file.reset();
-        num_open_files--;
+    this->CloseReferenceLocked(*reference);
+}
+
+void RealVfsFilesystem::RemoveFromCache(const std::string& path) {
+    // Declared before the lock, so that the file is destroyed after unlocking if this was the
+    // last reference to it.
+    std::shared_ptr<VfsFile> file;
+    std::weak_ptr<const FS::MappedFile> mapping;
+    {
+        std::scoped_lock lk{list_lock};
+
+        const auto it = cache.find(path);
+        if (it == cache.end()) {
+            return;
+        }
+        file = it->second.lock();
+        cache.erase(it);
+        if (!file) {
+            return;
+        }
+
+        // The path is about to be truncated or replaced, stop reading it through the mapping.
+        auto& reference = *static_cast<RealVfsFile&>(*file).reference;
+        reference.use_mapping = false;
+        if (reference.mapping) {
+            mapping = reference.mapping;
+            this->RemoveReferenceFromListLocked(reference);
+            reference.mapping.reset();
+            num_open_files--;
+            this->InsertReferenceIntoListLocked(reference);
+        }
+    }
+
+    // Reads still copying out of the mapping hold their own reference to it, so it is only unmapped
+    // once they are done. Wait for them before the caller touches the path.
+    while (!mapping.expired()) {
+        std::this_thread::yield();
     }
 }
 
@@ -243,17 +320,25 @@ void RealVfsFilesystem::EvictSingleReferenceLocked() {
     this->RemoveReferenceFromListLocked(reference);
 
     // Close the file.
+    this->CloseReferenceLocked(reference);
+
+    // Reinsert into closed list.
+    this->InsertReferenceIntoListLocked(reference);
+}
+
+void RealVfsFilesystem::CloseReferenceLocked(FileReference& reference) {
     if (reference.file) {
         reference.file.reset();
         num_open_files--;
     }
-
-    // Reinsert into closed list.
-    this->InsertReferenceIntoListLocked(reference);
+    if (reference.mapping) {
+        reference.mapping.reset();
+        num_open_files--;
+    }
 }
 
 void RealVfsFilesystem::InsertReferenceIntoListLocked(FileReference& reference) {
-    if (reference.file) {
+    if (reference.file || reference.mapping) {
         open_references.push_front(reference);
     } else {
         closed_references.push_front(reference);
@@ -261,7 +346,7 @@ void RealVfsFilesystem::InsertReferenceIntoListLocked(FileReference& reference)
 }
 
 void RealVfsFilesystem::RemoveReferenceFromListLocked(FileReference& reference) {
-    if (reference.file) {
+    if (reference.file || reference.mapping) {
         open_references.erase(open_references.iterator_to(reference));
     } else {
         closed_references.erase(closed_references.iterator_to(reference));
@@ -273,7 +358,9 @@ RealVfsFile::RealVfsFile(RealVfsFilesystem& base_, std::unique_ptr<FileReference
                          std::optional<std::string> parent_path_)
     : base(base_), reference(std::move(reference_)), path(path_),
       parent_path(parent_path_ ? std::move(*parent_path_) : FS::GetParentPath(path_)),
-      path_components(FS::SplitPathComponentsCopy(path_)), size(size_), perms(perms_) {}
+      path_components(FS::SplitPathComponentsCopy(path_)), size(size_), perms(perms_) {
+    reference->use_mapping = perms_ == OpenMode::Read && IsMappableImage(path_);
+}
 
 RealVfsFile::~RealVfsFile() {
     base.DropReference(std::move(reference));
@@ -292,6 +379,11 @@ std::size_t RealVfsFile::GetSize() const {
     if (size) {
         return *size;
     }
+    if (reference->use_mapping) {
+        if (const auto file = base.RefreshMapping(path, *reference)) {
+            return file->Size();
+        }
+    }
     auto lk = base.RefreshReference(path, perms, *reference);
     return reference->file ? reference->file->GetSize() : 0;
 }
@@ -315,6 +407,18 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (reference->use_mapping) {
+        if (const auto file = base.RefreshMapping(path, *reference)) {
+            const auto contents = file->Data();
+            if (offset >= contents.size()) {
+                return 0;
+            }
+            const std::size_t read_size = std::min(length, contents.size() - offset);
+            std::memcpy(data, contents.data() + offset, read_size);
+            return read_size;
+        }
+    }
+
     auto lk = base.RefreshReference(path, perms, *reference);
     if (!reference->file || !reference->file->Seek(static_cast<s64>(offset))) {
         return 0;
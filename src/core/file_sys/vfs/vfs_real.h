@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <optional>
@@ -13,12 +14,22 @@
 
 namespace Common::FS {
 class IOFile;
-}
+class MappedFile;
+} // namespace Common::FS
 
 namespace FileSys {
 
 struct FileReference : public Common::IntrusiveListBaseNode<FileReference> {
     std::shared_ptr<Common::FS::IOFile> file{};
+    std::shared_ptr<const Common::FS::MappedFile> mapping{};
+
+    // Large game images opened for reading are memory mapped instead of opened as a stream, reads
+    // are then plain copies out of the page cache. The mapping counts as an open file, so it is
+    // closed with the file and on eviction. Before this filesystem truncates, moves or deletes the
+    // path, the file stops using the mapping and waits for the reads still copying out of it, as
+    // reading a truncated mapping faults. Truncating the image from outside the emulator while it
+    // is mapped is not guarded against.
+    std::atomic_bool use_mapping{};
 };
 
 class RealVfsFile;
@@ -57,6 +68,8 @@ private:
     friend class RealVfsFile;
     std::unique_lock<std::mutex> RefreshReference(const std::string& path, OpenMode perms,
                                                   FileReference& reference);
+    std::shared_ptr<const Common::FS::MappedFile> RefreshMapping(const std::string& path,
+                                                                 FileReference& reference);
     void DropReference(std::unique_ptr<FileReference>&& reference);
 
 private:
@@ -66,7 +79,9 @@ private:
                                   OpenMode perms = OpenMode::Read);
 
 private:
+    void RemoveFromCache(const std::string& path);
     void EvictSingleReferenceLocked();
+    void CloseReferenceLocked(FileReference& reference);
     void InsertReferenceIntoListLocked(FileReference& reference);
     void RemoveReferenceFromListLocked(FileReference& reference);
 };
@@ -2,13 +2,27 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "core/file_sys/errors.h"
+#include "core/file_sys/vfs/vfs_readahead.h"
 #include "core/hle/service/cmif_serialization.h"
 #include "core/hle/service/filesystem/fsp/fs_i_file.h"
 
 namespace Service::FileSystem {
 
+namespace {
+
+FileSys::VirtualFile WrapReadOnlyFile(FileSys::VirtualFile file) {
+    // Files that can be written to are not read ahead, as the prefetched data could go stale
+    if (file->IsWritable()) {
+        return file;
+    }
+    return std::make_shared<FileSys::ReadAheadVfsFile>(std::move(file));
+}
+
+} // Anonymous namespace
+
 IFile::IFile(Core::System& system_, FileSys::VirtualFile file_)
-    : ServiceFramework{system_, "IFile"}, backend{std::make_unique<FileSys::Fsa::IFile>(file_)} {
+    : ServiceFramework{system_, "IFile"},
+      backend{std::make_unique<FileSys::Fsa::IFile>(WrapReadOnlyFile(std::move(file_)))} {
     // clang-format off
     static const FunctionInfo functions[] = {
         {0, D<&IFile::Read>, "Read"},
@@ -2,13 +2,15 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "core/file_sys/errors.h"
+#include "core/file_sys/vfs/vfs_readahead.h"
 #include "core/hle/service/cmif_serialization.h"
 #include "core/hle/service/filesystem/fsp/fs_i_storage.h"
 
 namespace Service::FileSystem {
 
 IStorage::IStorage(Core::System& system_, FileSys::VirtualFile backend_)
-    : ServiceFramework{system_, "IStorage"}, backend(std::move(backend_)) {
+    : ServiceFramework{system_, "IStorage"},
+      backend(std::make_shared<FileSys::ReadAheadVfsFile>(std::move(backend_))) {
     static const FunctionInfo functions[] = {
         {0, D<&IStorage::Read>, "Read"},
         {1, nullptr, "Write"},
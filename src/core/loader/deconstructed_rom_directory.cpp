@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <cstring>
+#include <future>
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "core/core.h"
@@ -185,6 +186,27 @@ AppLoader_DeconstructedRomDirectory::LoadResult AppLoader_DeconstructedRomDirect
                                        "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7",
                                        "subsdk8", "subsdk9", "sdk"};
 
+    // Read the modules on this thread, as the storages below the ExeFS are not safe to read
+    // concurrently, and decode each of them in the background while the next one is read. Both
+    // passes below lay out the same images, so they are only decoded once.
+    std::array<std::future<NSOModule>, static_modules.size()> module_reads;
+    for (size_t i = 0; i < static_modules.size(); i++) {
+        const FileSys::VirtualFile module_file{dir->GetFile(static_modules[i])};
+        if (!module_file) {
+            continue;
+        }
+        auto raw_module = AppLoader_NSO::ReadRawModule(*module_file);
+        if (!raw_module) {
+            return {ResultStatus::ErrorLoadingNSO, {}};
+        }
+        module_reads[i] = std::async(std::launch::async, [module = std::move(*raw_module),
+                                                          name = static_modules[i]]() mutable {
+            AppLoader_NSO::DecodeModule(module, name);
+            return std::move(module);
+        });
+    }
+
+    std::array<std::optional<NSOModule>, static_modules.size()> module_data;
     std::size_t code_size{};
 
     // Define an nce patch context for each potential module.
@@ -193,14 +215,15 @@ AppLoader_DeconstructedRomDirectory::LoadResult AppLoader_DeconstructedRomDirect
     // Use the NSO module loader to figure out the code layout
     for (size_t i = 0; i < static_modules.size(); i++) {
         const auto& module = static_modules[i];
-        const FileSys::VirtualFile module_file{dir->GetFile(module)};
-        if (!module_file) {
+        if (!module_reads[i].valid()) {
             continue;
         }
 
+        module_data[i] = module_reads[i].get();
+
         const bool should_pass_arguments = std::strcmp(module, "rtld") == 0;
         const auto tentative_next_load_addr = AppLoader_NSO::LoadModule(
-            process, system, *module_file, code_size, should_pass_arguments, false, {},
+            process, system, *module_data[i], module, code_size, should_pass_arguments, false, {},
             patch_ctx.GetPatchers(), patch_ctx.GetLastIndex());
         if (!tentative_next_load_addr) {
             return {ResultStatus::ErrorLoadingNSO, {}};
@@ -236,15 +259,14 @@ AppLoader_DeconstructedRomDirectory::LoadResult AppLoader_DeconstructedRomDirect
                                    system.GetContentProvider()};
     for (size_t i = 0; i < static_modules.size(); i++) {
         const auto& module = static_modules[i];
-        const FileSys::VirtualFile module_file{dir->GetFile(module)};
-        if (!module_file) {
+        if (!module_data[i]) {
             continue;
         }
 
         const VAddr load_addr{next_load_addr};
         const bool should_pass_arguments = std::strcmp(module, "rtld") == 0;
         const auto tentative_next_load_addr = AppLoader_NSO::LoadModule(
-            process, system, *module_file, load_addr, should_pass_arguments, true, pm,
+            process, system, *module_data[i], module, load_addr, should_pass_arguments, true, pm,
             patch_ctx.GetPatchers(), patch_ctx.GetIndex(i));
         if (!tentative_next_load_addr) {
             return {ResultStatus::ErrorLoadingNSO, {}};
@@ -1,11 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2018 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
+#include <future>
 #include <utility>
 
 #include "common/hex_util.h"
-#include "common/scope_exit.h"
 #include "core/core.h"
+#include "core/crypto/sha_util.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/nca_metadata.h"
 #include "core/file_sys/registered_cache.h"
@@ -14,7 +16,6 @@
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/deconstructed_rom_directory.h"
 #include "core/loader/nca.h"
-#include "mbedtls/sha256.h"
 
 namespace Loader {
 
@@ -109,31 +110,32 @@ ResultStatus AppLoader_NCA::VerifyIntegrity(std::function<bool(size_t, size_t)>
     const auto input_hash =
         Common::HexStringToVector(file->GetName().substr(0, NcaFileNameHashLength), false);
 
-    // Declare buffer to read into.
-    std::vector<u8> buffer(4_MiB);
-
-    // Initialize sha256 verification context.
-    mbedtls_sha256_context ctx;
-    mbedtls_sha256_init(&ctx);
-    mbedtls_sha256_starts_ret(&ctx, 0);
-
-    // Ensure we maintain a clean state on exit.
-    SCOPE_EXIT {
-        mbedtls_sha256_free(&ctx);
-    };
+    // Declare buffers to read into. The next chunk is read while the current one is hashed.
+    std::array<std::vector<u8>, 2> buffers{std::vector<u8>(4_MiB), std::vector<u8>(4_MiB)};
+    Core::Crypto::SHA256 sha;
 
     // Declare counters.
     const size_t total_size = file->GetSize();
     size_t processed_size = 0;
 
+    const auto read_chunk = [this, total_size](std::vector<u8>& buffer, size_t offset) {
+        const size_t intended_read_size = std::min(buffer.size(), total_size - offset);
+        return file->Read(buffer.data(), intended_read_size, offset);
+    };
+
     // Begin iterating the file.
-    while (processed_size < total_size) {
-        // Refill the buffer.
-        const size_t intended_read_size = std::min(buffer.size(), total_size - processed_size);
-        const size_t read_size = file->Read(buffer.data(), intended_read_size, processed_size);
+    size_t current = 0;
+    size_t read_size = total_size > 0 ? read_chunk(buffers[current], 0) : 0;
+    while (processed_size < total_size && read_size > 0) {
+        // Refill the other buffer in the background.
+        std::future<size_t> next_read;
+        if (const size_t next_offset = processed_size + read_size; next_offset < total_size) {
+            next_read = std::async(std::launch::async, read_chunk,
+                                   std::ref(buffers[current ^ 1]), next_offset);
+        }
 
         // Update the hash function with the buffer contents.
-        mbedtls_sha256_update_ret(&ctx, buffer.data(), read_size);
+        sha.Update(std::span(buffers[current]).first(read_size));
 
         // Update counters.
         processed_size += read_size;
@@ -142,11 +144,13 @@ ResultStatus AppLoader_NCA::VerifyIntegrity(std::function<bool(size_t, size_t)>
         if (!progress_callback(processed_size, total_size)) {
             return ResultStatus::ErrorIntegrityVerificationFailed;
         }
+
+        read_size = next_read.valid() ? next_read.get() : 0;
+        current ^= 1;
     }
 
     // Finalize context and compute the output hash.
-    std::array<u8, NcaSha256HashLength> output_hash;
-    mbedtls_sha256_finish_ret(&ctx, output_hash.data());
+    const Core::Crypto::SHA256Hash output_hash = sha.Finish();
 
     // Compare to expected.
     if (std::memcmp(input_hash.data(), output_hash.data(), NcaSha256HalfHashLength) != 0) {
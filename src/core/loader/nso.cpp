@@ -3,6 +3,7 @@
 
 #include <cinttypes>
 #include <cstring>
+#include <future>
 #include <vector>
 
 #include "common/common_funcs.h"
@@ -12,6 +13,7 @@
 #include "common/settings.h"
 #include "common/swap.h"
 #include "core/core.h"
+#include "core/crypto/sha_util.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/hle/kernel/code_set.h"
 #include "core/hle/kernel/k_page_table.h"
@@ -59,6 +61,11 @@ bool NSOHeader::IsSegmentCompressed(size_t segment_num) const {
     return ((flags >> segment_num) & 1) != 0;
 }
 
+bool NSOHeader::IsSegmentHashChecked(size_t segment_num) const {
+    ASSERT_MSG(segment_num < 3, "Invalid segment {}", segment_num);
+    return ((flags >> (segment_num + 3)) & 1) != 0;
+}
+
 AppLoader_NSO::AppLoader_NSO(FileSys::VirtualFile file_) : AppLoader(std::move(file_)) {}
 
 FileType AppLoader_NSO::IdentifyType(const FileSys::VirtualFile& in_file) {
@@ -74,17 +81,13 @@ FileType AppLoader_NSO::IdentifyType(const FileSys::VirtualFile& in_file) {
     return FileType::NSO;
 }
 
-std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::System& system,
-                                               const FileSys::VfsFile& nso_file, VAddr load_base,
-                                               bool should_pass_arguments, bool load_into_process,
-                                               std::optional<FileSys::PatchManager> pm,
-                                               std::vector<Core::NCE::Patcher>* patches,
-                                               s32 patch_index) {
+std::optional<NSOModule> AppLoader_NSO::ReadRawModule(const FileSys::VfsFile& nso_file) {
     if (nso_file.GetSize() < sizeof(NSOHeader)) {
         return std::nullopt;
     }
 
-    NSOHeader nso_header{};
+    NSOModule module;
+    NSOHeader& nso_header = module.header;
     if (sizeof(NSOHeader) != nso_file.ReadObject(&nso_header)) {
         return std::nullopt;
     }
@@ -93,6 +96,68 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
         return std::nullopt;
     }
 
+    for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
+        module.segments[i] = nso_file.ReadBytes(nso_header.segments_compressed_size[i],
+                                                nso_header.segments[i].offset);
+    }
+    return module;
+}
+
+void AppLoader_NSO::DecodeModule(NSOModule& module, std::string_view name) {
+    const NSOHeader& nso_header = module.header;
+    const auto decode_segment = [&](std::size_t i) {
+        std::vector<u8>& data = module.segments[i];
+        if (nso_header.IsSegmentCompressed(i)) {
+            data = DecompressSegment(data, nso_header.segments[i]);
+        }
+        if (nso_header.IsSegmentHashChecked(i) &&
+            Core::Crypto::SHA256::Hash(data) != nso_header.segment_hashes[i]) {
+            LOG_WARNING(Loader, "Hash mismatch in segment {} of NSO {}", i, name);
+        }
+    };
+
+    std::array<std::future<void>, 2> futures;
+    for (std::size_t i = 0; i < futures.size(); ++i) {
+        futures[i] = std::async(std::launch::async, decode_segment, i);
+    }
+    decode_segment(futures.size());
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+std::optional<NSOModule> AppLoader_NSO::ReadModule(const FileSys::VfsFile& nso_file) {
+    auto module = ReadRawModule(nso_file);
+    if (module) {
+        DecodeModule(*module, nso_file.GetName());
+    }
+    return module;
+}
+
+std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::System& system,
+                                               const FileSys::VfsFile& nso_file, VAddr load_base,
+                                               bool should_pass_arguments, bool load_into_process,
+                                               std::optional<FileSys::PatchManager> pm,
+                                               std::vector<Core::NCE::Patcher>* patches,
+                                               s32 patch_index) {
+    const auto module = ReadModule(nso_file);
+    if (!module) {
+        return std::nullopt;
+    }
+    return LoadModule(process, system, *module, nso_file.GetName(), load_base,
+                      should_pass_arguments, load_into_process, std::move(pm), patches,
+                      patch_index);
+}
+
+std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::System& system,
+                                               const NSOModule& module, const std::string& name,
+                                               VAddr load_base, bool should_pass_arguments,
+                                               bool load_into_process,
+                                               std::optional<FileSys::PatchManager> pm,
+                                               std::vector<Core::NCE::Patcher>* patches,
+                                               s32 patch_index) {
+    const NSOHeader& nso_header = module.header;
+
     // Allocate some space at the beginning if we are patching in PreText mode.
     const size_t module_start = [&]() -> size_t {
 #ifdef HAS_NCE
@@ -110,11 +175,7 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
     Kernel::CodeSet codeset;
     Kernel::PhysicalMemory program_image;
     for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
-        std::vector<u8> data = nso_file.ReadBytes(nso_header.segments_compressed_size[i],
-                                                  nso_header.segments[i].offset);
-        if (nso_header.IsSegmentCompressed(i)) {
-            data = DecompressSegment(data, nso_header.segments[i]);
-        }
+        const std::vector<u8>& data = module.segments[i];
         program_image.resize(module_start + nso_header.segments[i].location +
                              static_cast<u32>(data.size()));
         std::memcpy(program_image.data() + module_start + nso_header.segments[i].location,
@@ -148,7 +209,6 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
     }
 
     // Apply patches if necessary
-    const auto name = nso_file.GetName();
     if (pm && (pm->HasNSOPatch(nso_header.build_id, name) || Settings::values.dump_nso)) {
         std::span<u8> patchable_section(program_image.data() + module_start,
                                         program_image.size() - module_start);
@@ -5,7 +5,10 @@
 
 #include <array>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/file_sys/patch_manager.h"
@@ -58,6 +61,7 @@ struct NSOHeader {
     std::array<SHA256Hash, 3> segment_hashes;
 
     bool IsSegmentCompressed(size_t segment_num) const;
+    bool IsSegmentHashChecked(size_t segment_num) const;
 };
 static_assert(sizeof(NSOHeader) == 0x100, "NSOHeader has incorrect size.");
 static_assert(std::is_trivially_copyable_v<NSOHeader>, "NSOHeader must be trivially copyable.");
@@ -71,6 +75,13 @@ struct NSOArgumentHeader {
 };
 static_assert(sizeof(NSOArgumentHeader) == 0x20, "NSOArgumentHeader has incorrect size.");
 
+/// An NSO with its segments read from the file. Once decoded, the segments are decompressed and
+/// verified, ready to be laid out in memory.
+struct NSOModule {
+    NSOHeader header{};
+    std::array<std::vector<u8>, 3> segments;
+};
+
 /// Loads an NSO file
 class AppLoader_NSO final : public AppLoader {
 public:
@@ -89,6 +100,27 @@ public:
         return IdentifyType(file);
     }
 
+    /**
+     * Reads the header and the segments of an NSO file as they are stored, without decoding them.
+     *
+     * @param nso_file The NSO file to read.
+     *
+     * @return The module, or std::nullopt if the file is not a valid NSO.
+     */
+    static std::optional<NSOModule> ReadRawModule(const FileSys::VfsFile& nso_file);
+
+    /**
+     * Decompresses the segments of a module read with ReadRawModule and checks them against their
+     * hashes, in parallel. The file the module was read from is not accessed.
+     *
+     * @param module The module to decode in place.
+     * @param name   The name of the module, used in log messages.
+     */
+    static void DecodeModule(NSOModule& module, std::string_view name);
+
+    /// Reads and decodes the segments of an NSO file.
+    static std::optional<NSOModule> ReadModule(const FileSys::VfsFile& nso_file);
+
     static std::optional<VAddr> LoadModule(Kernel::KProcess& process, Core::System& system,
                                            const FileSys::VfsFile& nso_file, VAddr load_base,
                                            bool should_pass_arguments, bool load_into_process,
@@ -96,6 +128,15 @@ public:
                                            std::vector<Core::NCE::Patcher>* patches = nullptr,
                                            s32 patch_index = -1);
 
+    /// Loads a module previously read with ReadModule, name is used to look up patches.
+    static std::optional<VAddr> LoadModule(Kernel::KProcess& process, Core::System& system,
+                                           const NSOModule& module, const std::string& name,
+                                           VAddr load_base, bool should_pass_arguments,
+                                           bool load_into_process,
+                                           std::optional<FileSys::PatchManager> pm = {},
+                                           std::vector<Core::NCE::Patcher>* patches = nullptr,
+                                           s32 patch_index = -1);
+
     LoadResult Load(Kernel::KProcess& process, Core::System& system) override;
 
     ResultStatus ReadNSOModules(Modules& out_modules) override;
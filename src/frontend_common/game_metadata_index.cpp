@@ -0,0 +1,331 @@
+// SPDX-FileCopyrightText: 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <system_error>
+
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/thread_worker.h"
+#include "core/core.h"
+#include "core/file_sys/control_metadata.h"
+#include "core/file_sys/vfs/vfs.h"
+#include "frontend_common/game_metadata_index.h"
+
+namespace {
+
+constexpr u32 IndexMagic = 0x58444D47; // GMDX
+constexpr u32 IndexVersion = 1;
+
+struct FileStamp {
+    u64 size{};
+    s64 modification_time{};
+};
+
+std::optional<FileStamp> GetFileStamp(const std::filesystem::path& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const auto modification_time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return FileStamp{
+        .size = size,
+        .modification_time = static_cast<s64>(modification_time.time_since_epoch().count()),
+    };
+}
+
+/// Entries of extracted titles also depend on the files next to them, so they are never indexed
+bool IsIndexable(const GameMetadataIndex::Entry& entry) {
+    return !entry.titles.empty() && entry.file_type != Loader::FileType::DeconstructedRomDirectory;
+}
+
+GameMetadataIndex::Title ReadTitle(Loader::AppLoader& loader, u64 program_id) {
+    GameMetadataIndex::Title title;
+    title.program_id = program_id;
+    title.name = " ";
+    [[maybe_unused]] const auto icon_result = loader.ReadIcon(title.icon);
+    [[maybe_unused]] const auto title_result = loader.ReadTitle(title.name);
+
+    FileSys::NACP nacp;
+    if (loader.ReadControlData(nacp) == Loader::ResultStatus::Success) {
+        title.version = nacp.GetVersionString();
+    }
+    return title;
+}
+
+class Writer {
+public:
+    template <typename T>
+    void Write(const T& value) {
+        const auto offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    void WriteBytes(std::span<const u8> data) {
+        Write(static_cast<u64>(data.size()));
+        buffer.insert(buffer.end(), data.begin(), data.end());
+    }
+
+    void WriteString(std::string_view string) {
+        WriteBytes({reinterpret_cast<const u8*>(string.data()), string.size()});
+    }
+
+    std::span<const u8> Data() const {
+        return buffer;
+    }
+
+private:
+    std::vector<u8> buffer;
+};
+
+class Reader {
+public:
+    explicit Reader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    bool Read(T& value) {
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool ReadBytes(std::vector<u8>& out) {
+        u64 size{};
+        if (!Read(size) || data.size() - offset < size) {
+            return false;
+        }
+        out.assign(data.begin() + offset, data.begin() + offset + size);
+        offset += size;
+        return true;
+    }
+
+    bool ReadString(std::string& out) {
+        u64 size{};
+        if (!Read(size) || data.size() - offset < size) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(data.data() + offset), size);
+        offset += size;
+        return true;
+    }
+
+private:
+    std::span<const u8> data;
+    size_t offset{};
+};
+
+} // Anonymous namespace
+
+GameMetadataIndex::GameMetadataIndex(std::filesystem::path index_path_)
+    : index_path{std::move(index_path_)} {
+    if (!Load()) {
+        entries.clear();
+    }
+}
+
+GameMetadataIndex::~GameMetadataIndex() = default;
+
+bool GameMetadataIndex::Load() {
+    if (!Common::FS::Exists(index_path)) {
+        return true;
+    }
+
+    Common::FS::IOFile file{index_path, Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Frontend, "Failed to open game metadata index: {}",
+                  Common::FS::PathToUTF8String(index_path));
+        return false;
+    }
+
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadSpan<u8>(data) != data.size()) {
+        return false;
+    }
+
+    Reader reader{data};
+    u32 magic{};
+    u32 version{};
+    u64 num_entries{};
+    if (!reader.Read(magic) || !reader.Read(version) || !reader.Read(num_entries) ||
+        magic != IndexMagic || version != IndexVersion) {
+        LOG_WARNING(Frontend, "Ignoring game metadata index with unknown format");
+        return false;
+    }
+
+    for (u64 i = 0; i < num_entries; ++i) {
+        std::string path;
+        Entry entry;
+        u64 num_titles{};
+        if (!reader.ReadString(path) || !reader.Read(entry.file_size) ||
+            !reader.Read(entry.modification_time) || !reader.Read(entry.file_type) ||
+            !reader.Read(num_titles)) {
+            return false;
+        }
+        for (u64 j = 0; j < num_titles; ++j) {
+            Title title;
+            if (!reader.Read(title.program_id) || !reader.ReadString(title.name) ||
+                !reader.ReadString(title.version) || !reader.ReadBytes(title.icon)) {
+                return false;
+            }
+            entry.titles.push_back(std::move(title));
+        }
+        entries.insert_or_assign(std::move(path), IndexedEntry{std::move(entry)});
+    }
+    return true;
+}
+
+bool GameMetadataIndex::Save() {
+    Writer writer;
+    {
+        std::scoped_lock lk{mutex};
+        std::erase_if(entries, [](const auto& pair) { return !pair.second.used; });
+
+        writer.Write(IndexMagic);
+        writer.Write(IndexVersion);
+        writer.Write(static_cast<u64>(entries.size()));
+        for (const auto& [path, indexed] : entries) {
+            const Entry& entry = indexed.entry;
+            writer.WriteString(path);
+            writer.Write(entry.file_size);
+            writer.Write(entry.modification_time);
+            writer.Write(entry.file_type);
+            writer.Write(static_cast<u64>(entry.titles.size()));
+            for (const Title& title : entry.titles) {
+                writer.Write(title.program_id);
+                writer.WriteString(title.name);
+                writer.WriteString(title.version);
+                writer.WriteBytes(title.icon);
+            }
+        }
+    }
+
+    void(Common::FS::CreateParentDirs(index_path));
+    Common::FS::IOFile file{index_path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Frontend, "Failed to open game metadata index for writing: {}",
+                  Common::FS::PathToUTF8String(index_path));
+        return false;
+    }
+    return file.WriteSpan(writer.Data()) == writer.Data().size();
+}
+
+std::optional<GameMetadataIndex::Entry> GameMetadataIndex::Find(
+    const std::filesystem::path& path) {
+    const auto stamp = GetFileStamp(path);
+    if (!stamp) {
+        return std::nullopt;
+    }
+
+    std::scoped_lock lk{mutex};
+    const auto it = entries.find(Common::FS::PathToUTF8String(path));
+    if (it == entries.end() || it->second.entry.file_size != stamp->size ||
+        it->second.entry.modification_time != stamp->modification_time) {
+        return std::nullopt;
+    }
+    it->second.used = true;
+    return it->second.entry;
+}
+
+std::vector<GameMetadataIndex::Entry> GameMetadataIndex::Scan(
+    Core::System& system, const FileSys::VirtualFilesystem& vfs,
+    std::span<const std::filesystem::path> paths, size_t num_threads, std::stop_token stop_token) {
+    std::vector<Entry> results(paths.size());
+    std::vector<size_t> stale_indices;
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (stop_token.stop_requested()) {
+            return results;
+        }
+        if (auto entry = Find(paths[i])) {
+            results[i] = std::move(*entry);
+        } else {
+            stale_indices.push_back(i);
+        }
+    }
+
+    if (stale_indices.empty()) {
+        return results;
+    }
+
+    const auto parse = [&](size_t index) {
+        if (stop_token.stop_requested()) {
+            return;
+        }
+        const auto& path = paths[index];
+        const auto stamp = GetFileStamp(path);
+        const auto physical_name = Common::FS::PathToUTF8String(path);
+        const auto file = vfs->OpenFile(physical_name, FileSys::OpenMode::Read);
+        if (!stamp || !file) {
+            return;
+        }
+
+        Entry entry = ReadEntry(system, file);
+        entry.file_size = stamp->size;
+        entry.modification_time = stamp->modification_time;
+        if (IsIndexable(entry)) {
+            std::scoped_lock lk{mutex};
+            entries.insert_or_assign(physical_name, IndexedEntry{entry, true});
+        }
+        results[index] = std::move(entry);
+    };
+
+    if (num_threads <= 1 || stale_indices.size() == 1) {
+        for (const size_t index : stale_indices) {
+            parse(index);
+        }
+        return results;
+    }
+
+    Common::ThreadWorker workers(std::min(num_threads, stale_indices.size()), "GameMetadataIndex");
+    for (const size_t index : stale_indices) {
+        workers.QueueWork([&parse, index] { parse(index); });
+    }
+    workers.WaitForRequests();
+    return results;
+}
+
+GameMetadataIndex::Entry GameMetadataIndex::ReadEntry(Core::System& system,
+                                                      const FileSys::VirtualFile& file) {
+    Entry entry;
+    const auto loader = Loader::GetLoader(system, file);
+    if (!loader) {
+        return entry;
+    }
+
+    entry.file_type = loader->GetFileType();
+    if (entry.file_type == Loader::FileType::Unknown ||
+        entry.file_type == Loader::FileType::Error) {
+        return entry;
+    }
+
+    u64 program_id = 0;
+    const auto result = loader->ReadProgramId(program_id);
+
+    std::vector<u64> program_ids;
+    loader->ReadProgramIds(program_ids);
+
+    if (result == Loader::ResultStatus::Success && program_ids.size() > 1 &&
+        (entry.file_type == Loader::FileType::XCI || entry.file_type == Loader::FileType::NSP)) {
+        for (const auto id : program_ids) {
+            const auto title_loader = Loader::GetLoader(system, file, id);
+            if (title_loader) {
+                entry.titles.push_back(ReadTitle(*title_loader, id));
+            }
+        }
+    } else {
+        entry.titles.push_back(ReadTitle(*loader, program_id));
+    }
+    return entry;
+}
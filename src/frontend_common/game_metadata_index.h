@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/file_sys/vfs/vfs_types.h"
+#include "core/loader/loader.h"
+
+namespace Core {
+class System;
+}
+
+/**
+ * Persistent index of the metadata shown in game lists, keyed by file path.
+ * An entry is valid as long as the size and modification time of its file are unchanged, so only
+ * new or modified files have to be parsed when a game directory is scanned again.
+ */
+class GameMetadataIndex {
+public:
+    struct Title {
+        u64 program_id{};
+        std::string name;
+        std::string version;
+        std::vector<u8> icon;
+    };
+
+    struct Entry {
+        u64 file_size{};
+        s64 modification_time{};
+        Loader::FileType file_type{Loader::FileType::Unknown};
+        std::vector<Title> titles;
+    };
+
+    /// Creates an index stored at the given path, loading it if it exists
+    explicit GameMetadataIndex(std::filesystem::path index_path);
+    ~GameMetadataIndex();
+
+    /// Writes the index to disk, dropping entries that were not used since it was loaded
+    bool Save();
+
+    /// Returns the entry of the file if it has not changed since it was indexed
+    std::optional<Entry> Find(const std::filesystem::path& path);
+
+    /**
+     * Returns the entries of the given files, parsing the files missing from the index or changed
+     * since they were indexed on num_threads threads.
+     * Files that can not be loaded get an entry with no titles. Once a stop is requested, the files
+     * not parsed yet are skipped and get an empty entry as well.
+     */
+    std::vector<Entry> Scan(Core::System& system, const FileSys::VirtualFilesystem& vfs,
+                            std::span<const std::filesystem::path> paths, size_t num_threads,
+                            std::stop_token stop_token = {});
+
+    /// Reads the metadata of every title in a file
+    static Entry ReadEntry(Core::System& system, const FileSys::VirtualFile& file);
+
+private:
+    struct IndexedEntry {
+        Entry entry;
+        bool used{};
+    };
+
+    bool Load();
+
+    std::filesystem::path index_path;
+    std::mutex mutex;
+    std::unordered_map<std::string, IndexedEntry> entries;
+};
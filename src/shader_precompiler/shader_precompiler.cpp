@@ -0,0 +1,505 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "common/fs/path_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/thread_worker.h"
+#include "shader_recompiler/backend/glasm/emit_glasm.h"
+#include "shader_recompiler/backend/glsl/emit_glsl.h"
+#include "shader_recompiler/backend/spirv/emit_spirv.h"
+#include "shader_recompiler/exception.h"
+#include "shader_recompiler/frontend/maxwell/control_flow.h"
+#include "shader_recompiler/frontend/maxwell/translate_program.h"
+#include "shader_recompiler/host_translate_info.h"
+#include "shader_recompiler/object_pool.h"
+#include "shader_recompiler/profile.h"
+#include "shader_recompiler/program_header.h"
+#include "shader_recompiler/runtime_info.h"
+#include "video_core/shader_environment.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Shader::Maxwell::MergeDualVertexPrograms;
+using Shader::Maxwell::TranslateProgram;
+using VideoCommon::FileEnvironment;
+
+enum class Backend : u32 {
+    SPIRV,
+    GLSL,
+    GLASM,
+};
+
+constexpr std::array ALL_BACKENDS{Backend::SPIRV, Backend::GLSL, Backend::GLASM};
+
+struct ShaderPools {
+    void ReleaseContents() {
+        flow_block.ReleaseContents();
+        block.ReleaseContents();
+        inst.ReleaseContents();
+    }
+
+    Shader::ObjectPool<Shader::IR::Inst> inst{8192};
+    Shader::ObjectPool<Shader::IR::Block> block{32};
+    Shader::ObjectPool<Shader::Maxwell::Flow::Block> flow_block{32};
+};
+
+/// Result of compiling a single shader stage of a pipeline with a backend
+struct ShaderReport {
+    size_t pipeline{};
+    Shader::Stage stage{};
+    Backend backend{};
+    std::chrono::microseconds translate_time{};
+    std::chrono::microseconds emit_time{};
+    size_t output_size{};
+    std::string error;
+};
+
+std::string_view BackendName(Backend backend) {
+    switch (backend) {
+    case Backend::SPIRV:
+        return "spirv";
+    case Backend::GLSL:
+        return "glsl";
+    case Backend::GLASM:
+        return "glasm";
+    }
+    return "unknown";
+}
+
+std::string_view StageName(Shader::Stage stage) {
+    switch (stage) {
+    case Shader::Stage::VertexB:
+        return "VB";
+    case Shader::Stage::TessellationControl:
+        return "TC";
+    case Shader::Stage::TessellationEval:
+        return "TE";
+    case Shader::Stage::Geometry:
+        return "GS";
+    case Shader::Stage::Fragment:
+        return "FS";
+    case Shader::Stage::Compute:
+        return "CS";
+    case Shader::Stage::VertexA:
+        return "VA";
+    default:
+        return "UK";
+    }
+}
+
+/// Profile of a typical desktop Vulkan driver, used for the SPIR-V backend
+Shader::Profile MakeVulkanProfile() {
+    return Shader::Profile{
+        .supported_spirv = 0x00010500,
+        .unified_descriptor_binding = true,
+        .support_descriptor_aliasing = true,
+        .support_int8 = true,
+        .support_int16 = true,
+        .support_int64 = true,
+        .support_vertex_instance_id = false,
+        .support_float_controls = true,
+        .support_separate_denorm_behavior = true,
+        .support_separate_rounding_mode = true,
+        .support_fp16_denorm_preserve = true,
+        .support_fp32_denorm_preserve = true,
+        .support_fp16_denorm_flush = true,
+        .support_fp32_denorm_flush = true,
+        .support_fp16_signed_zero_nan_preserve = true,
+        .support_fp32_signed_zero_nan_preserve = true,
+        .support_fp64_signed_zero_nan_preserve = true,
+        .support_explicit_workgroup_layout = true,
+        .support_vote = true,
+        .support_viewport_index_layer_non_geometry = true,
+        .support_viewport_mask = false,
+        .support_typeless_image_loads = true,
+        .support_demote_to_helper_invocation = true,
+        .support_int64_atomics = true,
+        .support_derivative_control = true,
+        .support_geometry_shader_passthrough = false,
+        .support_native_ndc = true,
+        .support_scaled_attributes = true,
+        .support_multi_viewport = true,
+        .support_geometry_streams = true,
+        .warp_size_potentially_larger_than_guest = false,
+        .lower_left_origin_mode = false,
+        .need_declared_frag_colors = false,
+        .min_ssbo_alignment = 16,
+        .max_user_clip_distances = 8,
+    };
+}
+
+/// Profile of a typical desktop OpenGL driver, used for the GLSL and GLASM backends
+Shader::Profile MakeOpenGLProfile() {
+    return Shader::Profile{
+        .supported_spirv = 0x00010000,
+        .unified_descriptor_binding = false,
+        .support_int64 = true,
+        .support_vertex_instance_id = true,
+        .support_vote = true,
+        .support_viewport_index_layer_non_geometry = true,
+        .support_viewport_mask = true,
+        .support_typeless_image_loads = true,
+        .support_derivative_control = true,
+        .support_geometry_shader_passthrough = true,
+        .support_native_ndc = true,
+        .support_gl_nv_gpu_shader_5 = true,
+        .support_gl_amd_gpu_shader_half_float = false,
+        .support_gl_texture_shadow_lod = true,
+        .support_gl_warp_intrinsics = false,
+        .support_gl_variable_aoffi = true,
+        .support_gl_sparse_textures = true,
+        .support_gl_derivative_control = true,
+        .support_geometry_streams = true,
+        .lower_left_origin_mode = true,
+        .need_declared_frag_colors = true,
+        .has_broken_spirv_clamp = true,
+        .has_broken_unsigned_image_offsets = true,
+        .has_broken_signed_operations = true,
+        .ignore_nan_fp_comparisons = true,
+        .gl_max_compute_smem_size = 0xc000,
+        .min_ssbo_alignment = 16,
+        .max_user_clip_distances = 8,
+    };
+}
+
+Shader::HostTranslateInfo MakeHostTranslateInfo() {
+    return Shader::HostTranslateInfo{
+        .support_float64 = true,
+        .support_float16 = true,
+        .support_int64 = true,
+        .needs_demote_reorder = false,
+        .support_snorm_render_buffer = true,
+        .support_viewport_index_layer = true,
+        .min_ssbo_alignment = 16,
+        .support_geometry_shader_passthrough = false,
+        .support_conditional_barrier = true,
+    };
+}
+
+Shader::RuntimeInfo MakeRuntimeInfo(const Shader::IR::Program* previous_program) {
+    Shader::RuntimeInfo info;
+    if (previous_program) {
+        info.previous_stage_stores = previous_program->info.stores;
+        info.previous_stage_legacy_stores_mapping = previous_program->info.legacy_stores_mapping;
+    } else {
+        // Mark all stores as available for vertex shaders
+        info.previous_stage_stores.mask.set();
+    }
+    return info;
+}
+
+size_t Emit(Backend backend, const Shader::Profile& profile,
+            const Shader::RuntimeInfo& runtime_info, Shader::IR::Program& program,
+            Shader::Backend::Bindings& binding) {
+    switch (backend) {
+    case Backend::SPIRV:
+        Shader::Maxwell::ConvertLegacyToGeneric(program, runtime_info);
+        return Shader::Backend::SPIRV::EmitSPIRV(profile, runtime_info, program, binding).size() *
+               sizeof(u32);
+    case Backend::GLSL:
+        Shader::Maxwell::ConvertLegacyToGeneric(program, runtime_info);
+        return Shader::Backend::GLSL::EmitGLSL(profile, runtime_info, program, binding).size();
+    case Backend::GLASM:
+        return Shader::Backend::GLASM::EmitGLASM(profile, runtime_info, program, binding).size();
+    }
+    return 0;
+}
+
+/// Translates and emits every stage of a pipeline with a single backend.
+/// Programs are translated again for each backend, as emitting modifies them.
+void CompilePipeline(ShaderPools& pools, const Shader::HostTranslateInfo& host_info,
+                     const Shader::Profile& profile, Backend backend, size_t pipeline_index,
+                     std::span<FileEnvironment> envs, std::vector<ShaderReport>& reports) {
+    pools.ReleaseContents();
+
+    std::vector<Shader::IR::Program> programs;
+    std::vector<size_t> program_reports;
+    programs.reserve(envs.size());
+    std::optional<Shader::IR::Program> vertex_a;
+    for (FileEnvironment& env : envs) {
+        ShaderReport& report{reports.emplace_back()};
+        report.pipeline = pipeline_index;
+        report.stage = env.ShaderStage();
+        report.backend = backend;
+
+        const auto start{Clock::now()};
+        try {
+            Shader::IR::Program program;
+            if (env.ShaderStage() == Shader::Stage::Compute) {
+                Shader::Maxwell::Flow::CFG cfg{env, pools.flow_block, env.StartAddress()};
+                program = TranslateProgram(pools.inst, pools.block, env, cfg, host_info);
+            } else {
+                const bool is_vertex_a{env.ShaderStage() == Shader::Stage::VertexA};
+                const u32 cfg_offset{
+                    static_cast<u32>(env.StartAddress() + sizeof(Shader::ProgramHeader))};
+                Shader::Maxwell::Flow::CFG cfg(env, pools.flow_block, cfg_offset, is_vertex_a);
+                program = TranslateProgram(pools.inst, pools.block, env, cfg, host_info);
+                if (env.ShaderStage() == Shader::Stage::VertexB && vertex_a) {
+                    program = MergeDualVertexPrograms(*vertex_a, program, env);
+                }
+            }
+            report.translate_time =
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+            if (env.ShaderStage() == Shader::Stage::VertexA) {
+                // VertexA is merged into VertexB and never emitted on its own
+                vertex_a = std::move(program);
+                continue;
+            }
+            programs.push_back(std::move(program));
+            program_reports.push_back(reports.size() - 1);
+        } catch (const Shader::Exception& exception) {
+            report.error = exception.what();
+            return;
+        } catch (const std::exception& exception) {
+            // Anything else, like running out of memory, fails this pipeline instead of the run
+            report.error = exception.what();
+            return;
+        }
+    }
+
+    const Shader::IR::Program* previous_program{};
+    Shader::Backend::Bindings binding;
+    for (size_t index = 0; index < programs.size(); ++index) {
+        ShaderReport& report{reports[program_reports[index]]};
+        Shader::IR::Program& program{programs[index]};
+        const auto start{Clock::now()};
+        try {
+            const Shader::RuntimeInfo runtime_info{MakeRuntimeInfo(previous_program)};
+            report.output_size = Emit(backend, profile, runtime_info, program, binding);
+        } catch (const Shader::Exception& exception) {
+            report.error = exception.what();
+        } catch (const std::exception& exception) {
+            report.error = exception.what();
+        }
+        report.emit_time =
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        previous_program = &program;
+    }
+}
+
+void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <pipeline cache file>\n"
+                 "-b, --backend         Backend to compile with: spirv, glsl, glasm or all "
+                 "(default: all)\n"
+                 "-h, --help            Display this help and exit\n"
+                 "-j, --jobs            Number of worker threads (default: all cores)\n"
+                 "-r, --report          Write a per-shader CSV report to the specified file\n"
+                 "-v, --version         Output version information and exit\n";
+}
+
+void PrintVersion() {
+    std::cout << "sudachi-shader-precompiler " << Common::g_scm_branch << " "
+              << Common::g_scm_desc << std::endl;
+}
+
+bool WriteReport(const std::filesystem::path& path, std::span<const ShaderReport> reports) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "pipeline,stage,backend,translate_us,emit_us,size_bytes,error\n";
+    for (const ShaderReport& report : reports) {
+        std::string error{report.error};
+        std::ranges::replace(error, '"', '\'');
+        file << fmt::format("{},{},{},{},{},{},\"{}\"\n", report.pipeline, StageName(report.stage),
+                            BackendName(report.backend), report.translate_time.count(),
+                            report.emit_time.count(), report.output_size, error);
+    }
+    return file.good();
+}
+
+} // Anonymous namespace
+
+int main(int argc, char** argv) {
+    Common::Log::Initialize();
+    Common::Log::SetColorConsoleBackendEnabled(true);
+    Common::Log::Start();
+
+    // Compilation failures are collected in the report, keep the log quiet
+    Common::Log::Filter filter;
+    filter.ParseFilterString("*:Warning");
+    Common::Log::SetGlobalFilter(filter);
+
+    std::vector<Backend> backends(ALL_BACKENDS.begin(), ALL_BACKENDS.end());
+    size_t num_jobs{std::max(std::thread::hardware_concurrency(), 1U)};
+    std::optional<std::string> report_path;
+
+    static struct option long_options[] = {
+        // clang-format off
+        {"backend", required_argument, 0, 'b'},
+        {"help", no_argument, 0, 'h'},
+        {"jobs", required_argument, 0, 'j'},
+        {"report", required_argument, 0, 'r'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+        // clang-format on
+    };
+
+    int option_index = 0;
+    std::string filepath;
+    while (optind < argc) {
+        const int arg = getopt_long(argc, argv, "b:hj:r:v", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'b': {
+                const std::string_view name{optarg};
+                if (name == "all") {
+                    backends.assign(ALL_BACKENDS.begin(), ALL_BACKENDS.end());
+                } else if (name == "spirv") {
+                    backends = {Backend::SPIRV};
+                } else if (name == "glsl") {
+                    backends = {Backend::GLSL};
+                } else if (name == "glasm") {
+                    backends = {Backend::GLASM};
+                } else {
+                    std::cout << "Unknown backend " << name << "\n";
+                    return 1;
+                }
+                break;
+            }
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'j': {
+                const int jobs{std::atoi(optarg)};
+                if (jobs <= 0) {
+                    std::cout << "Invalid number of jobs " << optarg << "\n";
+                    return 1;
+                }
+                num_jobs = static_cast<size_t>(jobs);
+                break;
+            }
+            case 'r':
+                report_path = optarg;
+                break;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            filepath = argv[optind];
+            ++optind;
+        }
+    }
+    if (filepath.empty()) {
+        PrintHelp(argv[0]);
+        return 1;
+    }
+
+    std::optional<VideoCommon::PipelineCacheContents> contents{
+        VideoCommon::ReadPipelineCache(filepath)};
+    if (!contents) {
+        std::cout << "Failed to read pipeline cache " << filepath << "\n";
+        return 1;
+    }
+    std::cout << fmt::format("Pipeline cache version {}, {} pipelines, {} unique shaders\n",
+                             contents->cache_version, contents->entries.size(),
+                             contents->env_hashes.size());
+    if (contents->num_missing_envs != 0) {
+        std::cout << fmt::format("Skipping {} pipelines with missing shaders\n",
+                                 contents->num_missing_envs);
+    }
+
+    const Shader::HostTranslateInfo host_info{MakeHostTranslateInfo()};
+    const Shader::Profile vulkan_profile{MakeVulkanProfile()};
+    const Shader::Profile opengl_profile{MakeOpenGLProfile()};
+
+    // Every pipeline writes to its own slot, so workers never contend on the results
+    const size_t num_pipelines{contents->entries.size()};
+    std::vector<std::vector<ShaderReport>> pipeline_reports(num_pipelines);
+    std::atomic<size_t> num_deserialize_failures{};
+
+    const auto start{Clock::now()};
+    {
+        Common::StatefulThreadWorker<ShaderPools> workers(num_jobs, "ShaderPrecompiler",
+                                                          [] { return ShaderPools{}; });
+        for (size_t index = 0; index < num_pipelines; ++index) {
+            workers.QueueWork([&, index](ShaderPools* pools) {
+                std::vector<FileEnvironment> envs{contents->entries[index].Deserialize()};
+                if (envs.empty()) {
+                    ++num_deserialize_failures;
+                    return;
+                }
+                for (const Backend backend : backends) {
+                    const Shader::Profile& profile{backend == Backend::SPIRV ? vulkan_profile
+                                                                             : opengl_profile};
+                    CompilePipeline(*pools, host_info, profile, backend, index, envs,
+                                    pipeline_reports[index]);
+                }
+            });
+        }
+        workers.WaitForRequests();
+    }
+    const auto wall_time{
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start)};
+
+    std::vector<ShaderReport> reports;
+    for (std::vector<ShaderReport>& pipeline : pipeline_reports) {
+        std::ranges::move(pipeline, std::back_inserter(reports));
+    }
+
+    std::cout << fmt::format("Compiled {} pipelines with {} threads in {} ms\n", num_pipelines,
+                             num_jobs, wall_time.count());
+    if (num_deserialize_failures != 0) {
+        std::cout << fmt::format("{} pipelines failed to deserialize\n",
+                                 num_deserialize_failures.load());
+    }
+    for (const Backend backend : backends) {
+        size_t num_shaders{};
+        size_t num_failures{};
+        size_t output_size{};
+        std::chrono::microseconds translate_time{};
+        std::chrono::microseconds emit_time{};
+        for (const ShaderReport& report : reports) {
+            if (report.backend != backend) {
+                continue;
+            }
+            ++num_shaders;
+            num_failures += report.error.empty() ? 0 : 1;
+            output_size += report.output_size;
+            translate_time += report.translate_time;
+            emit_time += report.emit_time;
+        }
+        std::cout << fmt::format("{:>5}: {} shaders, {} failed, translate {} ms, emit {} ms, "
+                                 "output {} KiB\n",
+                                 BackendName(backend), num_shaders, num_failures,
+                                 translate_time.count() / 1000, emit_time.count() / 1000,
+                                 output_size / 1024);
+    }
+
+    if (report_path && !WriteReport(*report_path, reports)) {
+        std::cout << "Failed to write report " << *report_path << "\n";
+        return 1;
+    }
+    return num_deserialize_failures != 0 ? 1 : 0;
+}
@@ -1,8 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2018 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -23,6 +25,7 @@
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/submission_package.h"
 #include "core/loader/loader.h"
+#include "frontend_common/game_metadata_index.h"
 #include "sudachi/compatibility_list.h"
 #include "sudachi/game_list.h"
 #include "sudachi/game_list_p.h"
@@ -193,10 +196,11 @@ QString FormatPatchNameVersions(const FileSys::PatchManager& patch_manager,
 
 QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::string& name,
                                         const std::size_t size, const std::vector<u8>& icon,
-                                        Loader::AppLoader& loader, u64 program_id,
+                                        Loader::FileType file_type, u64 program_id,
                                         const CompatibilityList& compatibility_list,
                                         const PlayTime::PlayTimeManager& play_time_manager,
-                                        const FileSys::PatchManager& patch) {
+                                        const FileSys::PatchManager& patch,
+                                        const std::function<QString()>& format_patch_versions) {
     const auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
 
     // The game list uses this as compatibility number for untested games
@@ -205,7 +209,6 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
         compatibility = it->second.first;
     }
 
-    const auto file_type = loader.GetFileType();
     const auto file_type_string = QString::fromStdString(Loader::GetFileTypeString(file_type));
 
     QList<QStandardItem*> list{
@@ -217,10 +220,8 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
         new GameListItemPlayTime(play_time_manager.GetPlayTime(program_id)),
         new GameListItemTotalTimes(play_time_manager.GetTotalTimes(program_id))};
 
-    const auto patch_versions = GetGameListCachedObject(
-        fmt::format("{:016X}", patch.GetTitleID()), "pv.txt", [&patch, &loader] {
-            return FormatPatchNameVersions(patch, loader, loader.IsRomFSUpdatable());
-        });
+    const auto patch_versions = GetGameListCachedObject(fmt::format("{:016X}", patch.GetTitleID()),
+                                                        "pv.txt", format_patch_versions);
     list.insert(2, new GameListItem(patch_versions));
 
     return list;
@@ -242,7 +243,7 @@ GameListWorker::GameListWorker(FileSys::VirtualFilesystem vfs_,
 
 GameListWorker::~GameListWorker() {
     this->disconnect();
-    stop_requested.store(true);
+    stop_source.request_stop();
     processing_completed.Wait();
 }
 
@@ -328,16 +329,21 @@ void GameListWorker::AddTitlesToGameList(GameListDir* parent_dir) {
             GetMetadataFromControlNCA(patch, *control, icon, name);
         }
 
-        auto entry = MakeGameListEntry(file->GetFullPath(), name, file->GetSize(), icon, *loader,
-                                       program_id, compatibility_list, play_time_manager, patch);
+        auto entry = MakeGameListEntry(
+            file->GetFullPath(), name, file->GetSize(), icon, loader->GetFileType(), program_id,
+            compatibility_list, play_time_manager, patch, [&patch, &loader] {
+                return FormatPatchNameVersions(patch, *loader, loader->IsRomFSUpdatable());
+            });
         RecordEvent([=](GameList* game_list) { game_list->AddEntry(entry, parent_dir); });
     }
 }
 
 void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_path, bool deep_scan,
                                     GameListDir* parent_dir) {
-    const auto callback = [this, target, parent_dir](const std::filesystem::path& path) -> bool {
-        if (stop_requested) {
+    std::vector<std::filesystem::path> game_paths;
+
+    const auto callback = [this, target, &game_paths](const std::filesystem::path& path) -> bool {
+        if (stop_source.stop_requested()) {
             // Breaks the callback loop.
             return false;
         }
@@ -347,12 +353,18 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
 
         if (!is_dir &&
             (HasSupportedFileExtension(physical_name) || IsExtractedNCAMain(physical_name))) {
+            if (target == ScanTarget::PopulateGameList) {
+                // Files are read together afterwards, so unchanged ones can come from the index
+                game_paths.push_back(path);
+                return true;
+            }
+
             const auto file = vfs->OpenFile(physical_name, FileSys::OpenMode::Read);
             if (!file) {
                 return true;
             }
 
-            auto loader = Loader::GetLoader(system, file);
+            const auto loader = Loader::GetLoader(system, file);
             if (!loader) {
                 return true;
             }
@@ -365,69 +377,21 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
             u64 program_id = 0;
             const auto res2 = loader->ReadProgramId(program_id);
 
-            if (target == ScanTarget::FillManualContentProvider) {
-                if (res2 == Loader::ResultStatus::Success && file_type == Loader::FileType::NCA) {
-                    provider->AddEntry(FileSys::TitleType::Application,
-                                       FileSys::GetCRTypeFromNCAType(FileSys::NCA{file}.GetType()),
-                                       program_id, file);
-                } else if (res2 == Loader::ResultStatus::Success &&
-                           (file_type == Loader::FileType::XCI ||
-                            file_type == Loader::FileType::NSP)) {
-                    const auto nsp = file_type == Loader::FileType::NSP
-                                         ? std::make_shared<FileSys::NSP>(file)
-                                         : FileSys::XCI{file}.GetSecurePartitionNSP();
-                    for (const auto& title : nsp->GetNCAs()) {
-                        for (const auto& entry : title.second) {
-                            provider->AddEntry(entry.first.first, entry.first.second, title.first,
-                                               entry.second->GetBaseFile());
-                        }
+            if (res2 == Loader::ResultStatus::Success && file_type == Loader::FileType::NCA) {
+                provider->AddEntry(FileSys::TitleType::Application,
+                                   FileSys::GetCRTypeFromNCAType(FileSys::NCA{file}.GetType()),
+                                   program_id, file);
+            } else if (res2 == Loader::ResultStatus::Success &&
+                       (file_type == Loader::FileType::XCI || file_type == Loader::FileType::NSP)) {
+                const auto nsp = file_type == Loader::FileType::NSP
+                                     ? std::make_shared<FileSys::NSP>(file)
+                                     : FileSys::XCI{file}.GetSecurePartitionNSP();
+                for (const auto& title : nsp->GetNCAs()) {
+                    for (const auto& entry : title.second) {
+                        provider->AddEntry(entry.first.first, entry.first.second, title.first,
+                                           entry.second->GetBaseFile());
                     }
                 }
-            } else {
-                std::vector<u64> program_ids;
-                loader->ReadProgramIds(program_ids);
-
-                if (res2 == Loader::ResultStatus::Success && program_ids.size() > 1 &&
-                    (file_type == Loader::FileType::XCI || file_type == Loader::FileType::NSP)) {
-                    for (const auto id : program_ids) {
-                        loader = Loader::GetLoader(system, file, id);
-                        if (!loader) {
-                            continue;
-                        }
-
-                        std::vector<u8> icon;
-                        [[maybe_unused]] const auto res1 = loader->ReadIcon(icon);
-
-                        std::string name = " ";
-                        [[maybe_unused]] const auto res3 = loader->ReadTitle(name);
-
-                        const FileSys::PatchManager patch{id, system.GetFileSystemController(),
-                                                          system.GetContentProvider()};
-
-                        auto entry = MakeGameListEntry(
-                            physical_name, name, Common::FS::GetSize(physical_name), icon, *loader,
-                            id, compatibility_list, play_time_manager, patch);
-
-                        RecordEvent(
-                            [=](GameList* game_list) { game_list->AddEntry(entry, parent_dir); });
-                    }
-                } else {
-                    std::vector<u8> icon;
-                    [[maybe_unused]] const auto res1 = loader->ReadIcon(icon);
-
-                    std::string name = " ";
-                    [[maybe_unused]] const auto res3 = loader->ReadTitle(name);
-
-                    const FileSys::PatchManager patch{program_id, system.GetFileSystemController(),
-                                                      system.GetContentProvider()};
-
-                    auto entry = MakeGameListEntry(
-                        physical_name, name, Common::FS::GetSize(physical_name), icon, *loader,
-                        program_id, compatibility_list, play_time_manager, patch);
-
-                    RecordEvent(
-                        [=](GameList* game_list) { game_list->AddEntry(entry, parent_dir); });
-                }
             }
         } else if (is_dir) {
             watch_list.append(QString::fromStdString(physical_name));
@@ -442,18 +406,73 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
     } else {
         Common::FS::IterateDirEntries(dir_path, callback, Common::FS::DirEntryFilter::File);
     }
+
+    if (target == ScanTarget::PopulateGameList && !stop_source.stop_requested()) {
+        AddFilesToGameList(game_paths, parent_dir);
+    }
+}
+
+void GameListWorker::AddFilesToGameList(std::span<const std::filesystem::path> paths,
+                                        GameListDir* parent_dir) {
+    const size_t num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    const auto entries =
+        metadata_index->Scan(system, vfs, paths, num_threads, stop_source.get_token());
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (stop_source.stop_requested()) {
+            break;
+        }
+
+        const auto physical_name = Common::FS::PathToUTF8String(paths[i]);
+        const auto& file_entry = entries[i];
+        const bool is_multi_program = file_entry.titles.size() > 1;
+
+        for (const auto& title : file_entry.titles) {
+            const FileSys::PatchManager patch{title.program_id, system.GetFileSystemController(),
+                                              system.GetContentProvider()};
+
+            // Only needed when the patch versions are not cached, so the loader is made on demand
+            const auto format_patch_versions = [&] {
+                const auto file = vfs->OpenFile(physical_name, FileSys::OpenMode::Read);
+                if (!file) {
+                    return QString{};
+                }
+                const auto loader =
+                    Loader::GetLoader(system, file, is_multi_program ? title.program_id : 0);
+                if (!loader) {
+                    return QString{};
+                }
+                return FormatPatchNameVersions(patch, *loader, loader->IsRomFSUpdatable());
+            };
+
+            auto entry = MakeGameListEntry(physical_name, title.name, file_entry.file_size,
+                                           title.icon, file_entry.file_type, title.program_id,
+                                           compatibility_list, play_time_manager, patch,
+                                           format_patch_versions);
+
+            RecordEvent([=](GameList* game_list) { game_list->AddEntry(entry, parent_dir); });
+        }
+    }
 }
 
 void GameListWorker::run() {
     watch_list.clear();
     provider->ClearAllEntries();
 
+    // Without the game list cache the index only lives for this scan and is never written
+    std::filesystem::path index_path;
+    if (UISettings::values.cache_game_list) {
+        index_path = Common::FS::GetSudachiPath(Common::FS::SudachiPath::CacheDir) / "game_list" /
+                     "metadata_index.bin";
+    }
+    metadata_index = std::make_unique<GameMetadataIndex>(index_path);
+
     const auto DirEntryReady = [&](GameListDir* game_list_dir) {
         RecordEvent([=](GameList* game_list) { game_list->AddDirEntry(game_list_dir); });
     };
 
     for (UISettings::GameDir& game_dir : game_dirs) {
-        if (stop_requested) {
+        if (stop_source.stop_requested()) {
             break;
         }
 
@@ -480,6 +499,11 @@ void GameListWorker::run() {
         }
     }
 
+    if (UISettings::values.cache_game_list && !stop_source.stop_requested()) {
+        metadata_index->Save();
+    }
+    metadata_index.reset();
+
     RecordEvent([this](GameList* game_list) { game_list->DonePopulating(watch_list); });
     processing_completed.Set();
 }
@@ -3,9 +3,11 @@
 
 #pragma once
 
-#include <atomic>
 #include <deque>
+#include <filesystem>
 #include <memory>
+#include <span>
+#include <stop_token>
 #include <string>
 
 #include <QList>
@@ -22,6 +24,7 @@ class System;
 }
 
 class GameList;
+class GameMetadataIndex;
 class QStandardItem;
 
 namespace FileSys {
@@ -75,6 +78,8 @@ private:
 
     void ScanFileSystem(ScanTarget target, const std::string& dir_path, bool deep_scan,
                         GameListDir* parent_dir);
+    void AddFilesToGameList(std::span<const std::filesystem::path> paths,
+                            GameListDir* parent_dir);
 
     std::shared_ptr<FileSys::VfsFilesystem> vfs;
     FileSys::ManualContentProvider* provider;
@@ -83,11 +88,12 @@ private:
     const PlayTime::PlayTimeManager& play_time_manager;
 
     QStringList watch_list;
+    std::unique_ptr<GameMetadataIndex> metadata_index;
 
     std::mutex lock;
     std::condition_variable cv;
     std::deque<std::function<void(GameList*)>> queued_events;
-    std::atomic_bool stop_requested = false;
+    std::stop_source stop_source;
     Common::Event processing_completed;
 
     Core::System& system;
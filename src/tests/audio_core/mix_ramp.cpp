@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio_core/renderer/command/mix/mix_ramp.h"
+#include "common/common_types.h"
+#include "common/fixed_point.h"
+#include "tests/random_data.h"
+
+namespace {
+using AudioCore::Renderer::ApplyMixRamp;
+using Tests::RandomData;
+
+/// Sample by sample fixed point mix, the reference for the vectorised kernel
+template <size_t Q>
+s32 ReferenceMixRamp(std::span<s32> output, std::span<const s32> input, f32 volume_, f32 ramp_,
+                     u32 sample_count) {
+    Common::FixedPoint<64 - Q, Q> volume{volume_};
+    const Common::FixedPoint<64 - Q, Q> ramp{ramp_};
+    Common::FixedPoint<64 - Q, Q> sample{0};
+    for (u32 i = 0; i < sample_count; i++) {
+        sample = input[i] * volume;
+        output[i] = (output[i] + sample).to_int();
+        volume += ramp;
+    }
+    return sample.to_int();
+}
+
+/// Mostly audio range samples, with one in eight full range ones to exercise wrapping
+std::vector<s32> RandomSamples(std::mt19937& rng, size_t count) {
+    std::vector<s32> samples = RandomData<s32>(rng, count);
+    for (s32& sample : samples) {
+        if (sample % 8 != 0) {
+            sample = static_cast<s16>(sample >> 16);
+        }
+    }
+    return samples;
+}
+
+template <size_t Q>
+void CompareWithReference(std::mt19937& rng, f32 volume, f32 ramp, u32 sample_count) {
+    const std::vector<s32> input = RandomSamples(rng, sample_count);
+    std::vector<s32> output = RandomSamples(rng, sample_count);
+    std::vector<s32> expected = output;
+    const s32 last = ApplyMixRamp<Q>(output, input, volume, ramp, sample_count);
+    const s32 expected_last = ReferenceMixRamp<Q>(expected, input, volume, ramp, sample_count);
+    REQUIRE(output == expected);
+    REQUIRE(last == expected_last);
+}
+} // Anonymous namespace
+
+TEST_CASE("MixRamp[MatchesReference]", "[audio_core]") {
+    static constexpr std::array<f32, 10> VOLUMES{
+        0.0f, 1.0f, 0.5f, -0.75f, 0.123456f, 2.0f, 7.9f, 100.5f, 300.0f, 70000.0f,
+    };
+    static constexpr std::array<u32, 7> SAMPLE_COUNTS{0, 1, 3, 4, 5, 160, 241};
+    std::mt19937 rng(0x3175);
+    for (const u32 sample_count : SAMPLE_COUNTS) {
+        for (const f32 volume : VOLUMES) {
+            for (const f32 target : VOLUMES) {
+                const f32 ramp = sample_count == 0 ? 0.0f : (target - volume) / sample_count;
+                CompareWithReference<15>(rng, volume, ramp, sample_count);
+                CompareWithReference<23>(rng, volume, ramp, sample_count);
+            }
+        }
+    }
+}
+
+TEST_CASE("MixRamp[Benchmark]", "[audio_core][!benchmark]") {
+    constexpr u32 sample_count = 240;
+    constexpr u32 buffer_count = 24;
+    std::mt19937 rng(0xbe9c);
+    const std::vector<s32> input = RandomSamples(rng, sample_count * buffer_count);
+    std::vector<s32> output = RandomSamples(rng, sample_count * buffer_count);
+    const std::span<const s32> input_span{input};
+    const std::span<s32> output_span{output};
+
+    for (const f32 ramp : {0.0f, 0.001f}) {
+        const std::string suffix = std::string(ramp == 0.0f ? "mix" : "mix ramp") + ", " +
+                                   std::to_string(buffer_count) + " buffers";
+        BENCHMARK("ApplyMixRamp " + suffix) {
+            s32 last = 0;
+            for (u32 i = 0; i < buffer_count; i++) {
+                last += ApplyMixRamp<15>(output_span.subspan(i * sample_count, sample_count),
+                                         input_span.subspan(i * sample_count, sample_count),
+                                         0.5f, ramp, sample_count);
+            }
+            return last;
+        };
+        BENCHMARK("Reference " + suffix) {
+            s32 last = 0;
+            for (u32 i = 0; i < buffer_count; i++) {
+                last += ReferenceMixRamp<15>(output_span.subspan(i * sample_count, sample_count),
+                                             input_span.subspan(i * sample_count, sample_count),
+                                             0.5f, ramp, sample_count);
+            }
+            return last;
+        };
+    }
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "audio_core/common/common.h"
+#include "audio_core/renderer/command/resample/resample.h"
+#include "common/common_types.h"
+#include "common/fixed_point.h"
+#include "tests/random_data.h"
+
+namespace {
+using AudioCore::SrcQuality;
+using AudioCore::Renderer::Resample;
+using Fraction = Common::FixedPoint<49, 15>;
+using Tests::RandomData;
+
+constexpr std::array<SrcQuality, 3> QUALITIES{SrcQuality::Low, SrcQuality::Medium,
+                                              SrcQuality::High};
+constexpr std::array<f32, 8> RATIOS{0.25f, 0.5f, 0.6666f, 1.0f, 1.0884f, 1.25f, 1.5f, 2.0f};
+
+/// Resamples one output sample per call, which always takes the scalar path
+std::vector<s32> ResampleOneByOne(std::span<const s16> input, Fraction ratio, Fraction& fraction,
+                                  u32 samples_to_write, SrcQuality quality) {
+    std::vector<s32> output(samples_to_write);
+    size_t read_index = 0;
+    for (u32 i = 0; i < samples_to_write; i++) {
+        const s64 read_advance = (fraction.to_raw() + ratio.to_raw()) >> 15;
+        Resample(std::span(output).subspan(i, 1), input.subspan(read_index), ratio, fraction, 1,
+                 quality);
+        read_index += static_cast<size_t>(read_advance);
+    }
+    return output;
+}
+} // Anonymous namespace
+
+TEST_CASE("Resample[BlocksMatchScalar]", "[audio_core]") {
+    std::mt19937 rng(0x5e5a);
+    for (const SrcQuality quality : QUALITIES) {
+        for (const f32 ratio_value : RATIOS) {
+            for (const u32 samples_to_write : {1U, 3U, 4U, 7U, 160U, 240U}) {
+                const Fraction ratio{ratio_value};
+                const Fraction start_fraction =
+                    Fraction::from_base(static_cast<s64>(rng() % (1U << 15)));
+                // Enough input for the read position plus the widest filter
+                const size_t input_size = samples_to_write * 3 + 16;
+                const std::vector<s16> input = RandomData<s16>(rng, input_size);
+
+                Fraction fraction = start_fraction;
+                std::vector<s32> output(samples_to_write);
+                Resample(output, input, ratio, fraction, samples_to_write, quality);
+
+                Fraction expected_fraction = start_fraction;
+                const std::vector<s32> expected = ResampleOneByOne(
+                    input, ratio, expected_fraction, samples_to_write, quality);
+                REQUIRE(output == expected);
+                REQUIRE(fraction.to_raw() == expected_fraction.to_raw());
+            }
+        }
+    }
+}
+
+TEST_CASE("Resample[Benchmark]", "[audio_core][!benchmark]") {
+    constexpr u32 samples_to_write = 240;
+    constexpr u32 voice_count = 96;
+    const std::vector<s16> input = RandomData<s16>(samples_to_write * 2 + 16, 0xbe9c);
+    std::vector<s32> output(samples_to_write);
+    for (const SrcQuality quality : {SrcQuality::Medium, SrcQuality::High}) {
+        const std::string name = quality == SrcQuality::Medium ? "Medium" : "High";
+        BENCHMARK("Resample " + name + " quality, " + std::to_string(voice_count) + " voices") {
+            Fraction fraction{0};
+            for (u32 voice = 0; voice < voice_count; voice++) {
+                Resample(output, input, Fraction{0.6666f}, fraction, samples_to_write, quality);
+            }
+            return output[0];
+        };
+    }
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/thread_worker.h"
+#include "common/unique_function.h"
+
+namespace {
+constexpr size_t NUM_TASKS = 10000;
+
+struct WorkerState {
+    std::thread::id thread_id = std::this_thread::get_id();
+    size_t tasks_run = 0;
+};
+} // Anonymous namespace
+
+TEST_CASE("ThreadWorker[RunsAllTasks]", "[common]") {
+    Common::ThreadWorker workers(4, "Test");
+    std::atomic<size_t> counter{};
+    for (size_t i = 0; i < NUM_TASKS; ++i) {
+        workers.QueueWork([&counter] { ++counter; });
+    }
+    workers.WaitForRequests();
+    REQUIRE(counter == NUM_TASKS);
+
+    std::vector<Common::UniqueFunction<void>> batch;
+    for (size_t i = 0; i < NUM_TASKS; ++i) {
+        batch.emplace_back([&counter] { ++counter; });
+    }
+    workers.QueueWorkBatch(std::move(batch));
+    workers.WaitForRequests();
+    REQUIRE(counter == NUM_TASKS * 2);
+}
+
+TEST_CASE("ThreadWorker[SingleWorkerKeepsOrder]", "[common]") {
+    Common::ThreadWorker worker(1, "Test");
+    std::vector<size_t> order;
+    for (size_t i = 0; i < NUM_TASKS; ++i) {
+        worker.QueueWork([&order, i] { order.push_back(i); });
+    }
+    worker.WaitForRequests();
+    REQUIRE(order.size() == NUM_TASKS);
+    for (size_t i = 0; i < NUM_TASKS; ++i) {
+        REQUIRE(order[i] == i);
+    }
+}
+
+TEST_CASE("StatefulThreadWorker[PerWorkerState]", "[common]") {
+    std::atomic<size_t> counter{};
+    std::atomic<size_t> foreign_state{};
+    {
+        Common::StatefulThreadWorker<WorkerState> workers(4, "Test", [] { return WorkerState{}; });
+        for (size_t i = 0; i < NUM_TASKS; ++i) {
+            workers.QueueWork([&](WorkerState* state) {
+                if (state->thread_id != std::this_thread::get_id()) {
+                    ++foreign_state;
+                }
+                ++state->tasks_run;
+                ++counter;
+            });
+        }
+        workers.WaitForRequests();
+    }
+    REQUIRE(counter == NUM_TASKS);
+    REQUIRE(foreign_state == 0);
+}
+
+TEST_CASE("ThreadWorker[Benchmark]", "[common][!benchmark]") {
+    for (const size_t num_workers : {1, 2, 4, 8}) {
+        Common::ThreadWorker workers(num_workers, "Benchmark");
+        std::atomic<size_t> counter{};
+        const std::string suffix = std::to_string(NUM_TASKS) + " tasks, " +
+                                   std::to_string(num_workers) + " workers";
+        BENCHMARK("QueueWork " + suffix) {
+            for (size_t i = 0; i < NUM_TASKS; ++i) {
+                workers.QueueWork([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+            }
+            workers.WaitForRequests();
+            return counter.load();
+        };
+        BENCHMARK("QueueWorkBatch " + suffix) {
+            std::vector<Common::UniqueFunction<void>> batch;
+            batch.reserve(NUM_TASKS);
+            for (size_t i = 0; i < NUM_TASKS; ++i) {
+                batch.emplace_back(
+                    [&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+            }
+            workers.QueueWorkBatch(std::move(batch));
+            workers.WaitForRequests();
+            return counter.load();
+        };
+    }
+}
@@ -1,15 +1,21 @@
 // SPDX-FileCopyrightText: 2016 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cstdlib>
 #include <memory>
 #include <optional>
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -50,6 +56,24 @@ u64 TestTimerSpeed(Core::Timing::CoreTiming& core_timing) {
     return end - start;
 }
 
+struct ManualInit final {
+    ManualInit() {
+        core_timing.SetMulticore(false);
+        core_timing.Initialize([]() {});
+    }
+
+    /// Moves the single core clock forward and runs every event that became due
+    void AdvanceBy(std::chrono::nanoseconds ns) {
+        const s64 target = core_timing.GetGlobalTimeNs().count() + ns.count();
+        while (core_timing.GetGlobalTimeNs().count() < target) {
+            core_timing.AddTicks(1000);
+        }
+        core_timing.Advance();
+    }
+
+    Core::Timing::CoreTiming core_timing;
+};
+
 } // Anonymous namespace
 
 TEST_CASE("CoreTiming[BasicOrder]", "[core]") {
@@ -139,3 +163,149 @@ TEST_CASE("CoreTiming[BasicOrderNoPausing]", "[core]") {
     printf("HostTimer No Pausing Timer Time: %.3f %.6f\n", timer_time / 1000.f,
            timer_time / 1000000.f);
 }
+
+TEST_CASE("CoreTiming[ManyEventsOrder]", "[core]") {
+    ManualInit guard;
+    auto& core_timing = guard.core_timing;
+
+    std::vector<s64> fired;
+    std::vector<std::shared_ptr<Core::Timing::EventType>> events;
+    for (size_t i = 0; i < 64; ++i) {
+        events.push_back(Core::Timing::CreateEvent(
+            "event" + std::to_string(i),
+            [&fired](s64 time,
+                     std::chrono::nanoseconds) -> std::optional<std::chrono::nanoseconds> {
+                fired.push_back(time);
+                return std::nullopt;
+            }));
+    }
+
+    // Spread events from a few nanoseconds to seconds away to populate every wheel level
+    std::mt19937_64 rng(0x7173);
+    const s64 start = core_timing.GetGlobalTimeNs().count();
+    std::vector<s64> expected;
+    for (size_t i = 0; i < 20000; ++i) {
+        const s64 delay = static_cast<s64>(rng() % (u64{1} << (4 + rng() % 28)));
+        const size_t type = i % events.size();
+        core_timing.ScheduleEvent(std::chrono::nanoseconds{delay}, events[type]);
+        if (type % 4 != 0) {
+            expected.push_back(start + delay);
+        }
+    }
+    for (size_t type = 0; type < events.size(); type += 4) {
+        core_timing.UnscheduleEvent(events[type]);
+    }
+
+    while (fired.size() < expected.size()) {
+        guard.AdvanceBy(std::chrono::nanoseconds{static_cast<s64>(rng() % 10000000)});
+    }
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(fired == expected);
+    REQUIRE(!core_timing.Advance().has_value());
+}
+
+TEST_CASE("CoreTiming[LoopingEvent]", "[core]") {
+    ManualInit guard;
+    auto& core_timing = guard.core_timing;
+
+    size_t count = 0;
+    const auto looping = Core::Timing::CreateEvent(
+        "looping",
+        [&count](s64, std::chrono::nanoseconds) -> std::optional<std::chrono::nanoseconds> {
+            ++count;
+            return std::nullopt;
+        });
+    core_timing.ScheduleLoopingEvent(std::chrono::microseconds{100},
+                                     std::chrono::microseconds{100}, looping);
+    for (size_t i = 1; i <= 10; ++i) {
+        guard.AdvanceBy(std::chrono::microseconds{100});
+        REQUIRE(count == i);
+    }
+    core_timing.UnscheduleEvent(looping);
+    guard.AdvanceBy(std::chrono::milliseconds{1});
+    REQUIRE(count == 10);
+    REQUIRE(!core_timing.Advance().has_value());
+}
+
+TEST_CASE("CoreTiming[ConcurrentSchedule]", "[core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+    constexpr size_t num_threads = 4;
+    constexpr size_t events_per_thread = 5000;
+
+    std::atomic<size_t> fired{};
+    const auto event = Core::Timing::CreateEvent(
+        "concurrent",
+        [&fired](s64, std::chrono::nanoseconds) -> std::optional<std::chrono::nanoseconds> {
+            ++fired;
+            return std::nullopt;
+        });
+
+    core_timing.SyncPause(false);
+
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&core_timing, &event, i] {
+            for (size_t j = 0; j < events_per_thread; ++j) {
+                const auto delay = std::chrono::nanoseconds{static_cast<s64>((i * 7 + j) % 5000)};
+                core_timing.ScheduleEvent(delay, event);
+            }
+        });
+    }
+    threads.clear();
+
+    while (fired < num_threads * events_per_thread) {
+        std::this_thread::yield();
+    }
+    REQUIRE(fired == num_threads * events_per_thread);
+}
+
+TEST_CASE("CoreTiming[Benchmark]", "[core][!benchmark]") {
+    constexpr size_t num_events = 10000;
+    ManualInit guard;
+    auto& core_timing = guard.core_timing;
+
+    size_t fired = 0;
+    std::vector<std::shared_ptr<Core::Timing::EventType>> events;
+    for (size_t i = 0; i < 256; ++i) {
+        events.push_back(Core::Timing::CreateEvent(
+            "event" + std::to_string(i),
+            [&fired](s64, std::chrono::nanoseconds) -> std::optional<std::chrono::nanoseconds> {
+                ++fired;
+                return std::nullopt;
+            }));
+    }
+    std::mt19937 rng(0xc0de);
+    std::vector<std::chrono::nanoseconds> delays(num_events);
+    for (auto& delay : delays) {
+        delay = std::chrono::nanoseconds{static_cast<s64>(rng() % 100000000)};
+    }
+
+    BENCHMARK("Schedule and unschedule 10000 events") {
+        for (size_t i = 0; i < num_events; ++i) {
+            core_timing.ScheduleEvent(delays[i], events[i % events.size()]);
+        }
+        for (const auto& event : events) {
+            core_timing.UnscheduleEvent(event, Core::Timing::UnscheduleEventType::NoWait);
+        }
+        return core_timing.HasPendingEvents();
+    };
+    BENCHMARK("Reschedule one event of each type 10000 times") {
+        for (size_t i = 0; i < num_events; ++i) {
+            const auto& event = events[i % events.size()];
+            core_timing.UnscheduleEvent(event, Core::Timing::UnscheduleEventType::NoWait);
+            core_timing.ScheduleEvent(delays[i], event);
+        }
+        for (const auto& event : events) {
+            core_timing.UnscheduleEvent(event, Core::Timing::UnscheduleEventType::NoWait);
+        }
+        return core_timing.HasPendingEvents();
+    };
+    BENCHMARK("Schedule and fire 10000 events") {
+        for (size_t i = 0; i < num_events; ++i) {
+            core_timing.ScheduleEvent(delays[i], events[i % events.size()]);
+        }
+        guard.AdvanceBy(std::chrono::milliseconds{100});
+        return fired;
+    };
+}
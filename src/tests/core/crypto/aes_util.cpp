@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/hex_util.h"
+#include "common/literals.h"
+#include "core/crypto/aes_util.h"
+#include "core/crypto/key_manager.h"
+#include "core/file_sys/fssystem/fssystem_aes_ctr_storage.h"
+#include "core/file_sys/fssystem/fssystem_aes_xts_storage.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+#include "tests/random_data.h"
+
+namespace {
+using namespace Common::Literals;
+using Core::Crypto::AESCipher;
+using Core::Crypto::Key128;
+using Core::Crypto::Key256;
+using Core::Crypto::Mode;
+using Core::Crypto::Op;
+using Tests::RandomData;
+
+// NIST SP 800-38A, F.1.1 and F.5.1
+constexpr std::string_view NistKey = "2b7e151628aed2a6abf7158809cf4f3c";
+constexpr std::string_view NistCounter = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+constexpr std::string_view NistPlaintext =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+constexpr std::string_view NistEcbCiphertext =
+    "3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf"
+    "43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4";
+constexpr std::string_view NistCtrCiphertext =
+    "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+    "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee";
+} // Anonymous namespace
+
+TEST_CASE("AESCipher[ECB]", "[core]") {
+    AESCipher<Key128> cipher(Common::HexStringToArray<16>(NistKey), Mode::ECB);
+    const std::vector<u8> plaintext = Common::HexStringToVector(NistPlaintext, false);
+    const std::vector<u8> ciphertext = Common::HexStringToVector(NistEcbCiphertext, false);
+
+    std::vector<u8> output(plaintext.size());
+    cipher.Transcode(plaintext.data(), plaintext.size(), output.data(), Op::Encrypt);
+    REQUIRE(output == ciphertext);
+    cipher.Transcode(ciphertext.data(), ciphertext.size(), output.data(), Op::Decrypt);
+    REQUIRE(output == plaintext);
+}
+
+TEST_CASE("AESCipher[CTR]", "[core]") {
+    AESCipher<Key128> cipher(Common::HexStringToArray<16>(NistKey), Mode::CTR);
+    const std::vector<u8> plaintext = Common::HexStringToVector(NistPlaintext, false);
+    const std::vector<u8> ciphertext = Common::HexStringToVector(NistCtrCiphertext, false);
+
+    std::vector<u8> output(plaintext.size());
+    cipher.SetIV(Common::HexStringToVector(NistCounter, false));
+    cipher.Transcode(plaintext.data(), plaintext.size(), output.data(), Op::Decrypt);
+    REQUIRE(output == ciphertext);
+
+    // A partial block consumes its counter value, the next call starts on the following block
+    std::fill(output.begin(), output.end(), u8{0});
+    cipher.SetIV(Common::HexStringToVector(NistCounter, false));
+    cipher.Transcode(plaintext.data(), 20, output.data(), Op::Decrypt);
+    cipher.Transcode(plaintext.data() + 32, 32, output.data() + 32, Op::Decrypt);
+    REQUIRE(std::equal(output.begin(), output.begin() + 20, ciphertext.begin()));
+    REQUIRE(std::equal(output.begin() + 32, output.end(), ciphertext.begin() + 32));
+}
+
+TEST_CASE("AESCipher[XTS]", "[core]") {
+    // IEEE 1619-2007, vector 2
+    AESCipher<Key256> cipher(
+        Common::HexStringToArray<32>(
+            "1111111111111111111111111111111122222222222222222222222222222222"),
+        Mode::XTS);
+    const std::vector<u8> plaintext(32, 0x44);
+    const std::vector<u8> ciphertext = Common::HexStringToVector(
+        "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0", false);
+
+    std::vector<u8> output(plaintext.size());
+    cipher.SetIV(Common::HexStringToVector("33333333330000000000000000000000", false));
+    cipher.Transcode(plaintext.data(), plaintext.size(), output.data(), Op::Encrypt);
+    REQUIRE(output == ciphertext);
+    cipher.Transcode(ciphertext.data(), ciphertext.size(), output.data(), Op::Decrypt);
+    REQUIRE(output == plaintext);
+
+    // Sectors use big endian tweaks, check a round trip over many blocks per sector
+    const std::vector<u8> data = RandomData(0x4000, 0x7e5);
+    std::vector<u8> encrypted(data.size());
+    std::vector<u8> decrypted(data.size());
+    cipher.XTSTranscode(data.data(), data.size(), encrypted.data(), 3, 0x200, Op::Encrypt);
+    cipher.XTSTranscode(encrypted.data(), encrypted.size(), decrypted.data(), 3, 0x200,
+                        Op::Decrypt);
+    REQUIRE(encrypted != data);
+    REQUIRE(decrypted == data);
+}
+
+TEST_CASE("AESCipher[Benchmark]", "[core][!benchmark]") {
+    // A synthetic encrypted NCA section read through the storages used for RomFS accesses
+    constexpr std::size_t section_size = 16_MiB;
+    const auto key = RandomData(0x20, 0xae5);
+    const auto iv = RandomData(0x10, 0x1f);
+    const auto base = std::make_shared<FileSys::VectorVfsFile>(RandomData(section_size, 0x5ec));
+    std::vector<u8> buffer(section_size);
+
+    const FileSys::AesCtrStorage ctr_storage(base, key.data(), FileSys::AesCtrStorage::KeySize,
+                                             iv.data(), FileSys::AesCtrStorage::IvSize);
+    BENCHMARK("AES-CTR storage 16 MiB") {
+        return ctr_storage.Read(buffer.data(), buffer.size(), 0);
+    };
+
+    const FileSys::AesXtsStorage xts_storage(base, key.data(), key.data() + 0x10,
+                                             FileSys::AesXtsStorage::KeySize, iv.data(),
+                                             FileSys::AesXtsStorage::IvSize, 0x4000);
+    BENCHMARK("AES-XTS storage 16 MiB") {
+        return xts_storage.Read(buffer.data(), buffer.size(), 0);
+    };
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/hex_util.h"
+#include "common/literals.h"
+#include "core/crypto/sha_util.h"
+#include "tests/random_data.h"
+
+namespace {
+using namespace Common::Literals;
+using Core::Crypto::SHA256;
+using Tests::RandomData;
+
+std::span<const u8> AsBytes(std::string_view str) {
+    return {reinterpret_cast<const u8*>(str.data()), str.size()};
+}
+
+std::string HashString(std::span<const u8> data) {
+    return Common::HexToString(SHA256::Hash(data), false);
+}
+} // Anonymous namespace
+
+TEST_CASE("SHA256[KnownAnswers]", "[core]") {
+    REQUIRE(HashString({}) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    REQUIRE(HashString(AsBytes("abc")) ==
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    REQUIRE(HashString(AsBytes("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    const std::vector<u8> million_a(1000000, 'a');
+    REQUIRE(HashString(million_a) ==
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_CASE("SHA256[SplitUpdates]", "[core]") {
+    std::mt19937 rng(0x5a256);
+    const std::vector<u8> data = RandomData(rng, 0x10000);
+    // Every length around the padding boundaries, fed in random pieces
+    for (std::size_t size = 0; size < 300; ++size) {
+        const auto input = std::span(data).first(size);
+        SHA256 sha;
+        std::size_t offset = 0;
+        while (offset < size) {
+            const std::size_t piece = std::min<std::size_t>(size - offset, rng() % 80);
+            sha.Update(input.subspan(offset, piece));
+            offset += piece;
+        }
+        REQUIRE(sha.Finish() == SHA256::Hash(input));
+    }
+}
+
+TEST_CASE("SHA256[Benchmark]", "[core][!benchmark]") {
+    const std::vector<u8> data = RandomData(64_MiB, 0x5a);
+    BENCHMARK("SHA256 64 MiB") {
+        return SHA256::Hash(data);
+    };
+}
@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/file_sys/fssystem/fssystem_compressed_storage.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+#include "tests/random_data.h"
+
+namespace {
+using FileSys::CompressedBlockCache;
+using FileSys::CompressedStorage;
+using FileSys::CompressionType;
+
+constexpr size_t EntrySize = 0x100;
+
+std::vector<char> BlockData(s64 virtual_offset, size_t size) {
+    std::vector<char> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<char>(virtual_offset / EntrySize * 0x11 + i);
+    }
+    return data;
+}
+
+void Store(CompressedBlockCache& cache, s64 virtual_offset, size_t size = EntrySize) {
+    const auto data = BlockData(virtual_offset, size);
+    cache.Store(virtual_offset, data.data(), data.size());
+}
+
+bool IsCached(CompressedBlockCache& cache, s64 virtual_offset, size_t skip_size = 0,
+              size_t size = EntrySize) {
+    std::vector<char> buffer(size);
+    if (!cache.Read(virtual_offset, skip_size, buffer.data(), buffer.size())) {
+        return false;
+    }
+    const auto data = BlockData(virtual_offset, skip_size + size);
+    REQUIRE(std::equal(buffer.begin(), buffer.end(), data.begin() + skip_size));
+    return true;
+}
+
+// Stand-in compression that flips every bit, counting how often blocks are decompressed
+size_t num_decompressions = 0;
+
+Result Decompress(void* dst, size_t dst_size, const void* src, size_t src_size) {
+    REQUIRE(dst_size == src_size);
+    ++num_decompressions;
+    for (size_t i = 0; i < dst_size; ++i) {
+        static_cast<u8*>(dst)[i] = static_cast<u8>(~static_cast<const u8*>(src)[i]);
+    }
+    return ResultSuccess;
+}
+
+FileSys::DecompressorFunction GetDecompressor(CompressionType type) {
+    return type == CompressionType::Lz4 ? Decompress : nullptr;
+}
+
+// A small block compressed, one large block compressed and cached as fragments, another small
+// block and an uncompressed tail
+constexpr std::array<CompressedStorage::Entry, 4> Entries{{
+    {0x0000, 0x0000, CompressionType::Lz4, 0x1000},
+    {0x1000, 0x1000, CompressionType::Lz4, 0x4000},
+    {0x5000, 0x5000, CompressionType::Lz4, 0x1000},
+    {0x6000, 0x6000, CompressionType::None, 0x2000},
+}};
+constexpr s64 StorageSize = 0x8000;
+
+struct SyntheticStorage {
+    explicit SyntheticStorage(s32 max_cache_entries) : data(Tests::RandomData(StorageSize, 0xc3)) {
+        std::vector<u8> physical = data;
+        for (const auto& entry : Entries) {
+            if (entry.compression_type == CompressionType::None) {
+                continue;
+            }
+            const auto begin = physical.begin() + entry.phys_offset;
+            std::transform(begin, begin + entry.phys_size, begin,
+                           [](u8 value) { return static_cast<u8>(~value); });
+        }
+
+        // Bucket tree with a single entry set
+        std::vector<u8> node(CompressedStorage::NodeSize);
+        const FileSys::BucketTree::NodeHeader node_header{0, 1, StorageSize};
+        std::memcpy(node.data(), &node_header, sizeof(node_header));
+        const s64 entry_set_offset = 0;
+        std::memcpy(node.data() + sizeof(node_header), &entry_set_offset, sizeof(s64));
+
+        std::vector<u8> entry_set(CompressedStorage::NodeSize);
+        const FileSys::BucketTree::NodeHeader entry_set_header{0, Entries.size(), StorageSize};
+        std::memcpy(entry_set.data(), &entry_set_header, sizeof(entry_set_header));
+        std::memcpy(entry_set.data() + sizeof(entry_set_header), Entries.data(),
+                    sizeof(Entries));
+
+        REQUIRE(R_SUCCEEDED(storage.Initialize(
+            std::make_shared<FileSys::VectorVfsFile>(std::move(physical)),
+            std::make_shared<FileSys::VectorVfsFile>(std::move(node)),
+            std::make_shared<FileSys::VectorVfsFile>(std::move(entry_set)), Entries.size(),
+            0x4000, 0x10000, GetDecompressor, 0x1000, 0x1000, max_cache_entries)));
+    }
+
+    // Reads a range, returning how many blocks were decompressed for it
+    size_t Read(s64 offset, size_t size) {
+        std::vector<u8> buffer(size);
+        num_decompressions = 0;
+        REQUIRE(storage.Read(buffer.data(), size, offset) == size);
+        REQUIRE(std::equal(buffer.begin(), buffer.end(), data.begin() + offset));
+        return num_decompressions;
+    }
+
+    std::vector<u8> data;
+    CompressedStorage storage;
+};
+} // Anonymous namespace
+
+TEST_CASE("CompressedBlockCache[HitMiss]", "[core]") {
+    CompressedBlockCache cache;
+    cache.Initialize(EntrySize, 2);
+    REQUIRE(cache.GetEntrySize() == EntrySize);
+    REQUIRE(!IsCached(cache, 0));
+
+    Store(cache, 0);
+    Store(cache, 0x1000, 0x80);
+    REQUIRE(IsCached(cache, 0));
+    REQUIRE(IsCached(cache, 0, 0x40, 0xC0));
+    REQUIRE(IsCached(cache, 0x1000, 0, 0x80));
+    REQUIRE(IsCached(cache, 0x1000, 0x7F, 1));
+
+    // Reads past the stored data, or of offsets inside a cached block, are misses
+    REQUIRE(!IsCached(cache, 0x1000, 0, 0x81));
+    REQUIRE(!IsCached(cache, 0x1000, 0x40, 0x41));
+    REQUIRE(!IsCached(cache, 0x40, 0, 0x10));
+    REQUIRE(!IsCached(cache, 0x2000));
+}
+
+TEST_CASE("CompressedBlockCache[Eviction]", "[core]") {
+    CompressedBlockCache cache;
+    cache.Initialize(EntrySize, 3);
+    Store(cache, 0);
+    Store(cache, 0x100);
+    Store(cache, 0x200);
+
+    // Storing into a full cache evicts the least recently used entry
+    REQUIRE(IsCached(cache, 0));
+    Store(cache, 0x300);
+    REQUIRE(!IsCached(cache, 0x100));
+    REQUIRE(IsCached(cache, 0));
+    REQUIRE(IsCached(cache, 0x200));
+    REQUIRE(IsCached(cache, 0x300));
+
+    // Storing an offset again replaces its entry instead of evicting another one
+    Store(cache, 0x200, 0x80);
+    REQUIRE(IsCached(cache, 0x200, 0, 0x80));
+    REQUIRE(!IsCached(cache, 0x200));
+    REQUIRE(IsCached(cache, 0));
+    REQUIRE(IsCached(cache, 0x300));
+
+    Store(cache, 0x400);
+    REQUIRE(!IsCached(cache, 0x200, 0, 0x80));
+    REQUIRE(IsCached(cache, 0));
+    REQUIRE(IsCached(cache, 0x300));
+    REQUIRE(IsCached(cache, 0x400));
+}
+
+TEST_CASE("CompressedBlockCache[Disabled]", "[core]") {
+    // A cache without an entry size never holds anything
+    CompressedBlockCache cache;
+    cache.Initialize(0, 4);
+    Store(cache, 0, 0);
+    REQUIRE(!IsCached(cache, 0, 0, 0));
+    REQUIRE(!IsCached(cache, 0, 0, 1));
+}
+
+TEST_CASE("CompressedStorage[UnalignedReads]", "[core]") {
+    SyntheticStorage synthetic(8);
+
+    // The unaligned head and tail blocks are decompressed, then kept whole or as fragments
+    REQUIRE(synthetic.Read(0x800, 0x1000) == 2);
+    REQUIRE(synthetic.Read(0x800, 0x1000) == 0);
+    REQUIRE(synthetic.Read(0x123, 0x9) == 0);
+
+    // The head is served from the fragments of the large block
+    REQUIRE(synthetic.Read(0x2801, 0x2a00) == 1);
+    REQUIRE(synthetic.Read(0x4ff0, 0x20) == 0);
+
+    // Uncompressed data does not go through the cache
+    REQUIRE(synthetic.Read(0x5800, 0x1000) == 0);
+    REQUIRE(synthetic.Read(0x6001, 0x1fff) == 0);
+
+    // Blocks the read covers entirely are decompressed straight into the destination
+    REQUIRE(synthetic.Read(0x100, StorageSize - 0x200) == 2);
+    REQUIRE(synthetic.Read(0, StorageSize) == 3);
+}
+
+TEST_CASE("CompressedStorage[FragmentEviction]", "[core]") {
+    // Only the last two fragments of the large block fit in the fragment cache
+    SyntheticStorage synthetic(2);
+    REQUIRE(synthetic.Read(0x1800, 0x100) == 1);
+    REQUIRE(synthetic.Read(0x4000, 0x800) == 0);
+    REQUIRE(synthetic.Read(0x3f00, 0x1000) == 0);
+
+    // Reads needing an evicted fragment decompress the block again
+    REQUIRE(synthetic.Read(0x2ff0, 0x20) == 1);
+    REQUIRE(synthetic.Read(0x1800, 0x100) == 1);
+}
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "core/file_sys/nca_metadata.h"
+#include "core/file_sys/registered_cache.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+constexpr u64 TitleId = 0x0100000000010000;
+constexpr u32 TitleVersion = 0x10000;
+
+// Every byte is the same, so the byte order of the file name does not matter
+constexpr FileSys::NcaID MetaNcaId{0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                   0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11};
+
+template <typename T>
+void Append(std::vector<u8>& data, const T& value) {
+    const auto* const bytes = reinterpret_cast<const u8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+std::vector<u8> MakeCnmt() {
+    FileSys::CNMTHeader header{};
+    header.title_id = TitleId;
+    header.title_version = TitleVersion;
+    header.type = FileSys::TitleType::Application;
+    header.table_offset = sizeof(FileSys::OptionalHeader);
+
+    std::vector<u8> cnmt;
+    Append(cnmt, header);
+    Append(cnmt, FileSys::OptionalHeader{});
+    return cnmt;
+}
+
+// Writes an index that already knows the meta NCA, in the layout RegisteredCache saves it with
+void WriteIndex(const std::filesystem::path& path, const std::string& dir_path, u64 nca_size) {
+    const std::vector<u8> cnmt = MakeCnmt();
+    std::vector<u8> data;
+    Append(data, Common::MakeMagic('R', 'C', 'I', 'X'));
+    Append(data, u32{1});
+    Append(data, u64{dir_path.size()});
+    data.insert(data.end(), dir_path.begin(), dir_path.end());
+    Append(data, u64{1});
+    Append(data, MetaNcaId);
+    Append(data, nca_size);
+    Append(data, TitleId);
+    Append(data, u64{cnmt.size()});
+    data.insert(data.end(), cnmt.begin(), cnmt.end());
+
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    REQUIRE(file.WriteSpan(std::span<const u8>(data)) == data.size());
+}
+} // Anonymous namespace
+
+TEST_CASE("RegisteredCache[IndexInvalidatedBySize]", "[core]") {
+    const auto index_path =
+        std::filesystem::temp_directory_path() / "sudachi_registered_cache_index.bin";
+
+    // The NCA itself does not parse, so its title is only known through the index
+    const auto nca = std::make_shared<FileSys::VectorVfsFile>(
+        std::vector<u8>(0x4000), "11111111111111111111111111111111.nca");
+    const auto dir = std::make_shared<FileSys::VectorVfsDirectory>(
+        std::vector<FileSys::VirtualFile>{nca}, std::vector<FileSys::VirtualDir>{}, "registered");
+    WriteIndex(index_path, dir->GetFullPath(), nca->GetSize());
+
+    FileSys::RegisteredCache cache(dir, index_path);
+    REQUIRE(cache.GetEntryVersion(TitleId) == TitleVersion);
+    REQUIRE(cache.HasEntry(TitleId, FileSys::ContentRecordType::Meta));
+
+    // Refreshing with an unchanged file keeps using the index
+    cache.Refresh();
+    REQUIRE(cache.GetEntryVersion(TitleId) == TitleVersion);
+
+    // Once the size changes, the NCA is parsed again and dropped as it is not valid
+    REQUIRE(nca->Resize(0x5000));
+    cache.Refresh();
+    REQUIRE(!cache.GetEntryVersion(TitleId).has_value());
+    REQUIRE(!cache.HasEntry(TitleId, FileSys::ContentRecordType::Meta));
+
+    // The saved index no longer has the entry, even if the file gets its old size back
+    REQUIRE(nca->Resize(0x4000));
+    FileSys::RegisteredCache reloaded(dir, index_path);
+    REQUIRE(!reloaded.GetEntryVersion(TitleId).has_value());
+
+    void(Common::FS::RemoveFile(index_path));
+}
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/file_sys/romfs.h"
+#include "core/file_sys/vfs/vfs_layered.h"
+#include "core/file_sys/vfs/vfs_static.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+using namespace FileSys;
+
+std::vector<u8> FileData(const std::string& name, std::size_t size) {
+    std::vector<u8> data(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<u8>(name[i % name.size()] + i);
+    }
+    return data;
+}
+
+VirtualFile MakeFile(const std::string& name, std::size_t size) {
+    return std::make_shared<VectorVfsFile>(FileData(name, size), name);
+}
+
+VirtualDir MakeDir(std::string name, std::vector<VirtualFile> files,
+                   std::vector<VirtualDir> dirs = {}) {
+    return std::make_shared<VectorVfsDirectory>(std::move(files), std::move(dirs),
+                                                std::move(name));
+}
+
+// A directory tree with dirs subdirectories holding files files each, of which only the sizes are
+// known, like the extracted RomFS of a large game
+VirtualDir MakeTree(int dirs, int files) {
+    std::vector<VirtualDir> subdirs;
+    for (int d = 0; d < dirs; ++d) {
+        std::vector<VirtualFile> subdir_files;
+        for (int f = 0; f < files; ++f) {
+            subdir_files.push_back(std::make_shared<StaticVfsFile>(
+                static_cast<u8>(f), 0x1000 + f, "file_" + std::to_string(f) + ".bfres"));
+        }
+        subdirs.push_back(MakeDir("dir_" + std::to_string(d), std::move(subdir_files)));
+    }
+    return MakeDir("romfs", {}, std::move(subdirs));
+}
+} // Anonymous namespace
+
+TEST_CASE("RomFS[LayeredBuild]", "[core]") {
+    const auto base =
+        MakeDir("romfs", {MakeFile("a.bin", 0x123), MakeFile("b.bin", 0x2000)},
+                {MakeDir("data", {MakeFile("c.bin", 0x10), MakeFile("removed.bin", 0x40)})});
+    const auto mod = MakeDir("romfs", {MakeFile("b.bin", 0x345), MakeFile("new.bin", 0x77)});
+
+    // Patch four bytes at 0x8 of a.bin and remove data/removed.bin
+    const std::vector<u8> ips{'P', 'A', 'T', 'C', 'H', 0x00, 0x00, 0x08, 0x00, 0x04,
+                              0xde, 0xad, 0xbe, 0xef, 'E', 'O',  'F'};
+    const auto ext =
+        MakeDir("romfs_ext", {std::make_shared<VectorVfsFile>(ips, "a.bin.ips")},
+                {MakeDir("data", {std::make_shared<VectorVfsFile>(std::vector<u8>{},
+                                                                  "removed.bin.stub")})});
+
+    const auto base_romfs = ExtractRomFS(CreateRomFS(base));
+    const auto packed =
+        CreateRomFS(LayeredVfsDirectory::MakeLayeredDirectory({mod, base_romfs}), ext);
+    REQUIRE(packed != nullptr);
+    const auto romfs = ExtractRomFS(packed);
+    REQUIRE(romfs != nullptr);
+
+    auto patched = FileData("a.bin", 0x123);
+    std::copy(ips.begin() + 10, ips.begin() + 14, patched.begin() + 8);
+    REQUIRE(romfs->GetFile("a.bin")->ReadAllBytes() == patched);
+    REQUIRE(romfs->GetFile("b.bin")->ReadAllBytes() == FileData("b.bin", 0x345));
+    REQUIRE(romfs->GetFile("new.bin")->ReadAllBytes() == FileData("new.bin", 0x77));
+
+    const auto data = romfs->GetSubdirectory("data");
+    REQUIRE(data != nullptr);
+    REQUIRE(data->GetFile("c.bin")->ReadAllBytes() == FileData("c.bin", 0x10));
+    REQUIRE(data->GetFile("removed.bin") == nullptr);
+}
+
+TEST_CASE("RomFS[Benchmark]", "[core][!benchmark]") {
+    const auto base = ExtractRomFS(CreateRomFS(MakeTree(200, 500)));
+    const auto mod = MakeTree(20, 500);
+
+    BENCHMARK("Build layered RomFS with 100000 files") {
+        return CreateRomFS(LayeredVfsDirectory::MakeLayeredDirectory({mod, base}));
+    };
+    BENCHMARK("Build and mount layered RomFS with 100000 files") {
+        return ExtractRomFS(CreateRomFS(LayeredVfsDirectory::MakeLayeredDirectory({mod, base})));
+    };
+}
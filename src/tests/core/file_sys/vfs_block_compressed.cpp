@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/literals.h"
+#include "common/zstd_compression.h"
+#include "core/file_sys/vfs/vfs_block_compressed.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+#include "core/loader/loader.h"
+
+namespace {
+using namespace Common::Literals;
+using FileSys::BlockCompressedHeader;
+using FileSys::BlockCompressedVfsFile;
+
+// Alternates incompressible and compressible runs so both block encodings are exercised
+std::vector<u8> MakeImage(std::size_t size, u32 seed) {
+    std::mt19937 rng(seed);
+    std::vector<u8> data(size);
+    for (std::size_t offset = 0; offset < size; offset += 0x3000) {
+        const bool random = (rng() & 1) != 0;
+        const std::size_t run_end = std::min(size, offset + 0x3000);
+        for (std::size_t i = offset; i < run_end; ++i) {
+            data[i] = random ? static_cast<u8>(rng()) : static_cast<u8>(i / 0x100);
+        }
+    }
+    return data;
+}
+
+std::vector<u8> Compress(std::span<const u8> data, u8 block_size_exponent) {
+    const std::size_t block_size = std::size_t{1} << block_size_exponent;
+    const u32 num_blocks = static_cast<u32>((data.size() + block_size - 1) / block_size);
+
+    BlockCompressedHeader header{};
+    header.magic = BlockCompressedVfsFile::Magic;
+    header.version = BlockCompressedVfsFile::Version;
+    header.compression_type = BlockCompressedVfsFile::CompressionTypeZstd;
+    header.block_size_exponent = block_size_exponent;
+    header.num_blocks = num_blocks;
+    header.decompressed_size = data.size();
+
+    std::vector<u32_le> sizes;
+    std::vector<u8> blocks;
+    for (u32 i = 0; i < num_blocks; ++i) {
+        const auto block = data.subspan(i * block_size, std::min(block_size, data.size() -
+                                                                                 i * block_size));
+        auto compressed = Common::Compression::CompressDataZSTDDefault(block.data(), block.size());
+        if (compressed.size() >= block.size()) {
+            compressed.assign(block.begin(), block.end());
+        }
+        sizes.push_back(static_cast<u32>(compressed.size()));
+        blocks.insert(blocks.end(), compressed.begin(), compressed.end());
+    }
+
+    std::vector<u8> image(sizeof(header) + sizes.size() * sizeof(u32));
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + sizeof(header), sizes.data(), sizes.size() * sizeof(u32));
+    image.insert(image.end(), blocks.begin(), blocks.end());
+    return image;
+}
+
+FileSys::VirtualFile MakeFile(std::vector<u8> data) {
+    return std::make_shared<FileSys::VectorVfsFile>(std::move(data), "image.nsp.zblk");
+}
+} // Anonymous namespace
+
+TEST_CASE("BlockCompressedVfsFile[Reads]", "[core]") {
+    const std::vector<u8> data = MakeImage(1_MiB + 0x1234, 0xb10c);
+    const auto file = BlockCompressedVfsFile::Open(MakeFile(Compress(data, 14)));
+    REQUIRE(file != nullptr);
+    REQUIRE(file->GetSize() == data.size());
+    REQUIRE(file->GetName() == "image.nsp");
+    REQUIRE(file->ReadAllBytes() == data);
+
+    // Random reads of all sizes, including ones crossing many blocks and the end of the image
+    std::mt19937 rng(0x5eed);
+    std::vector<u8> buffer(0x30000);
+    for (int i = 0; i < 512; ++i) {
+        const std::size_t offset = rng() % (data.size() + 0x100);
+        const std::size_t length = rng() % buffer.size();
+        const std::size_t expected = offset >= data.size() ? 0
+                                                           : std::min(length, data.size() - offset);
+        REQUIRE(file->Read(buffer.data(), length, offset) == expected);
+        REQUIRE(std::equal(buffer.begin(), buffer.begin() + expected, data.begin() + offset));
+    }
+}
+
+TEST_CASE("BlockCompressedVfsFile[Invalid]", "[core]") {
+    std::vector<u8> data(0x20000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(i / 0x100);
+    }
+    REQUIRE(BlockCompressedVfsFile::Open(MakeFile(data)) == nullptr);
+
+    // A decompressed size whose block count wraps around to the empty table
+    std::vector<u8> image = Compress(data, 14);
+    BlockCompressedHeader header{};
+    std::memcpy(&header, image.data(), sizeof(header));
+    header.num_blocks = 0;
+    header.decompressed_size = ~u64{0} - 0x100;
+    std::vector<u8> wrapped(sizeof(header));
+    std::memcpy(wrapped.data(), &header, sizeof(header));
+    REQUIRE(BlockCompressedVfsFile::Open(MakeFile(std::move(wrapped))) == nullptr);
+
+    std::vector<u8> truncated(image.begin(), image.end() - 1);
+    REQUIRE(BlockCompressedVfsFile::Open(MakeFile(std::move(truncated))) == nullptr);
+
+    // A corrupted block fails the reads reaching it
+    const std::size_t first_block = sizeof(BlockCompressedHeader) + 8 * sizeof(u32);
+    std::fill_n(image.begin() + first_block, 0x10, u8{0xff});
+    const auto file = BlockCompressedVfsFile::Open(MakeFile(std::move(image)));
+    REQUIRE(file != nullptr);
+    std::vector<u8> buffer(0x10);
+    REQUIRE(file->Read(buffer.data(), buffer.size(), 0) == 0);
+    REQUIRE(file->Read(buffer.data(), buffer.size(), 0x4000) == buffer.size());
+}
+
+TEST_CASE("BlockCompressedVfsFile[IdentifyFile]", "[core]") {
+    std::vector<u8> nro(0x10000);
+    const u32 magic = Common::MakeMagic('N', 'R', 'O', '0');
+    std::memcpy(nro.data() + 0x10, &magic, sizeof(magic));
+    REQUIRE(Loader::IdentifyFile(MakeFile(Compress(nro, 14))) == Loader::FileType::NRO);
+}
+
+TEST_CASE("BlockCompressedVfsFile[Benchmark]", "[core][!benchmark]") {
+    const std::vector<u8> data = MakeImage(64_MiB, 0xbe7c);
+    const auto file = BlockCompressedVfsFile::Open(MakeFile(Compress(data, 16)));
+    REQUIRE(file != nullptr);
+    std::vector<u8> buffer(0x40000);
+
+    BENCHMARK("Sequential 256 KiB reads") {
+        std::size_t total = 0;
+        for (std::size_t offset = 0; offset < data.size(); offset += buffer.size()) {
+            total += file->Read(buffer.data(), buffer.size(), offset);
+        }
+        return total;
+    };
+
+    // RomFS streaming reads small pieces of a handful of files at scattered offsets
+    BENCHMARK("Random 4 KiB reads") {
+        std::mt19937 rng(0x10f5);
+        std::size_t total = 0;
+        for (int i = 0; i < 4096; ++i) {
+            const std::size_t offset = (rng() % 64) * 1_MiB + (rng() % 16) * 0x1000;
+            total += file->Read(buffer.data(), 0x1000, offset);
+        }
+        return total;
+    };
+}
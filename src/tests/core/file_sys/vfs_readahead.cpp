@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/literals.h"
+#include "core/file_sys/fssystem/fssystem_aes_ctr_storage.h"
+#include "core/file_sys/vfs/vfs_readahead.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+#include "tests/random_data.h"
+
+namespace {
+using namespace Common::Literals;
+using Tests::RandomData;
+
+// Holds prefetch sized reads until it is opened, so tests control when the pool makes progress
+class GatedVfsFile : public FileSys::VectorVfsFile {
+public:
+    using VectorVfsFile::VectorVfsFile;
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        if (length == FileSys::ReadAheadVfsFile::ChunkSize) {
+            std::unique_lock lk{mutex};
+            ++chunk_reads;
+            opened.wait(lk, [this] { return is_open; });
+        }
+        return VectorVfsFile::Read(data, length, offset);
+    }
+
+    void Open() {
+        {
+            std::scoped_lock lk{mutex};
+            is_open = true;
+        }
+        opened.notify_all();
+    }
+
+    std::size_t ChunkReads() const {
+        std::scoped_lock lk{mutex};
+        return chunk_reads;
+    }
+
+private:
+    mutable std::mutex mutex;
+    mutable std::condition_variable opened;
+    mutable std::size_t chunk_reads{};
+    bool is_open{};
+};
+
+// Reads a file from start to end the way games stream assets
+std::size_t StreamFile(const FileSys::VirtualFile& file, std::vector<u8>& out,
+                       std::size_t read_size) {
+    std::size_t total = 0;
+    for (std::size_t offset = 0; offset < file->GetSize(); offset += read_size) {
+        total += file->Read(out.data() + offset, std::min(read_size, out.size() - offset), offset);
+    }
+    return total;
+}
+
+// Adds a fixed latency to every read, like a storage device would
+class SlowVfsFile : public FileSys::VectorVfsFile {
+public:
+    using VectorVfsFile::VectorVfsFile;
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        return VectorVfsFile::Read(data, length, offset);
+    }
+};
+} // Anonymous namespace
+
+TEST_CASE("ReadAheadVfsFile[Reads]", "[core]") {
+    const std::vector<u8> data = RandomData(4_MiB + 0x1234, 0x4ead);
+    const auto file = std::make_shared<FileSys::ReadAheadVfsFile>(
+        std::make_shared<FileSys::VectorVfsFile>(data));
+    REQUIRE(file->GetSize() == data.size());
+
+    // Sequential streams with read sizes that do not line up with the prefetched chunks
+    for (const std::size_t read_size : {0x200, 0x3000, 0x10000, 0x65432}) {
+        std::vector<u8> out(data.size());
+        REQUIRE(StreamFile(file, out, read_size) == data.size());
+        REQUIRE(out == data);
+    }
+
+    // Streams interrupted by seeks
+    std::mt19937 rng(0x5eed);
+    std::vector<u8> buffer(0x9000);
+    std::size_t offset = 0;
+    for (int i = 0; i < 2000; ++i) {
+        if (rng() % 16 == 0) {
+            offset = rng() % (data.size() + 0x100);
+        }
+        const std::size_t length = 1 + rng() % buffer.size();
+        const std::size_t expected =
+            offset >= data.size() ? 0 : std::min(length, data.size() - offset);
+        REQUIRE(file->Read(buffer.data(), length, offset) == expected);
+        REQUIRE(std::equal(buffer.begin(), buffer.begin() + expected, data.begin() + offset));
+        offset += length;
+    }
+}
+
+TEST_CASE("ReadAheadVfsFile[Cancel]", "[core]") {
+    const std::vector<u8> data = RandomData(4_MiB, 0xca9c);
+    const auto base = std::make_shared<GatedVfsFile>(data);
+    const auto file = std::make_shared<FileSys::ReadAheadVfsFile>(base);
+
+    // Two sequential reads queue the chunks that follow, then an empty read seeks elsewhere
+    std::vector<u8> buffer(0x1000);
+    REQUIRE(file->Read(buffer.data(), buffer.size(), 0) == buffer.size());
+    REQUIRE(file->Read(buffer.data(), buffer.size(), buffer.size()) == buffer.size());
+    REQUIRE(file->Read(buffer.data(), 0, 3_MiB) == 0);
+    base->Open();
+
+    // Waits for the chunk that may already have been reading, the others must never be read
+    REQUIRE(file->Read(buffer.data(), buffer.size(), 3_MiB) == buffer.size());
+    REQUIRE(std::equal(buffer.begin(), buffer.end(), data.begin() + 3_MiB));
+    REQUIRE(base->ChunkReads() <= 1);
+}
+
+TEST_CASE("ReadAheadVfsFile[IndependentFiles]", "[core]") {
+    const std::vector<u8> stalled_data = RandomData(4_MiB, 0x57a1);
+    const std::vector<u8> data = RandomData(4_MiB, 0xf11e);
+    const auto stalled_base = std::make_shared<GatedVfsFile>(stalled_data);
+    const auto stalled = std::make_shared<FileSys::ReadAheadVfsFile>(stalled_base);
+    const auto file = std::make_shared<FileSys::ReadAheadVfsFile>(
+        std::make_shared<FileSys::VectorVfsFile>(data));
+
+    // Start prefetching a file whose storage does not answer
+    std::vector<u8> buffer(0x1000);
+    REQUIRE(stalled->Read(buffer.data(), buffer.size(), 0) == buffer.size());
+    REQUIRE(stalled->Read(buffer.data(), buffer.size(), buffer.size()) == buffer.size());
+
+    // Streaming another file must not wait for it
+    std::vector<u8> out(data.size());
+    REQUIRE(StreamFile(file, out, 0x10000) == data.size());
+    REQUIRE(out == data);
+
+    stalled_base->Open();
+    std::vector<u8> stalled_out(stalled_data.size());
+    REQUIRE(StreamFile(stalled, stalled_out, 0x10000) == stalled_data.size());
+    REQUIRE(stalled_out == stalled_data);
+}
+
+TEST_CASE("ReadAheadVfsFile[Benchmark]", "[core][!benchmark]") {
+    // An encrypted section on slow storage streamed in small reads, which are fetched and decrypted
+    // while the caller consumes the previous ones
+    const std::vector<u8> key = RandomData(0x10, 0x4e7);
+    const std::vector<u8> iv = RandomData(0x10, 0x1f);
+    const auto base = std::make_shared<SlowVfsFile>(RandomData(16_MiB, 0x5ec));
+    const auto encrypted =
+        std::make_shared<FileSys::AesCtrStorage>(base, key.data(), FileSys::AesCtrStorage::KeySize,
+                                                 iv.data(), FileSys::AesCtrStorage::IvSize);
+    const auto read_ahead = std::make_shared<FileSys::ReadAheadVfsFile>(encrypted);
+    std::vector<u8> out(base->GetSize());
+
+    // Stands in for the work a game does on each piece of data before it reads the next one
+    const auto stream_and_consume = [&out](const FileSys::VirtualFile& file) {
+        constexpr std::size_t read_size = 64_KiB;
+        u64 sum = 0;
+        for (std::size_t offset = 0; offset < out.size(); offset += read_size) {
+            file->Read(out.data() + offset, read_size, offset);
+            for (std::size_t i = offset; i < offset + read_size; ++i) {
+                sum = sum * 31 + out[i];
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("Direct 64 KiB reads") {
+        return stream_and_consume(encrypted);
+    };
+    BENCHMARK("Read ahead 64 KiB reads") {
+        return stream_and_consume(read_ahead);
+    };
+}
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/literals.h"
+#include "core/file_sys/vfs/vfs_real.h"
+#include "tests/random_data.h"
+
+namespace {
+using namespace Common::Literals;
+using Tests::RandomData;
+
+class TemporaryFile {
+public:
+    TemporaryFile(const std::string& name, std::span<const u8> data)
+        : path{std::filesystem::temp_directory_path() / name} {
+        Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                                Common::FS::FileType::BinaryFile};
+        REQUIRE(file.WriteSpan(data) == data.size());
+    }
+
+    ~TemporaryFile() {
+        void(Common::FS::RemoveFile(path));
+    }
+
+    std::string PathString() const {
+        return Common::FS::PathToUTF8String(path);
+    }
+
+private:
+    std::filesystem::path path;
+};
+} // Anonymous namespace
+
+TEST_CASE("RealVfsFile[MappedReads]", "[core]") {
+    const std::vector<u8> data = RandomData(1_MiB + 123, 0x1a6e);
+    // Images opened for reading are mapped, other files use the regular stream
+    const TemporaryFile image("sudachi_vfs_real_test.nsp", data);
+    const TemporaryFile other("sudachi_vfs_real_test.bin", data);
+
+    FileSys::RealVfsFilesystem vfs;
+    for (const auto* file : {&image, &other}) {
+        const auto vfs_file = vfs.OpenFile(file->PathString(), FileSys::OpenMode::Read);
+        REQUIRE(vfs_file != nullptr);
+        REQUIRE(vfs_file->GetSize() == data.size());
+        REQUIRE(vfs_file->ReadAllBytes() == data);
+
+        std::mt19937 rng(0x5eed);
+        std::vector<u8> buffer(0x2345);
+        for (int i = 0; i < 256; ++i) {
+            const std::size_t offset = rng() % (data.size() + 0x100);
+            const std::size_t expected =
+                offset >= data.size() ? 0 : std::min(buffer.size(), data.size() - offset);
+            REQUIRE(vfs_file->Read(buffer.data(), buffer.size(), offset) == expected);
+            REQUIRE(std::equal(buffer.begin(), buffer.begin() + expected, data.begin() + offset));
+        }
+    }
+}
+
+TEST_CASE("RealVfsFile[Truncate]", "[core]") {
+    const std::vector<u8> data = RandomData(2_MiB, 0x7a3c);
+    const TemporaryFile image("sudachi_vfs_real_truncate.nsp", data);
+
+    FileSys::RealVfsFilesystem vfs;
+    const auto old_file = vfs.OpenFile(image.PathString(), FileSys::OpenMode::Read);
+    REQUIRE(old_file != nullptr);
+    REQUIRE(old_file->ReadAllBytes() == data);
+
+    // Recreating the image truncates it, which unmaps it for the file that is still open
+    const auto new_file = vfs.CreateFile(image.PathString(), FileSys::OpenMode::ReadWrite);
+    REQUIRE(new_file != nullptr);
+    REQUIRE(new_file != old_file);
+    REQUIRE(new_file->GetSize() == 0);
+
+    std::vector<u8> buffer(0x1000);
+    REQUIRE(old_file->Read(buffer.data(), buffer.size(), 1_MiB) == 0);
+    REQUIRE(old_file->GetSize() == 0);
+}
+
+TEST_CASE("RealVfsFile[TruncateWhileReading]", "[core]") {
+    const std::vector<u8> data = RandomData(16_MiB, 0x5b1d);
+    const TemporaryFile image("sudachi_vfs_real_truncate_reads.nsp", data);
+
+    FileSys::RealVfsFilesystem vfs;
+    const auto old_file = vfs.OpenFile(image.PathString(), FileSys::OpenMode::Read);
+    REQUIRE(old_file != nullptr);
+
+    // Truncating waits for the reads copying out of the mapping, so none of them fault. Reads
+    // either see the old contents or none at all.
+    std::atomic_bool stop{};
+    std::atomic_size_t num_mismatches{};
+    std::vector<std::jthread> readers;
+    for (u32 seed = 0; seed < 4; ++seed) {
+        readers.emplace_back([&, seed] {
+            std::mt19937 rng(seed);
+            std::vector<u8> buffer(1_MiB);
+            while (!stop) {
+                const std::size_t offset = rng() % (data.size() - buffer.size());
+                const std::size_t read = old_file->Read(buffer.data(), buffer.size(), offset);
+                if (!std::equal(buffer.begin(), buffer.begin() + read, data.begin() + offset)) {
+                    ++num_mismatches;
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(vfs.CreateFile(image.PathString(), FileSys::OpenMode::ReadWrite) != nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    stop = true;
+    readers.clear();
+
+    REQUIRE(num_mismatches == 0);
+    REQUIRE(old_file->GetSize() == 0);
+}
+
+TEST_CASE("RealVfsFile[Benchmark]", "[core][!benchmark]") {
+    // RomFS and NCA parsing issue many small reads at scattered offsets
+    const std::vector<u8> data = RandomData(64_MiB, 0xbe7c);
+    const TemporaryFile image("sudachi_vfs_real_bench.nsp", data);
+    const TemporaryFile other("sudachi_vfs_real_bench.bin", data);
+
+    FileSys::RealVfsFilesystem vfs;
+    const auto mapped_file = vfs.OpenFile(image.PathString(), FileSys::OpenMode::Read);
+    const auto stream_file = vfs.OpenFile(other.PathString(), FileSys::OpenMode::Read);
+    std::vector<u8> buffer(0x200);
+
+    const auto small_reads = [&buffer, &data](const FileSys::VirtualFile& file) {
+        std::size_t total = 0;
+        for (std::size_t offset = 0; offset < data.size(); offset += 0x4000) {
+            total += file->Read(buffer.data(), buffer.size(), offset);
+        }
+        return total;
+    };
+    BENCHMARK("Mapped 4096 small reads") {
+        return small_reads(mapped_file);
+    };
+    BENCHMARK("Stream 4096 small reads") {
+        return small_reads(stream_file);
+    };
+}
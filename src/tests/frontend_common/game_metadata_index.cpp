@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "core/core.h"
+#include "core/file_sys/vfs/vfs_real.h"
+#include "frontend_common/game_metadata_index.h"
+
+namespace {
+
+class TemporaryDirectory {
+public:
+    explicit TemporaryDirectory(const std::string& name)
+        : path{std::filesystem::temp_directory_path() / name} {
+        void(Common::FS::RemoveDirRecursively(path));
+        REQUIRE(Common::FS::CreateDirs(path));
+    }
+
+    ~TemporaryDirectory() {
+        void(Common::FS::RemoveDirRecursively(path));
+    }
+
+    std::filesystem::path Write(const std::string& name, const std::vector<u8>& data) const {
+        const auto file_path = path / name;
+        Common::FS::IOFile file{file_path, Common::FS::FileAccessMode::Write,
+                                Common::FS::FileType::BinaryFile};
+        REQUIRE(file.WriteSpan(std::span<const u8>(data)) == data.size());
+        return file_path;
+    }
+
+    const std::filesystem::path& Path() const {
+        return path;
+    }
+
+private:
+    std::filesystem::path path;
+};
+
+// The smallest file identified as an NRO, it has a title without any control data
+std::vector<u8> MakeNro(size_t size) {
+    std::vector<u8> data(size);
+    const u32 magic = Common::MakeMagic('N', 'R', 'O', '0');
+    std::memcpy(data.data() + 0x10, &magic, sizeof(magic));
+    return data;
+}
+
+std::vector<u8> MakeText(size_t size) {
+    return std::vector<u8>(size, static_cast<u8>('a'));
+}
+
+} // Anonymous namespace
+
+TEST_CASE("GameMetadataIndex[Scan]", "[frontend_common]") {
+    const TemporaryDirectory dir("sudachi_game_metadata_index_scan");
+    const std::vector<std::filesystem::path> paths{
+        dir.Write("game.nro", MakeNro(0x1000)),
+        dir.Write("notes.txt", MakeText(0x1000)),
+    };
+    Core::System system;
+    const auto vfs = std::make_shared<FileSys::RealVfsFilesystem>();
+    GameMetadataIndex index(dir.Path() / "index.bin");
+
+    const auto entries = index.Scan(system, vfs, paths, 2);
+    REQUIRE(entries.size() == paths.size());
+    REQUIRE(entries[0].file_type == Loader::FileType::NRO);
+    REQUIRE(entries[0].file_size == 0x1000);
+    REQUIRE(entries[0].titles.size() == 1);
+    REQUIRE(entries[1].titles.empty());
+
+    // Only files with titles are indexed
+    const auto found = index.Find(paths[0]);
+    REQUIRE(found.has_value());
+    REQUIRE(found->file_type == Loader::FileType::NRO);
+    REQUIRE(found->titles.size() == 1);
+    REQUIRE(!index.Find(paths[1]).has_value());
+
+    // A file that changed size is parsed again
+    dir.Write("game.nro", MakeNro(0x2000));
+    REQUIRE(!index.Find(paths[0]).has_value());
+    const auto rescanned = index.Scan(system, vfs, paths, 1);
+    REQUIRE(rescanned[0].file_type == Loader::FileType::NRO);
+    REQUIRE(rescanned[0].file_size == 0x2000);
+    REQUIRE(index.Find(paths[0]).has_value());
+}
+
+TEST_CASE("GameMetadataIndex[SaveLoad]", "[frontend_common]") {
+    const TemporaryDirectory dir("sudachi_game_metadata_index_save");
+    const std::vector<std::filesystem::path> paths{dir.Write("game.nro", MakeNro(0x1000))};
+    const auto index_path = dir.Path() / "index.bin";
+    Core::System system;
+    const auto vfs = std::make_shared<FileSys::RealVfsFilesystem>();
+
+    {
+        GameMetadataIndex index(index_path);
+        REQUIRE(index.Scan(system, vfs, paths, 1)[0].titles.size() == 1);
+        REQUIRE(index.Save());
+    }
+    {
+        // Entries survive a reload, but are dropped on save when no scan used them
+        GameMetadataIndex index(index_path);
+        const auto found = index.Find(paths[0]);
+        REQUIRE(found.has_value());
+        REQUIRE(found->file_type == Loader::FileType::NRO);
+        REQUIRE(found->file_size == 0x1000);
+    }
+    {
+        GameMetadataIndex index(index_path);
+        REQUIRE(index.Save());
+    }
+    GameMetadataIndex index(index_path);
+    REQUIRE(!index.Find(paths[0]).has_value());
+
+    // A corrupted index is ignored
+    dir.Write("index.bin", MakeText(0x40));
+    GameMetadataIndex corrupted(index_path);
+    REQUIRE(!corrupted.Find(paths[0]).has_value());
+}
+
+TEST_CASE("GameMetadataIndex[Stop]", "[frontend_common]") {
+    const TemporaryDirectory dir("sudachi_game_metadata_index_stop");
+    const std::vector<std::filesystem::path> paths{
+        dir.Write("first.nro", MakeNro(0x1000)),
+        dir.Write("second.nro", MakeNro(0x1000)),
+    };
+    Core::System system;
+    const auto vfs = std::make_shared<FileSys::RealVfsFilesystem>();
+    GameMetadataIndex index(dir.Path() / "index.bin");
+
+    // Files are not parsed once a stop is requested
+    std::stop_source stop_source;
+    stop_source.request_stop();
+    const auto entries = index.Scan(system, vfs, paths, 2, stop_source.get_token());
+    REQUIRE(entries.size() == paths.size());
+    REQUIRE(entries[0].titles.empty());
+    REQUIRE(entries[1].titles.empty());
+    REQUIRE(!index.Find(paths[0]).has_value());
+    REQUIRE(!index.Find(paths[1]).has_value());
+}
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Tests {
+
+/// Generates count values drawn from rng, truncated to T.
+template <typename T = u8, std::uniform_random_bit_generator Generator>
+std::vector<T> RandomData(Generator& rng, std::size_t count) {
+    std::vector<T> data(count);
+    for (T& value : data) {
+        value = static_cast<T>(rng());
+    }
+    return data;
+}
+
+/// Generates count values from a fixed seed, so failures can be reproduced.
+template <typename T = u8>
+std::vector<T> RandomData(std::size_t count, u32 seed) {
+    std::mt19937 rng(seed);
+    return RandomData<T>(rng, count);
+}
+
+} // namespace Tests
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/hash.h"
+#include "video_core/texture_cache/image_page_table.h"
+#include "video_core/texture_cache/types.h"
+
+namespace {
+using VideoCommon::ImageId;
+using VideoCommon::ImagePageTable;
+
+constexpr u64 PAGE_BITS = 20;
+
+struct Image {
+    u64 addr;
+    u64 size;
+};
+
+// What the texture cache used before ImagePageTable, the reference for lookups and benchmarks
+class HashPageTable {
+public:
+    std::vector<ImageId>* Find(u64 page) {
+        const auto it = map.find(page);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    std::vector<ImageId>& operator[](u64 page) {
+        return map[page];
+    }
+
+private:
+    std::unordered_map<u64, std::vector<ImageId>, Common::IdentityHash<u64>> map;
+};
+
+template <typename Func>
+void ForEachPage(u64 addr, u64 size, Func&& func) {
+    const u64 page_end = (addr + size - 1) >> PAGE_BITS;
+    for (u64 page = addr >> PAGE_BITS; page <= page_end; ++page) {
+        func(page);
+    }
+}
+
+template <typename Table>
+void Register(Table& table, const std::vector<Image>& images, u32 index) {
+    ForEachPage(images[index].addr, images[index].size,
+                [&](u64 page) { table[page].push_back(ImageId{index}); });
+}
+
+template <typename Table>
+bool Unregister(Table& table, const std::vector<Image>& images, u32 index) {
+    bool found = true;
+    ForEachPage(images[index].addr, images[index].size, [&](u64 page) {
+        auto* const ids = table.Find(page);
+        if (!ids) {
+            found = false;
+            return;
+        }
+        const auto it = std::ranges::find(*ids, ImageId{index});
+        if (it == ids->end()) {
+            found = false;
+            return;
+        }
+        ids->erase(it);
+    });
+    return found;
+}
+
+// Counts the images overlapping a region the way ForEachImageInRegionGPU walks the table
+template <typename Table>
+u64 CountOverlaps(Table& table, const std::vector<Image>& images, u64 addr, u64 size) {
+    u64 count = 0;
+    ForEachPage(addr, size, [&](u64 page) {
+        const auto* const ids = table.Find(page);
+        if (!ids) {
+            return;
+        }
+        for (const ImageId id : *ids) {
+            const Image& image = images[id.index];
+            count += image.addr < addr + size && addr < image.addr + image.size ? 1 : 0;
+        }
+    });
+    return count;
+}
+
+// Images of the sizes a texture heavy title uses, packed in a few heaps across a 40 bit address
+// space: mostly small textures, some render targets and a handful of large arrays
+std::vector<Image> MakeImages(u32 count, u32 seed) {
+    std::mt19937_64 rng(seed);
+    const u64 heaps[] = {0x0'0420'0000ULL, 0x1'0000'0000ULL, 0x40'0000'0000ULL, 0xF0'0000'0000ULL};
+    u64 heap_tops[std::size(heaps)];
+    std::copy(std::begin(heaps), std::end(heaps), heap_tops);
+
+    std::vector<Image> images;
+    for (u32 i = 0; i < count; ++i) {
+        const u32 kind = rng() % 100;
+        const u64 size = kind < 80   ? 0x1000 * (1 + rng() % 256)
+                         : kind < 97 ? 0x100000 * (1 + rng() % 16)
+                                     : 0x100000 * (16 + rng() % 64);
+        u64& top = heap_tops[rng() % std::size(heaps)];
+        images.push_back({top, size});
+        top += (size + 0xFFF) & ~0xFFFULL;
+    }
+    return images;
+}
+
+// Lookups of a frame: descriptor fetches of single images and render target and copy regions
+std::vector<Image> MakeLookups(const std::vector<Image>& images, u32 count, u32 seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Image> lookups;
+    for (u32 i = 0; i < count; ++i) {
+        const Image& image = images[rng() % images.size()];
+        if (rng() % 4 == 0) {
+            lookups.push_back(image);
+        } else {
+            lookups.push_back({image.addr + rng() % image.size, 0x1000});
+        }
+    }
+    return lookups;
+}
+} // Anonymous namespace
+
+TEST_CASE("ImagePageTable[Lookup]", "[video_core]") {
+    const std::vector<Image> images = MakeImages(4000, 0x7ab1e);
+    ImagePageTable<ImageId> table;
+    HashPageTable reference;
+    for (u32 i = 0; i < images.size(); ++i) {
+        Register(table, images, i);
+        Register(reference, images, i);
+    }
+
+    REQUIRE(table.Find(0x80'0000'0000ULL >> PAGE_BITS) == nullptr);
+    REQUIRE(table.Find(~0ULL >> PAGE_BITS) == nullptr);
+    for (const Image& lookup : MakeLookups(images, 10000, 0x100c)) {
+        REQUIRE(CountOverlaps(table, images, lookup.addr, lookup.size) ==
+                CountOverlaps(reference, images, lookup.addr, lookup.size));
+    }
+
+    // Unregister every other image, the rest must still be found exactly once per page
+    for (u32 i = 0; i < images.size(); i += 2) {
+        REQUIRE(Unregister(table, images, i));
+        REQUIRE(!Unregister(table, images, i));
+    }
+    for (u32 i = 0; i < images.size(); ++i) {
+        const Image& image = images[i];
+        ForEachPage(image.addr, image.size, [&](u64 page) {
+            const auto* const ids = table.Find(page);
+            REQUIRE(ids != nullptr);
+            REQUIRE(std::ranges::count(*ids, ImageId{i}) == (i % 2 == 0 ? 0 : 1));
+        });
+    }
+}
+
+TEST_CASE("ImagePageTable[Benchmark]", "[video_core][!benchmark]") {
+    const std::vector<Image> images = MakeImages(4000, 0xbe7c);
+    const std::vector<Image> lookups = MakeLookups(images, 100000, 0xf7a3e);
+
+    const auto replay = [&](auto& table) {
+        u64 count = 0;
+        for (const Image& lookup : lookups) {
+            count += CountOverlaps(table, images, lookup.addr, lookup.size);
+        }
+        return count;
+    };
+    const auto churn = [&](auto& table) {
+        for (u32 i = 0; i < images.size(); i += 3) {
+            Unregister(table, images, i);
+            Register(table, images, i);
+        }
+        return table.Find(images.back().addr >> PAGE_BITS);
+    };
+
+    ImagePageTable<ImageId> table;
+    HashPageTable reference;
+    for (u32 i = 0; i < images.size(); ++i) {
+        Register(table, images, i);
+        Register(reference, images, i);
+    }
+
+    BENCHMARK("Replay 100000 region lookups, unordered_map") {
+        return replay(reference);
+    };
+    BENCHMARK("Replay 100000 region lookups, ImagePageTable") {
+        return replay(table);
+    };
+    BENCHMARK("Reregister a third of 4000 images, unordered_map") {
+        return churn(reference);
+    };
+    BENCHMARK("Reregister a third of 4000 images, ImagePageTable") {
+        return churn(table);
+    };
+}
@@ -1,14 +1,19 @@
 // SPDX-FileCopyrightText: Copyright 2023 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <algorithm>
 #include <memory>
+#include <random>
 #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include "common/alignment.h"
 #include "common/common_types.h"
+#include "common/div_ceil.h"
 #include "video_core/buffer_cache/memory_tracker_base.h"
 
 namespace {
@@ -54,6 +59,18 @@ public:
 private:
     std::unordered_map<u64, int> page_table;
 };
+
+// Only sums the deltas it is given, so benchmarks measure the tracker and not the page counting
+class CountingInterface {
+public:
+    void UpdatePagesCachedCount(VAddr addr, u64 size, int delta) {
+        count += static_cast<s64>(size / PAGE) * delta;
+        ++calls;
+    }
+
+    s64 count = 0;
+    u64 calls = 0;
+};
 } // Anonymous namespace
 
 using MemoryTracker = VideoCommon::MemoryTrackerBase<RasterizerInterface>;
@@ -546,3 +563,192 @@ TEST_CASE("MemoryTracker: Cached write downloads") {
     memory_track->MarkRegionAsCpuModified(c, WORD);
     REQUIRE(rasterizer.Count() == 0);
 }
+
+TEST_CASE("MemoryTracker: Upload across word groups", "[video_core]") {
+    RasterizerInterface rasterizer;
+    std::unique_ptr<MemoryTracker> memory_track(std::make_unique<MemoryTracker>(rasterizer));
+    memory_track->UnmarkRegionAsCpuModified(c, HIGH_PAGE_SIZE);
+    constexpr u64 GROUP = WORD * VideoCommon::WORDS_PER_GROUP;
+
+    // Pages on both sides of a group boundary are uploaded as a single range
+    memory_track->MarkRegionAsCpuModified(c + GROUP - PAGE * 3, PAGE * 5);
+    REQUIRE(memory_track->IsRegionCpuModified(c + GROUP, PAGE));
+    REQUIRE(memory_track->ModifiedCpuRegion(c, HIGH_PAGE_SIZE) ==
+            Range{c + GROUP - PAGE * 3, c + GROUP + PAGE * 2});
+    int num = 0;
+    memory_track->ForEachUploadRange(c, HIGH_PAGE_SIZE, [&](u64 offset, u64 size) {
+        REQUIRE(offset == c + GROUP - PAGE * 3);
+        REQUIRE(size == PAGE * 5);
+        ++num;
+    });
+    REQUIRE(num == 1);
+
+    // A whole group with a page on each side of it
+    memory_track->MarkRegionAsCpuModified(c + GROUP - PAGE, GROUP + PAGE * 2);
+    REQUIRE(rasterizer.Count() == HIGH_PAGE_SIZE / PAGE - (GROUP / PAGE + 2));
+    num = 0;
+    memory_track->ForEachUploadRange(c + GROUP - PAGE * 2, GROUP + PAGE * 4,
+                                     [&](u64 offset, u64 size) {
+                                         REQUIRE(offset == c + GROUP - PAGE);
+                                         REQUIRE(size == GROUP + PAGE * 2);
+                                         ++num;
+                                     });
+    REQUIRE(num == 1);
+    REQUIRE(rasterizer.Count() == HIGH_PAGE_SIZE / PAGE);
+    REQUIRE(!memory_track->IsRegionCpuModified(c, HIGH_PAGE_SIZE));
+}
+
+TEST_CASE("MemoryTracker: Word groups match page model", "[video_core]") {
+    using VideoCommon::Type;
+
+    // Buffers ending in a partial group, with and without a partial last word, and one that
+    // fits in the small vector storage
+    for (const u64 size_bytes : {WORD * 9 + PAGE * 5, WORD * 6, WORD * 4, PAGE * 10}) {
+        const u64 num_pages = Common::DivCeil(size_bytes, PAGE);
+
+        RasterizerInterface rasterizer;
+        VideoCommon::WordManager<RasterizerInterface> manager(c, rasterizer, size_bytes);
+        std::vector<bool> cpu(num_pages, true);
+        std::vector<bool> gpu(num_pages, false);
+        std::vector<bool> tracked(num_pages, false);
+
+        // Regions start and end next to group boundaries more often than not
+        std::mt19937 rng(static_cast<u32>(size_bytes));
+        const auto random_address = [&] {
+            constexpr u64 GROUP = WORD * VideoCommon::WORDS_PER_GROUP;
+            const u64 boundary = rng() % (size_bytes / GROUP + 1) * GROUP;
+            const u64 address = rng() % 4 == 0 ? rng() % size_bytes : boundary + rng() % 9 * PAGE;
+            return std::min(address - std::min<u64>(address, rng() % 5 * PAGE), size_bytes);
+        };
+        for (int iteration = 0; iteration < 2000; ++iteration) {
+            u64 begin = random_address();
+            u64 end = random_address();
+            if (begin > end) {
+                std::swap(begin, end);
+            }
+            if (begin == end) {
+                continue;
+            }
+            const u64 page_begin = begin / PAGE;
+            const u64 page_end = Common::DivCeil(end, PAGE);
+
+            switch (rng() % 6) {
+            case 0:
+                manager.ChangeRegionState<Type::CPU, true>(c + begin, end - begin);
+                for (u64 page = page_begin; page < page_end; ++page) {
+                    cpu[page] = true;
+                    tracked[page] = false;
+                }
+                break;
+            case 1:
+                manager.ChangeRegionState<Type::CPU, false>(c + begin, end - begin);
+                for (u64 page = page_begin; page < page_end; ++page) {
+                    cpu[page] = false;
+                    tracked[page] = true;
+                }
+                break;
+            case 2:
+                manager.ChangeRegionState<Type::GPU, true>(c + begin, end - begin);
+                for (u64 page = page_begin; page < page_end; ++page) {
+                    gpu[page] = true;
+                }
+                break;
+            case 3:
+            case 4: {
+                const bool is_upload = rng() % 2 == 0;
+                std::vector<bool>& state = is_upload ? cpu : gpu;
+                std::vector<Range> expected;
+                for (u64 page = page_begin; page < page_end; ++page) {
+                    if (!state[page] || (!is_upload && !tracked[page])) {
+                        continue;
+                    }
+                    if (!expected.empty() && expected.back().second == c + page * PAGE) {
+                        expected.back().second += PAGE;
+                    } else {
+                        expected.emplace_back(c + page * PAGE, c + (page + 1) * PAGE);
+                    }
+                    state[page] = false;
+                }
+                if (is_upload) {
+                    std::fill(tracked.begin() + page_begin, tracked.begin() + page_end, true);
+                }
+                std::vector<Range> ranges;
+                const auto func = [&](u64 offset, u64 size) {
+                    ranges.emplace_back(offset, offset + size);
+                };
+                if (is_upload) {
+                    manager.ForEachModifiedRange<Type::CPU, true>(c + begin, end - begin, func);
+                } else {
+                    manager.ForEachModifiedRange<Type::GPU, true>(c + begin, end - begin, func);
+                }
+                REQUIRE(ranges == expected);
+                break;
+            }
+            case 5: {
+                Range expected{0, 0};
+                bool is_gpu_modified = false;
+                for (u64 page = page_begin; page < page_end; ++page) {
+                    if (cpu[page]) {
+                        if (expected.second == 0) {
+                            expected.first = page * PAGE;
+                        }
+                        expected.second = (page + 1) * PAGE;
+                    }
+                    is_gpu_modified |= gpu[page] && tracked[page];
+                }
+                REQUIRE(manager.ModifiedRegion<Type::CPU>(begin, end - begin) ==
+                        expected);
+                REQUIRE(manager.IsRegionModified<Type::CPU>(begin, end - begin) ==
+                        (expected.second != 0));
+                REQUIRE(manager.IsRegionModified<Type::GPU>(begin, end - begin) ==
+                        is_gpu_modified);
+                break;
+            }
+            }
+            REQUIRE(rasterizer.Count() == std::count(tracked.begin(), tracked.end(), true));
+        }
+    }
+}
+
+TEST_CASE("MemoryTracker: Benchmark", "[video_core][!benchmark]") {
+    // A streaming buffer the size of the ones games keep vertex and uniform data in
+    constexpr u64 SIZE = 64 * HIGH_PAGE_SIZE;
+    CountingInterface rasterizer;
+    auto memory_track =
+        std::make_unique<VideoCommon::MemoryTrackerBase<CountingInterface>>(rasterizer);
+    memory_track->UnmarkRegionAsCpuModified(c, SIZE);
+
+    BENCHMARK("Query clean region") {
+        return memory_track->IsRegionCpuModified(c, SIZE) ||
+               memory_track->IsRegionGpuModified(c, SIZE);
+    };
+    BENCHMARK("Modified range of clean region") {
+        return memory_track->ModifiedCpuRegion(c, SIZE);
+    };
+    BENCHMARK("Mark and unmark region as CPU modified") {
+        memory_track->MarkRegionAsCpuModified(c, SIZE);
+        memory_track->UnmarkRegionAsCpuModified(c, SIZE);
+        return rasterizer.count;
+    };
+    BENCHMARK("Upload fully modified region") {
+        memory_track->MarkRegionAsCpuModified(c, SIZE);
+        u64 uploaded = 0;
+        memory_track->ForEachUploadRange(c, SIZE, [&](u64 offset, u64 size) { uploaded += size; });
+        return uploaded;
+    };
+    BENCHMARK("Upload sparsely modified region") {
+        for (u64 offset = 0; offset < SIZE; offset += WORD) {
+            memory_track->MarkRegionAsCpuModified(c + offset + PAGE * 3, PAGE * 2);
+        }
+        u64 uploaded = 0;
+        memory_track->ForEachUploadRange(c, SIZE, [&](u64 offset, u64 size) { uploaded += size; });
+        return uploaded;
+    };
+    BENCHMARK("Download fully modified region") {
+        memory_track->MarkRegionAsGpuModified(c, SIZE);
+        u64 downloaded = 0;
+        memory_track->ForEachDownloadRangeAndClear(
+            c, SIZE, [&](u64 offset, u64 size) { downloaded += size; });
+        return downloaded;
+    };
+}
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <filesystem>
+#include <stop_token>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "shader_recompiler/stage.h"
+#include "video_core/shader_environment.h"
+
+namespace {
+constexpr u32 CacheVersion = 7;
+constexpr std::array<char, 8> MagicNumber{'s', 'u', 'd', 'a', 'c', 'h', 'i', '0'};
+
+constexpr u64 EnvironmentEntry = 0;
+constexpr u64 PipelineEntry = 1;
+
+template <typename T>
+void Append(std::vector<u8>& data, const T& value) {
+    const auto* const bytes = reinterpret_cast<const u8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+// Entry header: payload size, entry type, number of environments, stage and a reserved word
+void AppendHeader(std::vector<u8>& data, u64 size, u64 type, u32 num_envs, Shader::Stage stage) {
+    Append(data, size);
+    Append(data, static_cast<u32>(type));
+    Append(data, num_envs);
+    Append(data, stage);
+    Append(data, u32{0});
+}
+
+// The payload is not decompressed while indexing, so any bytes do
+void AppendEnvironment(std::vector<u8>& data, u64 hash) {
+    AppendHeader(data, 32, EnvironmentEntry, 0, Shader::Stage::VertexB);
+    Append(data, hash);
+    Append(data, u64{16});
+    Append(data, std::array<u8, 16>{});
+}
+
+void AppendPipeline(std::vector<u8>& data, u64 env_hash, u64 key, Shader::Stage stage) {
+    AppendHeader(data, sizeof(env_hash) + sizeof(key), PipelineEntry, 1, stage);
+    Append(data, env_hash);
+    Append(data, key);
+}
+
+std::vector<u8> MakeCache() {
+    std::vector<u8> data;
+    Append(data, MagicNumber);
+    Append(data, CacheVersion);
+    AppendEnvironment(data, 0xAAAA);
+    AppendPipeline(data, 0xAAAA, 1, Shader::Stage::VertexB);
+    AppendEnvironment(data, 0xBBBB);
+    AppendPipeline(data, 0xBBBB, 2, Shader::Stage::Compute);
+    return data;
+}
+
+void WriteFile(const std::filesystem::path& path, const std::vector<u8>& data) {
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    REQUIRE(file.WriteSpan(std::span<const u8>(data)) == data.size());
+}
+
+struct LoadResult {
+    std::vector<u64> graphics_keys;
+    std::vector<u64> compute_keys;
+};
+
+LoadResult Load(const std::filesystem::path& path, VideoCommon::ShaderBlobStore& blobs) {
+    LoadResult result;
+    const auto read_key = [](std::vector<u64>& keys, VideoCommon::PipelineCacheEntry entry) {
+        const auto key = entry.ReadKey<u64>();
+        REQUIRE(key.has_value());
+        keys.push_back(*key);
+    };
+    VideoCommon::LoadPipelines(
+        std::stop_token{}, path, CacheVersion, blobs,
+        [&](VideoCommon::PipelineCacheEntry entry) {
+            read_key(result.compute_keys, std::move(entry));
+        },
+        [&](VideoCommon::PipelineCacheEntry entry) {
+            read_key(result.graphics_keys, std::move(entry));
+        });
+    return result;
+}
+} // Anonymous namespace
+
+TEST_CASE("PipelineCache[TornTail]", "[video_core]") {
+    const auto path = std::filesystem::temp_directory_path() / "sudachi_pipeline_cache_tail.bin";
+    const std::vector<u8> cache = MakeCache();
+
+    // A partial header, and a complete header whose payload was cut short
+    std::vector<u8> partial_header;
+    AppendHeader(partial_header, 16, PipelineEntry, 1, Shader::Stage::VertexB);
+    partial_header.resize(10);
+    std::vector<u8> partial_payload;
+    AppendPipeline(partial_payload, 0xAAAA, 3, Shader::Stage::VertexB);
+    partial_payload.resize(partial_payload.size() - 4);
+
+    for (const auto& tail : {partial_header, partial_payload}) {
+        std::vector<u8> data = cache;
+        data.insert(data.end(), tail.begin(), tail.end());
+        WriteFile(path, data);
+
+        VideoCommon::ShaderBlobStore blobs;
+        const LoadResult result = Load(path, blobs);
+        REQUIRE(result.graphics_keys == std::vector<u64>{1});
+        REQUIRE(result.compute_keys == std::vector<u64>{2});
+        REQUIRE(blobs.hashes.size() == 2);
+
+        // The tail is cut off, so new entries are appended right after the last intact one
+        REQUIRE(Common::FS::GetSize(path) == cache.size());
+        const auto contents = VideoCommon::ReadPipelineCache(path);
+        REQUIRE(contents.has_value());
+        REQUIRE(!contents->is_corrupted);
+        REQUIRE(contents->entries.size() == 2);
+    }
+    void(Common::FS::RemoveFile(path));
+}
+
+TEST_CASE("PipelineCache[TornEnvironment]", "[video_core]") {
+    const auto path = std::filesystem::temp_directory_path() / "sudachi_pipeline_cache_env.bin";
+    const std::vector<u8> cache = MakeCache();
+
+    // An environment and the pipeline using it, where the write stopped inside the environment
+    std::vector<u8> data = cache;
+    AppendEnvironment(data, 0xCCCC);
+    AppendPipeline(data, 0xCCCC, 3, Shader::Stage::VertexB);
+    data.resize(cache.size() + 30);
+    WriteFile(path, data);
+
+    // The torn environment is not reported as stored, so it is written again with its pipeline
+    VideoCommon::ShaderBlobStore blobs;
+    const LoadResult result = Load(path, blobs);
+    REQUIRE(result.graphics_keys == std::vector<u64>{1});
+    REQUIRE(result.compute_keys == std::vector<u64>{2});
+    REQUIRE(blobs.hashes.contains(0xAAAA));
+    REQUIRE(blobs.hashes.contains(0xBBBB));
+    REQUIRE(!blobs.hashes.contains(0xCCCC));
+    REQUIRE(Common::FS::GetSize(path) == cache.size());
+
+    void(Common::FS::RemoveFile(path));
+}
+
+TEST_CASE("PipelineCache[OldVersion]", "[video_core]") {
+    const auto path = std::filesystem::temp_directory_path() / "sudachi_pipeline_cache_old.bin";
+    std::vector<u8> data = MakeCache();
+    data[MagicNumber.size()] = CacheVersion - 1;
+    WriteFile(path, data);
+
+    VideoCommon::ShaderBlobStore blobs;
+    const LoadResult result = Load(path, blobs);
+    REQUIRE(result.graphics_keys.empty());
+    REQUIRE(result.compute_keys.empty());
+    REQUIRE(!Common::FS::Exists(path));
+}
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "video_core/textures/astc.h"
+
+namespace {
+using Block = std::array<u8, 16>;
+
+struct Footprint {
+    u32 width;
+    u32 height;
+};
+
+constexpr std::array<Footprint, 14> FOOTPRINTS{{
+    {4, 4},
+    {5, 4},
+    {5, 5},
+    {6, 5},
+    {6, 6},
+    {8, 5},
+    {8, 6},
+    {8, 8},
+    {10, 5},
+    {10, 6},
+    {10, 8},
+    {10, 10},
+    {12, 10},
+    {12, 12},
+}};
+
+void SetBits(Block& block, u32 offset, u32 count, u32 value) {
+    for (u32 bit = 0; bit < count; ++bit) {
+        const u32 index = offset + bit;
+        const u8 mask = static_cast<u8>(1U << (index % 8));
+        if ((value >> bit) & 1) {
+            block[index / 8] |= mask;
+        } else {
+            block[index / 8] &= static_cast<u8>(~mask);
+        }
+    }
+}
+
+/// Builds a valid LDR block with a 4x4 weight grid and random endpoints, partitions and weights
+Block MakeRandomBlock(std::mt19937& rng) {
+    static constexpr std::array<u32, 6> LDR_MODES{0, 4, 6, 8, 10, 12};
+    Block block;
+    for (u8& value : block) {
+        value = static_cast<u8>(rng());
+    }
+    // Block mode with a 4x4 weight grid and a weight range picked from R
+    const u32 range = 2 + static_cast<u32>(rng() % 3);
+    const u32 dual_plane = static_cast<u32>(rng() % 2);
+    const u32 mode = (dual_plane << 10) | (2U << 5) | ((range & 1) << 4) | (range >> 1);
+    SetBits(block, 0, 11, mode);
+
+    const u32 endpoint_mode = LDR_MODES[rng() % LDR_MODES.size()];
+    const u32 num_partitions = 1 + static_cast<u32>(rng() % 2);
+    SetBits(block, 11, 2, num_partitions - 1);
+    if (num_partitions == 1) {
+        SetBits(block, 13, 4, endpoint_mode);
+    } else {
+        // Every partition shares the same endpoint mode
+        SetBits(block, 23, 6, endpoint_mode << 2);
+    }
+    return block;
+}
+
+Block MakeVoidExtentBlock(u16 r, u16 g, u16 b, u16 a) {
+    Block block;
+    block.fill(0xFF);
+    SetBits(block, 0, 12, 0xDFC);
+    SetBits(block, 64, 16, r);
+    SetBits(block, 80, 16, g);
+    SetBits(block, 96, 16, b);
+    SetBits(block, 112, 16, a);
+    return block;
+}
+
+std::vector<u8> MakeTexture(std::mt19937& rng, u32 num_blocks) {
+    std::vector<u8> data;
+    data.reserve(num_blocks * sizeof(Block));
+    for (u32 i = 0; i < num_blocks; ++i) {
+        const Block block = MakeRandomBlock(rng);
+        data.insert(data.end(), block.begin(), block.end());
+    }
+    return data;
+}
+} // Anonymous namespace
+
+TEST_CASE("ASTC[VoidExtent]", "[video_core]") {
+    const Block block = MakeVoidExtentBlock(0x12ff, 0x3400, 0x5678, 0x9abc);
+    for (const Footprint footprint : FOOTPRINTS) {
+        std::vector<u8> output(footprint.width * footprint.height * 4);
+        Tegra::Texture::ASTC::Decompress(block, footprint.width, footprint.height, 1,
+                                         footprint.width, footprint.height, output);
+        for (size_t texel = 0; texel < output.size(); texel += 4) {
+            REQUIRE(output[texel + 0] == 0x12);
+            REQUIRE(output[texel + 1] == 0x34);
+            REQUIRE(output[texel + 2] == 0x56);
+            REQUIRE(output[texel + 3] == 0x9a);
+        }
+    }
+}
+
+TEST_CASE("ASTC[ParallelMatchesBlocks]", "[video_core]") {
+    std::mt19937 rng(0xa57c);
+    for (const Footprint footprint : FOOTPRINTS) {
+        // Odd sizes and several slices so that rows are split unevenly between jobs
+        const u32 width = footprint.width * 37 + 3;
+        const u32 height = footprint.height * 21 + 1;
+        const u32 depth = 2;
+        const u32 cols = Common::DivCeil(width, footprint.width);
+        const u32 rows = Common::DivCeil(height, footprint.height);
+        const std::vector<u8> data = MakeTexture(rng, cols * rows * depth);
+        std::vector<u8> output(width * height * depth * 4);
+        Tegra::Texture::ASTC::Decompress(data, width, height, depth, footprint.width,
+                                         footprint.height, output);
+
+        const u32 texels = footprint.width * footprint.height;
+        std::vector<u8> block_output(texels * 4);
+        for (u32 z = 0; z < depth; ++z) {
+            for (u32 row = 0; row < rows; ++row) {
+                for (u32 col = 0; col < cols; ++col) {
+                    const u32 block_index = (z * rows + row) * cols + col;
+                    const std::span<const u8> block =
+                        std::span(data).subspan(block_index * sizeof(Block), sizeof(Block));
+                    Tegra::Texture::ASTC::Decompress(block, footprint.width, footprint.height, 1,
+                                                     footprint.width, footprint.height,
+                                                     block_output);
+                    for (u32 y = 0; y < footprint.height; ++y) {
+                        const u32 texture_y = row * footprint.height + y;
+                        for (u32 x = 0; x < footprint.width; ++x) {
+                            const u32 texture_x = col * footprint.width + x;
+                            if (texture_x >= width || texture_y >= height) {
+                                continue;
+                            }
+                            const u32 offset = ((z * height + texture_y) * width + texture_x) * 4;
+                            const u32 block_offset = (y * footprint.width + x) * 4;
+                            for (u32 c = 0; c < 4; ++c) {
+                                REQUIRE(output[offset + c] == block_output[block_offset + c]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("ASTC[Benchmark]", "[video_core][!benchmark]") {
+    constexpr u32 width = 1024;
+    constexpr u32 height = 1024;
+    std::mt19937 rng(0xbe9c);
+    for (const Footprint footprint : FOOTPRINTS) {
+        const u32 num_blocks = Common::DivCeil(width, footprint.width) *
+                               Common::DivCeil(height, footprint.height);
+        const std::vector<u8> data = MakeTexture(rng, num_blocks);
+        std::vector<u8> output(width * height * 4);
+        BENCHMARK("Decompress " + std::to_string(footprint.width) + "x" +
+                  std::to_string(footprint.height) + " 1024x1024") {
+            Tegra::Texture::ASTC::Decompress(data, width, height, 1, footprint.width,
+                                             footprint.height, output);
+            return output[0];
+        };
+    }
+}
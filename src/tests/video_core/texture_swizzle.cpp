@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "tests/random_data.h"
+#include "video_core/textures/decoders.h"
+
+namespace {
+using namespace Tegra::Texture;
+using Tests::RandomData;
+
+constexpr std::array<u32, 8> BYTES_PER_PIXEL_LIST{1, 2, 3, 4, 6, 8, 12, 16};
+constexpr SwizzleTable SWIZZLE_TABLE = MakeSwizzleTable();
+
+/// Byte by byte block linear address calculation, used as the reference for the fast paths
+size_t ReferenceOffset(u32 x, u32 y, u32 z, u32 stride, u32 height, u32 block_height,
+                       u32 block_depth) {
+    const u32 gobs_in_x = Common::DivCeilLog2(stride, GOB_SIZE_X_SHIFT);
+    const u32 block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height + block_depth);
+    const u32 slice_size =
+        Common::DivCeilLog2(height, block_height + GOB_SIZE_Y_SHIFT) * block_size;
+    const u32 block_y = y >> GOB_SIZE_Y_SHIFT;
+    const u32 block_z_mask = (1U << block_depth) - 1;
+    const u32 block_y_mask = (1U << block_height) - 1;
+    return (z >> block_depth) * slice_size +
+           ((z & block_z_mask) << (GOB_SIZE_SHIFT + block_height)) +
+           (block_y >> block_height) * block_size +
+           ((block_y & block_y_mask) << GOB_SIZE_SHIFT) +
+           ((x >> GOB_SIZE_X_SHIFT) << (GOB_SIZE_SHIFT + block_height + block_depth)) +
+           SWIZZLE_TABLE[y % GOB_SIZE_Y][x % GOB_SIZE_X];
+}
+
+struct TextureShape {
+    u32 width;
+    u32 height;
+    u32 depth;
+    u32 block_height;
+    u32 block_depth;
+};
+
+TextureShape RandomShape(std::mt19937& rng) {
+    return {
+        .width = 1 + static_cast<u32>(rng() % 150),
+        .height = 1 + static_cast<u32>(rng() % 40),
+        .depth = 1 + static_cast<u32>(rng() % 3),
+        .block_height = static_cast<u32>(rng() % 4),
+        .block_depth = static_cast<u32>(rng() % 2),
+    };
+}
+
+size_t TiledSize(u32 bytes_per_pixel, const TextureShape& shape) {
+    return CalculateSize(true, bytes_per_pixel, shape.width, shape.height, shape.depth,
+                         shape.block_height, shape.block_depth);
+}
+} // Anonymous namespace
+
+TEST_CASE("TextureSwizzle[UnswizzleMatchesReference]", "[video_core]") {
+    std::mt19937 rng(0x5a17);
+    for (const u32 bytes_per_pixel : BYTES_PER_PIXEL_LIST) {
+        for (int iteration = 0; iteration < 32; ++iteration) {
+            const TextureShape shape = RandomShape(rng);
+            const u32 pitch = shape.width * bytes_per_pixel;
+            const std::vector<u8> tiled = RandomData(rng, TiledSize(bytes_per_pixel, shape));
+            std::vector<u8> linear(size_t{pitch} * shape.height * shape.depth);
+            UnswizzleTexture(linear, tiled, bytes_per_pixel, shape.width, shape.height,
+                             shape.depth, shape.block_height, shape.block_depth, 0);
+
+            std::vector<u8> expected(linear.size());
+            for (u32 z = 0; z < shape.depth; ++z) {
+                for (u32 y = 0; y < shape.height; ++y) {
+                    for (u32 x = 0; x < pitch; ++x) {
+                        const size_t offset = ReferenceOffset(x, y, z, pitch, shape.height,
+                                                              shape.block_height,
+                                                              shape.block_depth);
+                        expected[(size_t{z} * shape.height + y) * pitch + x] = tiled[offset];
+                    }
+                }
+            }
+            REQUIRE(linear == expected);
+        }
+    }
+}
+
+TEST_CASE("TextureSwizzle[SwizzleRoundTrip]", "[video_core]") {
+    std::mt19937 rng(0x7e57);
+    for (const u32 bytes_per_pixel : BYTES_PER_PIXEL_LIST) {
+        for (int iteration = 0; iteration < 32; ++iteration) {
+            const TextureShape shape = RandomShape(rng);
+            const std::vector<u8> linear = RandomData(
+                rng, size_t{shape.width} * bytes_per_pixel * shape.height * shape.depth);
+            std::vector<u8> tiled(TiledSize(bytes_per_pixel, shape));
+            std::vector<u8> result(linear.size());
+            SwizzleTexture(tiled, linear, bytes_per_pixel, shape.width, shape.height, shape.depth,
+                           shape.block_height, shape.block_depth, 0);
+            UnswizzleTexture(result, tiled, bytes_per_pixel, shape.width, shape.height,
+                             shape.depth, shape.block_height, shape.block_depth, 0);
+            REQUIRE(result == linear);
+        }
+    }
+}
+
+TEST_CASE("TextureSwizzle[SubrectMatchesReference]", "[video_core]") {
+    std::mt19937 rng(0x50b7);
+    for (const u32 bytes_per_pixel : BYTES_PER_PIXEL_LIST) {
+        for (int iteration = 0; iteration < 32; ++iteration) {
+            TextureShape shape = RandomShape(rng);
+            // Subrect copies only walk the lines of the first slice
+            shape.depth = 1;
+            const u32 stride = shape.width * bytes_per_pixel;
+            const u32 origin_x = static_cast<u32>(rng() % shape.width);
+            const u32 origin_y = static_cast<u32>(rng() % shape.height);
+            const u32 extent_x = 1 + static_cast<u32>(rng() % (shape.width - origin_x));
+            const u32 extent_y = 1 + static_cast<u32>(rng() % (shape.height - origin_y));
+            const u32 line_size = extent_x * bytes_per_pixel;
+            const u32 pitch = line_size + static_cast<u32>(rng() % 8);
+            const std::vector<u8> linear = RandomData(rng, size_t{pitch} * extent_y);
+            const std::vector<u8> tiled_input = RandomData(rng, TiledSize(bytes_per_pixel, shape));
+            std::vector<u8> tiled = tiled_input;
+            SwizzleSubrect(tiled, linear, bytes_per_pixel, shape.width, shape.height, shape.depth,
+                           origin_x, origin_y, extent_x, extent_y, shape.block_height,
+                           shape.block_depth, pitch);
+
+            std::vector<u8> expected_tiled = tiled_input;
+            for (u32 y = 0; y < extent_y; ++y) {
+                for (u32 x = 0; x < line_size; ++x) {
+                    const size_t offset =
+                        ReferenceOffset(origin_x * bytes_per_pixel + x, origin_y + y, 0, stride,
+                                        shape.height, shape.block_height, shape.block_depth);
+                    expected_tiled[offset] = linear[size_t{y} * pitch + x];
+                }
+            }
+            REQUIRE(tiled == expected_tiled);
+
+            std::vector<u8> result(linear.size());
+            UnswizzleSubrect(result, tiled, bytes_per_pixel, shape.width, shape.height,
+                             shape.depth, origin_x, origin_y, extent_x, extent_y,
+                             shape.block_height, shape.block_depth, pitch);
+            // Bytes between the end of a line and the pitch are left untouched
+            std::vector<u8> expected_linear = linear;
+            for (u32 y = 0; y < extent_y; ++y) {
+                const auto line = expected_linear.begin() + size_t{y} * pitch;
+                std::fill(line + line_size, line + pitch, u8{0});
+            }
+            REQUIRE(result == expected_linear);
+        }
+    }
+}
+
+TEST_CASE("TextureSwizzle[Benchmark]", "[video_core][!benchmark]") {
+    constexpr u32 width = 1024;
+    constexpr u32 height = 1024;
+    constexpr u32 block_height = 4;
+    std::mt19937 rng(0xbe9c);
+    for (const u32 bytes_per_pixel : {4U, 12U, 16U}) {
+        const TextureShape shape{width, height, 1, block_height, 0};
+        const std::vector<u8> linear = RandomData(rng, size_t{width} * height * bytes_per_pixel);
+        std::vector<u8> tiled(TiledSize(bytes_per_pixel, shape));
+        std::vector<u8> result(linear.size());
+        const std::string suffix = std::to_string(bytes_per_pixel) + "bpp 1024x1024";
+        BENCHMARK("Swizzle " + suffix) {
+            SwizzleTexture(tiled, linear, bytes_per_pixel, width, height, 1, block_height, 0, 0);
+            return tiled[0];
+        };
+        BENCHMARK("Unswizzle " + suffix) {
+            UnswizzleTexture(result, tiled, bytes_per_pixel, width, height, 1, block_height, 0,
+                             0);
+            return result[0];
+        };
+        BENCHMARK("UnswizzleSubrect " + suffix) {
+            UnswizzleSubrect(result, tiled, bytes_per_pixel, width, height, 1, 1, 1, width - 2,
+                             height - 2, block_height, 0, width * bytes_per_pixel);
+            return result[0];
+        };
+    }
+}
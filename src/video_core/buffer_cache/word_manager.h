@@ -4,11 +4,18 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <limits>
-#include <span>
+#include <type_traits>
 #include <utility>
 
+#if defined(ARCHITECTURE_x86_64)
+#include <emmintrin.h>
+#elif defined(ARCHITECTURE_arm64)
+#include <arm_neon.h>
+#endif
+
 #include "common/alignment.h"
 #include "common/common_funcs.h"
 #include "common/common_types.h"
@@ -21,6 +28,9 @@ constexpr u64 PAGES_PER_WORD = 64;
 constexpr u64 BYTES_PER_PAGE = Core::DEVICE_PAGESIZE;
 constexpr u64 BYTES_PER_WORD = PAGES_PER_WORD * BYTES_PER_PAGE;
 
+/// Number of consecutive words of a type stored together, they are processed at once
+constexpr size_t WORDS_PER_GROUP = 4;
+
 enum class Type {
     CPU,
     GPU,
@@ -29,55 +39,273 @@ enum class Type {
     Preflushable,
 };
 
-/// Vector tracking modified pages tightly packed with small vector optimization
-template <size_t stack_words = 1>
-struct WordsArray {
-    /// Returns the pointer to the words state
-    [[nodiscard]] const u64* Pointer(bool is_short) const noexcept {
-        return is_short ? stack.data() : heap;
+constexpr size_t NUM_TYPES = 5;
+
+/// Bits of a group of words, operated on with 128-bit vectors where available
+class WordGroup {
+public:
+    [[nodiscard]] static WordGroup Load(const u64* words) noexcept {
+        WordGroup result;
+#if defined(ARCHITECTURE_x86_64)
+        result.lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words));
+        result.hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + 2));
+#elif defined(ARCHITECTURE_arm64)
+        result.lo = vld1q_u64(words);
+        result.hi = vld1q_u64(words + 2);
+#else
+        std::copy_n(words, WORDS_PER_GROUP, result.words.begin());
+#endif
+        return result;
+    }
+
+    [[nodiscard]] static WordGroup Fill(u64 value) noexcept {
+        WordGroup result;
+#if defined(ARCHITECTURE_x86_64)
+        result.lo = _mm_set1_epi64x(static_cast<s64>(value));
+        result.hi = result.lo;
+#elif defined(ARCHITECTURE_arm64)
+        result.lo = vdupq_n_u64(value);
+        result.hi = result.lo;
+#else
+        result.words.fill(value);
+#endif
+        return result;
+    }
+
+    void Store(u64* words) const noexcept {
+#if defined(ARCHITECTURE_x86_64)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(words), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(words + 2), hi);
+#elif defined(ARCHITECTURE_arm64)
+        vst1q_u64(words, lo);
+        vst1q_u64(words + 2, hi);
+#else
+        std::copy(this->words.begin(), this->words.end(), words);
+#endif
+    }
+
+    [[nodiscard]] friend bool IsZero(const WordGroup& bits) noexcept {
+#if defined(ARCHITECTURE_x86_64)
+        const __m128i merged = _mm_or_si128(bits.lo, bits.hi);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(merged, _mm_setzero_si128())) == 0xFFFF;
+#elif defined(ARCHITECTURE_arm64)
+        return vmaxvq_u32(vreinterpretq_u32_u64(vorrq_u64(bits.lo, bits.hi))) == 0;
+#else
+        return std::ranges::all_of(bits.words, [](u64 word) { return word == 0; });
+#endif
+    }
+
+    [[nodiscard]] friend bool IsFull(const WordGroup& bits) noexcept {
+#if defined(ARCHITECTURE_x86_64)
+        const __m128i merged = _mm_and_si128(bits.lo, bits.hi);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(merged, _mm_set1_epi8(-1))) == 0xFFFF;
+#elif defined(ARCHITECTURE_arm64)
+        return vminvq_u32(vreinterpretq_u32_u64(vandq_u64(bits.lo, bits.hi))) == 0xFFFFFFFF;
+#else
+        return std::ranges::all_of(bits.words, [](u64 word) { return word == ~u64{0}; });
+#endif
+    }
+
+    [[nodiscard]] friend WordGroup operator&(const WordGroup& lhs, const WordGroup& rhs) noexcept {
+        WordGroup result;
+#if defined(ARCHITECTURE_x86_64)
+        result.lo = _mm_and_si128(lhs.lo, rhs.lo);
+        result.hi = _mm_and_si128(lhs.hi, rhs.hi);
+#elif defined(ARCHITECTURE_arm64)
+        result.lo = vandq_u64(lhs.lo, rhs.lo);
+        result.hi = vandq_u64(lhs.hi, rhs.hi);
+#else
+        for (size_t i = 0; i < WORDS_PER_GROUP; ++i) {
+            result.words[i] = lhs.words[i] & rhs.words[i];
+        }
+#endif
+        return result;
+    }
+
+    [[nodiscard]] friend WordGroup operator|(const WordGroup& lhs, const WordGroup& rhs) noexcept {
+        WordGroup result;
+#if defined(ARCHITECTURE_x86_64)
+        result.lo = _mm_or_si128(lhs.lo, rhs.lo);
+        result.hi = _mm_or_si128(lhs.hi, rhs.hi);
+#elif defined(ARCHITECTURE_arm64)
+        result.lo = vorrq_u64(lhs.lo, rhs.lo);
+        result.hi = vorrq_u64(lhs.hi, rhs.hi);
+#else
+        for (size_t i = 0; i < WORDS_PER_GROUP; ++i) {
+            result.words[i] = lhs.words[i] | rhs.words[i];
+        }
+#endif
+        return result;
+    }
+
+    /// Returns ~lhs & rhs
+    [[nodiscard]] friend WordGroup AndNot(const WordGroup& lhs, const WordGroup& rhs) noexcept {
+        WordGroup result;
+#if defined(ARCHITECTURE_x86_64)
+        result.lo = _mm_andnot_si128(lhs.lo, rhs.lo);
+        result.hi = _mm_andnot_si128(lhs.hi, rhs.hi);
+#elif defined(ARCHITECTURE_arm64)
+        result.lo = vbicq_u64(rhs.lo, lhs.lo);
+        result.hi = vbicq_u64(rhs.hi, lhs.hi);
+#else
+        for (size_t i = 0; i < WORDS_PER_GROUP; ++i) {
+            result.words[i] = ~lhs.words[i] & rhs.words[i];
+        }
+#endif
+        return result;
+    }
+
+private:
+#if defined(ARCHITECTURE_x86_64)
+    __m128i lo;
+    __m128i hi;
+#elif defined(ARCHITECTURE_arm64)
+    uint64x2_t lo;
+    uint64x2_t hi;
+#else
+    std::array<u64, WORDS_PER_GROUP> words;
+#endif
+};
+
+// Single word counterparts of the WordGroup operations, so that range operations can be written
+// once for both the partial words at the edges of a region and the whole groups in between
+
+[[nodiscard]] constexpr bool IsZero(u64 bits) noexcept {
+    return bits == 0;
+}
+
+[[nodiscard]] constexpr bool IsFull(u64 bits) noexcept {
+    return bits == ~u64{0};
+}
+
+/// Returns ~lhs & rhs
+[[nodiscard]] constexpr u64 AndNot(u64 lhs, u64 rhs) noexcept {
+    return ~lhs & rhs;
+}
+
+template <typename Bits>
+[[nodiscard]] Bits LoadBits(const u64* words) noexcept {
+    if constexpr (std::is_same_v<Bits, u64>) {
+        return *words;
+    } else {
+        return WordGroup::Load(words);
+    }
+}
+
+inline void StoreBits(u64* words, u64 bits) noexcept {
+    *words = bits;
+}
+
+inline void StoreBits(u64* words, const WordGroup& bits) noexcept {
+    bits.Store(words);
+}
+
+/// Calls func(word_index, word) for each word of the given bits starting at word_index
+template <typename Func>
+void ForEachWord(size_t word_index, u64 bits, Func&& func) {
+    func(word_index, bits);
+}
+
+template <typename Func>
+void ForEachWord(size_t word_index, const WordGroup& bits, Func&& func) {
+    std::array<u64, WORDS_PER_GROUP> group_words;
+    bits.Store(group_words.data());
+    for (size_t i = 0; i < WORDS_PER_GROUP; ++i) {
+        func(word_index + i, group_words[i]);
+    }
+}
+
+/// Calls a function with the maximal runs of set bits of the words added in ascending order
+template <typename Func>
+class PageRunCollector {
+public:
+    explicit PageRunCollector(Func&& func_) : func{std::move(func_)} {}
+
+    /// Adds the set bits of a word or a group of words starting at word_index
+    template <typename Bits>
+    void Add(size_t word_index, const Bits& bits) {
+        if (IsZero(bits)) {
+            return;
+        }
+        if (IsFull(bits)) {
+            constexpr size_t num_pages = sizeof(Bits) / sizeof(u64) * PAGES_PER_WORD;
+            AddPages(word_index * PAGES_PER_WORD, num_pages);
+            return;
+        }
+        ForEachWord(word_index, bits, [this](size_t index, u64 word) { AddWord(index, word); });
     }
 
-    /// Returns the pointer to the words state
-    [[nodiscard]] u64* Pointer(bool is_short) noexcept {
-        return is_short ? stack.data() : heap;
+    /// Calls the function with the pending run of pages, if any
+    void Flush() {
+        if (pending) {
+            pending = false;
+            func(pending_begin, pending_end);
+        }
     }
 
-    std::array<u64, stack_words> stack{}; ///< Small buffers storage
-    u64* heap;                            ///< Not-small buffers pointer to the storage
+private:
+    void AddWord(size_t word_index, u64 bits) {
+        const size_t base_page = word_index * PAGES_PER_WORD;
+        size_t offset = 0;
+        while (bits != 0) {
+            const size_t empty_bits = std::countr_zero(bits);
+            offset += empty_bits;
+            bits = bits >> empty_bits;
+
+            const size_t continuous_bits = std::countr_one(bits);
+            AddPages(base_page + offset, continuous_bits);
+            bits = continuous_bits < PAGES_PER_WORD ? (bits >> continuous_bits) : 0;
+            offset += continuous_bits;
+        }
+    }
+
+    void AddPages(size_t begin, size_t num_pages) {
+        if (!pending || pending_end != begin) {
+            Flush();
+            pending = true;
+            pending_begin = begin;
+        }
+        pending_end = begin + num_pages;
+    }
+
+    Func func;
+    bool pending = false;
+    size_t pending_begin = 0;
+    size_t pending_end = 0;
 };
 
+/**
+ * Page state words of a buffer with small vector optimization
+ *
+ * The words of every type are interleaved a group at a time: the CPU words of a group are followed
+ * by its GPU, cached CPU, untracked and preflushable words. Operations on a region read and write
+ * several types of the same words, which then share cache lines, while each type can still be
+ * loaded a whole group at a time.
+ */
 template <size_t stack_words = 1>
 struct Words {
+    static constexpr size_t STACK_GROUPS = Common::DivCeil(stack_words, WORDS_PER_GROUP);
+    static constexpr size_t GROUP_STRIDE = WORDS_PER_GROUP * NUM_TYPES;
+
     explicit Words() = default;
     explicit Words(u64 size_bytes_) : size_bytes{size_bytes_} {
         num_words = Common::DivCeil(size_bytes, BYTES_PER_WORD);
-        if (IsShort()) {
-            cpu.stack.fill(~u64{0});
-            gpu.stack.fill(0);
-            cached_cpu.stack.fill(0);
-            untracked.stack.fill(~u64{0});
-            preflushable.stack.fill(0);
-        } else {
-            // Share allocation between CPU and GPU pages and set their default values
-            u64* const alloc = new u64[num_words * 5];
-            cpu.heap = alloc;
-            gpu.heap = alloc + num_words;
-            cached_cpu.heap = alloc + num_words * 2;
-            untracked.heap = alloc + num_words * 3;
-            preflushable.heap = alloc + num_words * 4;
-            std::fill_n(cpu.heap, num_words, ~u64{0});
-            std::fill_n(gpu.heap, num_words, 0);
-            std::fill_n(cached_cpu.heap, num_words, 0);
-            std::fill_n(untracked.heap, num_words, ~u64{0});
-            std::fill_n(preflushable.heap, num_words, 0);
+        if (!IsShort()) {
+            heap = new u64[NumGroups() * GROUP_STRIDE];
+        }
+        // Words past the end of the buffer in the last group are left cleared
+        std::fill_n(Pointer(), NumGroups() * GROUP_STRIDE, u64{0});
+        for (size_t index = 0; index < num_words; ++index) {
+            *At<Type::CPU>(index) = ~u64{0};
+            *At<Type::Untracked>(index) = ~u64{0};
         }
         // Clean up tailing bits
         const u64 last_word_size = size_bytes % BYTES_PER_WORD;
         const u64 last_local_page = Common::DivCeil(last_word_size, BYTES_PER_PAGE);
         const u64 shift = (PAGES_PER_WORD - last_local_page) % PAGES_PER_WORD;
         const u64 last_word = (~u64{0} << shift) >> shift;
-        cpu.Pointer(IsShort())[NumWords() - 1] = last_word;
-        untracked.Pointer(IsShort())[NumWords() - 1] = last_word;
+        *At<Type::CPU>(NumWords() - 1) = last_word;
+        *At<Type::Untracked>(NumWords() - 1) = last_word;
     }
 
     ~Words() {
@@ -88,20 +316,14 @@ struct Words {
         Release();
         size_bytes = rhs.size_bytes;
         num_words = rhs.num_words;
-        cpu = rhs.cpu;
-        gpu = rhs.gpu;
-        cached_cpu = rhs.cached_cpu;
-        untracked = rhs.untracked;
-        preflushable = rhs.preflushable;
-        rhs.cpu.heap = nullptr;
+        stack = rhs.stack;
+        heap = std::exchange(rhs.heap, nullptr);
         return *this;
     }
 
     Words(Words&& rhs) noexcept
-        : size_bytes{rhs.size_bytes}, num_words{rhs.num_words}, cpu{rhs.cpu}, gpu{rhs.gpu},
-          cached_cpu{rhs.cached_cpu}, untracked{rhs.untracked}, preflushable{rhs.preflushable} {
-        rhs.cpu.heap = nullptr;
-    }
+        : size_bytes{rhs.size_bytes}, num_words{rhs.num_words}, stack{rhs.stack},
+          heap{std::exchange(rhs.heap, nullptr)} {}
 
     Words& operator=(const Words&) = delete;
     Words(const Words&) = delete;
@@ -116,51 +338,45 @@ struct Words {
         return num_words;
     }
 
+    /// Returns the number of groups of words of the buffer
+    [[nodiscard]] size_t NumGroups() const noexcept {
+        return Common::DivCeil(num_words, WORDS_PER_GROUP);
+    }
+
     /// Release buffer resources
     void Release() {
         if (!IsShort()) {
-            // CPU written words is the base for the heap allocation
-            delete[] cpu.heap;
+            delete[] heap;
         }
     }
 
+    /// Returns the pointer to a word of the given type, the words of its group follow it
     template <Type type>
-    std::span<u64> Span() noexcept {
-        if constexpr (type == Type::CPU) {
-            return std::span<u64>(cpu.Pointer(IsShort()), num_words);
-        } else if constexpr (type == Type::GPU) {
-            return std::span<u64>(gpu.Pointer(IsShort()), num_words);
-        } else if constexpr (type == Type::CachedCPU) {
-            return std::span<u64>(cached_cpu.Pointer(IsShort()), num_words);
-        } else if constexpr (type == Type::Untracked) {
-            return std::span<u64>(untracked.Pointer(IsShort()), num_words);
-        } else if constexpr (type == Type::Preflushable) {
-            return std::span<u64>(preflushable.Pointer(IsShort()), num_words);
-        }
+    [[nodiscard]] u64* At(size_t index) noexcept {
+        return Pointer() + (index / WORDS_PER_GROUP) * GROUP_STRIDE +
+               static_cast<size_t>(type) * WORDS_PER_GROUP + index % WORDS_PER_GROUP;
     }
 
+    /// Returns the pointer to a word of the given type, the words of its group follow it
     template <Type type>
-    std::span<const u64> Span() const noexcept {
-        if constexpr (type == Type::CPU) {
-            return std::span<const u64>(cpu.Pointer(IsShort()), num_words);
-        } else if constexpr (type == Type::GPU) {
-            return std::span<const u64>(gpu.Pointer(IsShort()), num_words);
-        } else if constexpr (type == Type::CachedCPU) {
-            return std::span<const u64>(cached_cpu.Pointer(IsShort()), num_words);
-        } else if constexpr (type == Type::Untracked) {
-            return std::span<const u64>(untracked.Pointer(IsShort()), num_words);
-        } else if constexpr (type == Type::Preflushable) {
-            return std::span<const u64>(preflushable.Pointer(IsShort()), num_words);
-        }
+    [[nodiscard]] const u64* At(size_t index) const noexcept {
+        return Pointer() + (index / WORDS_PER_GROUP) * GROUP_STRIDE +
+               static_cast<size_t>(type) * WORDS_PER_GROUP + index % WORDS_PER_GROUP;
     }
 
     u64 size_bytes = 0;
     size_t num_words = 0;
-    WordsArray<stack_words> cpu;
-    WordsArray<stack_words> gpu;
-    WordsArray<stack_words> cached_cpu;
-    WordsArray<stack_words> untracked;
-    WordsArray<stack_words> preflushable;
+    std::array<u64, STACK_GROUPS * GROUP_STRIDE> stack{}; ///< Small buffers storage
+    u64* heap = nullptr; ///< Not-small buffers pointer to the storage
+
+private:
+    [[nodiscard]] u64* Pointer() noexcept {
+        return IsShort() ? stack.data() : heap;
+    }
+
+    [[nodiscard]] const u64* Pointer() const noexcept {
+        return IsShort() ? stack.data() : heap;
+    }
 };
 
 template <class DeviceTracker, size_t stack_words = 1>
@@ -179,21 +395,11 @@ public:
         return cpu_addr;
     }
 
-    static u64 ExtractBits(u64 word, size_t page_start, size_t page_end) {
-        constexpr size_t number_bits = sizeof(u64) * 8;
-        const size_t limit_page_end = number_bits - std::min(page_end, number_bits);
-        u64 bits = (word >> page_start) << page_start;
-        bits = (bits << limit_page_end) >> limit_page_end;
-        return bits;
-    }
-
-    static std::pair<size_t, size_t> GetWordPage(VAddr address) {
-        const size_t converted_address = static_cast<size_t>(address);
-        const size_t word_number = converted_address / BYTES_PER_WORD;
-        const size_t amount_pages = converted_address % BYTES_PER_WORD;
-        return std::make_pair(word_number, amount_pages / BYTES_PER_PAGE);
-    }
-
+    /**
+     * Call the given function with the index and mask of the words overlapping a region. Words
+     * are passed one at a time as u64 at the edges of the region and as a WordGroup for each
+     * group it fully covers, the index being the first word of the group.
+     */
     template <typename Func>
     void IterateWords(size_t offset, size_t size, Func&& func) const {
         using FuncReturn = std::invoke_result_t<Func, std::size_t, u64>;
@@ -203,42 +409,46 @@ public:
         if (start >= SizeBytes() || end <= start) {
             return;
         }
-        auto [start_word, start_page] = GetWordPage(start);
-        auto [end_word, end_page] = GetWordPage(end + BYTES_PER_PAGE - 1ULL);
-        const size_t num_words = NumWords();
-        start_word = std::min(start_word, num_words);
-        end_word = std::min(end_word, num_words);
-        const size_t diff = end_word - start_word;
-        end_word += (end_page + PAGES_PER_WORD - 1ULL) / PAGES_PER_WORD;
-        end_word = std::min(end_word, num_words);
-        end_page += diff * PAGES_PER_WORD;
-        constexpr u64 base_mask{~0ULL};
-        for (size_t word_index = start_word; word_index < end_word; word_index++) {
-            const u64 mask = ExtractBits(base_mask, start_page, end_page);
-            start_page = 0;
-            end_page -= PAGES_PER_WORD;
+        const size_t page_begin = start / BYTES_PER_PAGE;
+        const size_t page_end =
+            std::min(Common::DivCeil(end, BYTES_PER_PAGE), NumWords() * PAGES_PER_WORD);
+        const size_t first_word = page_begin / PAGES_PER_WORD;
+        const size_t last_word = (page_end - 1) / PAGES_PER_WORD;
+        const u64 begin_mask = ~u64{0} << (page_begin % PAGES_PER_WORD);
+        const u64 end_mask = ~u64{0} >> (PAGES_PER_WORD - 1 - (page_end - 1) % PAGES_PER_WORD);
+
+        // Only whole groups of whole words take the group path
+        const size_t body_begin = Common::AlignUp(
+            page_begin % PAGES_PER_WORD == 0 ? first_word : first_word + 1, WORDS_PER_GROUP);
+        const size_t body_end = Common::AlignDown(page_end / PAGES_PER_WORD, WORDS_PER_GROUP);
+        const WordGroup full_mask = WordGroup::Fill(~u64{0});
+        for (size_t index = first_word; index <= last_word;) {
+            if (index >= body_begin && index < body_end) {
+                if constexpr (BOOL_BREAK) {
+                    if (func(index, full_mask)) {
+                        return;
+                    }
+                } else {
+                    func(index, full_mask);
+                }
+                index += WORDS_PER_GROUP;
+                continue;
+            }
+            u64 mask = ~u64{0};
+            if (index == first_word) {
+                mask &= begin_mask;
+            }
+            if (index == last_word) {
+                mask &= end_mask;
+            }
             if constexpr (BOOL_BREAK) {
-                if (func(word_index, mask)) {
+                if (func(index, mask)) {
                     return;
                 }
             } else {
-                func(word_index, mask);
+                func(index, mask);
             }
-        }
-    }
-
-    template <typename Func>
-    void IteratePages(u64 mask, Func&& func) const {
-        size_t offset = 0;
-        while (mask != 0) {
-            const size_t empty_bits = std::countr_zero(mask);
-            offset += empty_bits;
-            mask = mask >> empty_bits;
-
-            const size_t continuous_bits = std::countr_one(mask);
-            func(offset, continuous_bits);
-            mask = continuous_bits < PAGES_PER_WORD ? (mask >> continuous_bits) : 0;
-            offset += continuous_bits;
+            ++index;
         }
     }
 
@@ -250,32 +460,36 @@ public:
      */
     template <Type type, bool enable>
     void ChangeRegionState(u64 dirty_addr, u64 size) noexcept(type == Type::GPU) {
-        std::span<u64> state_words = words.template Span<type>();
-        [[maybe_unused]] std::span<u64> untracked_words = words.template Span<Type::Untracked>();
-        [[maybe_unused]] std::span<u64> cached_words = words.template Span<Type::CachedCPU>();
-        IterateWords(dirty_addr - cpu_addr, size, [&](size_t index, u64 mask) {
+        auto notify = MakeRasterizerNotifier<!enable>();
+        IterateWords(dirty_addr - cpu_addr, size, [&](size_t index, const auto& mask) {
+            using Bits = std::decay_t<decltype(mask)>;
+            u64* const state_words = words.template At<type>(index);
+            [[maybe_unused]] u64* const untracked_words = words.template At<Type::Untracked>(index);
+            [[maybe_unused]] u64* const cached_words = words.template At<Type::CachedCPU>(index);
+            const Bits state = LoadBits<Bits>(state_words);
             if constexpr (type == Type::CPU || type == Type::CachedCPU) {
-                NotifyRasterizer<!enable>(index, untracked_words[index], mask);
+                const Bits untracked = LoadBits<Bits>(untracked_words);
+                if constexpr (enable) {
+                    notify.Add(index, AndNot(untracked, mask));
+                    StoreBits(untracked_words, untracked | mask);
+                } else {
+                    notify.Add(index, untracked & mask);
+                    StoreBits(untracked_words, AndNot(mask, untracked));
+                }
             }
             if constexpr (enable) {
-                state_words[index] |= mask;
-                if constexpr (type == Type::CPU || type == Type::CachedCPU) {
-                    untracked_words[index] |= mask;
-                }
+                StoreBits(state_words, state | mask);
                 if constexpr (type == Type::CPU) {
-                    cached_words[index] &= ~mask;
+                    StoreBits(cached_words, AndNot(mask, LoadBits<Bits>(cached_words)));
                 }
             } else {
                 if constexpr (type == Type::CPU) {
-                    const u64 word = state_words[index] & mask;
-                    cached_words[index] &= ~word;
-                }
-                state_words[index] &= ~mask;
-                if constexpr (type == Type::CPU || type == Type::CachedCPU) {
-                    untracked_words[index] &= ~mask;
+                    StoreBits(cached_words, AndNot(state & mask, LoadBits<Bits>(cached_words)));
                 }
+                StoreBits(state_words, AndNot(mask, state));
             }
         });
+        notify.Flush();
     }
 
     /**
@@ -290,56 +504,39 @@ public:
     void ForEachModifiedRange(VAddr query_cpu_range, s64 size, Func&& func) {
         static_assert(type != Type::Untracked);
 
-        std::span<u64> state_words = words.template Span<type>();
-        [[maybe_unused]] std::span<u64> untracked_words = words.template Span<Type::Untracked>();
-        [[maybe_unused]] std::span<u64> cached_words = words.template Span<Type::CachedCPU>();
+        auto notify = MakeRasterizerNotifier<true>();
+        PageRunCollector modified{[&](size_t page_begin, size_t page_end) {
+            // Pages have to be tracked again before they are handed out
+            notify.Flush();
+            func(cpu_addr + page_begin * BYTES_PER_PAGE, (page_end - page_begin) * BYTES_PER_PAGE);
+        }};
         const size_t offset = query_cpu_range - cpu_addr;
-        bool pending = false;
-        size_t pending_offset{};
-        size_t pending_pointer{};
-        const auto release = [&]() {
-            func(cpu_addr + pending_offset * BYTES_PER_PAGE,
-                 (pending_pointer - pending_offset) * BYTES_PER_PAGE);
-        };
-        IterateWords(offset, size, [&](size_t index, u64 mask) {
+        IterateWords(offset, size, [&](size_t index, const auto& region_mask) {
+            using Bits = std::decay_t<decltype(region_mask)>;
+            u64* const state_words = words.template At<type>(index);
+            [[maybe_unused]] u64* const untracked_words = words.template At<Type::Untracked>(index);
+            [[maybe_unused]] u64* const cached_words = words.template At<Type::CachedCPU>(index);
+            Bits mask = region_mask;
             if constexpr (type == Type::GPU) {
-                mask &= ~untracked_words[index];
+                mask = AndNot(LoadBits<Bits>(untracked_words), mask);
             }
-            const u64 word = state_words[index] & mask;
+            const Bits state = LoadBits<Bits>(state_words);
+            const Bits word = state & mask;
             if constexpr (clear) {
                 if constexpr (type == Type::CPU || type == Type::CachedCPU) {
-                    NotifyRasterizer<true>(index, untracked_words[index], mask);
-                }
-                state_words[index] &= ~mask;
-                if constexpr (type == Type::CPU || type == Type::CachedCPU) {
-                    untracked_words[index] &= ~mask;
+                    const Bits untracked = LoadBits<Bits>(untracked_words);
+                    notify.Add(index, untracked & mask);
+                    StoreBits(untracked_words, AndNot(mask, untracked));
                 }
+                StoreBits(state_words, AndNot(mask, state));
                 if constexpr (type == Type::CPU) {
-                    cached_words[index] &= ~word;
+                    StoreBits(cached_words, AndNot(word, LoadBits<Bits>(cached_words)));
                 }
             }
-            const size_t base_offset = index * PAGES_PER_WORD;
-            IteratePages(word, [&](size_t pages_offset, size_t pages_size) {
-                const auto reset = [&]() {
-                    pending_offset = base_offset + pages_offset;
-                    pending_pointer = base_offset + pages_offset + pages_size;
-                };
-                if (!pending) {
-                    reset();
-                    pending = true;
-                    return;
-                }
-                if (pending_pointer == base_offset + pages_offset) {
-                    pending_pointer += pages_size;
-                    return;
-                }
-                release();
-                reset();
-            });
+            modified.Add(index, word);
         });
-        if (pending) {
-            release();
-        }
+        modified.Flush();
+        notify.Flush();
     }
 
     /**
@@ -352,16 +549,14 @@ public:
     [[nodiscard]] bool IsRegionModified(u64 offset, u64 size) const noexcept {
         static_assert(type != Type::Untracked);
 
-        const std::span<const u64> state_words = words.template Span<type>();
-        [[maybe_unused]] const std::span<const u64> untracked_words =
-            words.template Span<Type::Untracked>();
         bool result = false;
-        IterateWords(offset, size, [&](size_t index, u64 mask) {
+        IterateWords(offset, size, [&](size_t index, const auto& mask) {
+            using Bits = std::decay_t<decltype(mask)>;
+            Bits word = LoadBits<Bits>(words.template At<type>(index)) & mask;
             if constexpr (type == Type::GPU) {
-                mask &= ~untracked_words[index];
+                word = AndNot(LoadBits<Bits>(words.template At<Type::Untracked>(index)), word);
             }
-            const u64 word = state_words[index] & mask;
-            if (word != 0) {
+            if (!IsZero(word)) {
                 result = true;
                 return true;
             }
@@ -379,24 +574,27 @@ public:
     template <Type type>
     [[nodiscard]] std::pair<u64, u64> ModifiedRegion(u64 offset, u64 size) const noexcept {
         static_assert(type != Type::Untracked);
-        const std::span<const u64> state_words = words.template Span<type>();
-        [[maybe_unused]] const std::span<const u64> untracked_words =
-            words.template Span<Type::Untracked>();
         u64 begin = std::numeric_limits<u64>::max();
         u64 end = 0;
-        IterateWords(offset, size, [&](size_t index, u64 mask) {
+        IterateWords(offset, size, [&](size_t index, const auto& mask) {
+            using Bits = std::decay_t<decltype(mask)>;
+            Bits bits = LoadBits<Bits>(words.template At<type>(index)) & mask;
             if constexpr (type == Type::GPU) {
-                mask &= ~untracked_words[index];
+                bits = AndNot(LoadBits<Bits>(words.template At<Type::Untracked>(index)), bits);
             }
-            const u64 word = state_words[index] & mask;
-            if (word == 0) {
+            if (IsZero(bits)) {
                 return;
             }
-            const u64 local_page_begin = std::countr_zero(word);
-            const u64 local_page_end = PAGES_PER_WORD - std::countl_zero(word);
-            const u64 page_index = index * PAGES_PER_WORD;
-            begin = std::min(begin, page_index + local_page_begin);
-            end = page_index + local_page_end;
+            ForEachWord(index, bits, [&](size_t word_index, u64 word) {
+                if (word == 0) {
+                    return;
+                }
+                const u64 local_page_begin = std::countr_zero(word);
+                const u64 local_page_end = PAGES_PER_WORD - std::countl_zero(word);
+                const u64 page_index = word_index * PAGES_PER_WORD;
+                begin = std::min(begin, page_index + local_page_begin);
+                end = page_index + local_page_end;
+            });
         });
         static constexpr std::pair<u64, u64> EMPTY{0, 0};
         return begin < end ? std::make_pair(begin * BYTES_PER_PAGE, end * BYTES_PER_PAGE) : EMPTY;
@@ -418,63 +616,39 @@ public:
     }
 
     void FlushCachedWrites() noexcept {
-        const u64 num_words = NumWords();
-        u64* const cached_words = Array<Type::CachedCPU>();
-        u64* const untracked_words = Array<Type::Untracked>();
-        u64* const cpu_words = Array<Type::CPU>();
-        for (u64 word_index = 0; word_index < num_words; ++word_index) {
-            const u64 cached_bits = cached_words[word_index];
-            NotifyRasterizer<false>(word_index, untracked_words[word_index], cached_bits);
-            untracked_words[word_index] |= cached_bits;
-            cpu_words[word_index] |= cached_bits;
-            cached_words[word_index] = 0;
+        auto notify = MakeRasterizerNotifier<false>();
+        const size_t num_words = NumWords();
+        for (size_t index = 0; index < num_words; index += WORDS_PER_GROUP) {
+            u64* const cached_words = words.template At<Type::CachedCPU>(index);
+            const WordGroup cached = WordGroup::Load(cached_words);
+            if (IsZero(cached)) {
+                continue;
+            }
+            u64* const untracked_words = words.template At<Type::Untracked>(index);
+            u64* const cpu_words = words.template At<Type::CPU>(index);
+            const WordGroup untracked = WordGroup::Load(untracked_words);
+            notify.Add(index, AndNot(untracked, cached));
+            (untracked | cached).Store(untracked_words);
+            (WordGroup::Load(cpu_words) | cached).Store(cpu_words);
+            WordGroup::Fill(0).Store(cached_words);
         }
+        notify.Flush();
     }
 
 private:
-    template <Type type>
-    u64* Array() noexcept {
-        if constexpr (type == Type::CPU) {
-            return words.cpu.Pointer(IsShort());
-        } else if constexpr (type == Type::GPU) {
-            return words.gpu.Pointer(IsShort());
-        } else if constexpr (type == Type::CachedCPU) {
-            return words.cached_cpu.Pointer(IsShort());
-        } else if constexpr (type == Type::Untracked) {
-            return words.untracked.Pointer(IsShort());
-        }
-    }
-
-    template <Type type>
-    const u64* Array() const noexcept {
-        if constexpr (type == Type::CPU) {
-            return words.cpu.Pointer(IsShort());
-        } else if constexpr (type == Type::GPU) {
-            return words.gpu.Pointer(IsShort());
-        } else if constexpr (type == Type::CachedCPU) {
-            return words.cached_cpu.Pointer(IsShort());
-        } else if constexpr (type == Type::Untracked) {
-            return words.untracked.Pointer(IsShort());
-        }
-    }
-
     /**
-     * Notify tracker about changes in the CPU tracking state of a word in the buffer
-     *
-     * @param word_index   Index to the word to notify to the tracker
-     * @param current_bits Current state of the word
-     * @param new_bits     New state of the word
+     * Returns a collector notifying the tracker about changes in the CPU tracking state of the
+     * pages added to it, adjacent pages are notified at once
      *
-     * @tparam add_to_tracker True when the tracker should start tracking the new pages
+     * @tparam add_to_tracker True when the tracker should start tracking the pages
      */
     template <bool add_to_tracker>
-    void NotifyRasterizer(u64 word_index, u64 current_bits, u64 new_bits) const {
-        u64 changed_bits = (add_to_tracker ? current_bits : ~current_bits) & new_bits;
-        VAddr addr = cpu_addr + word_index * BYTES_PER_WORD;
-        IteratePages(changed_bits, [&](size_t offset, size_t size) {
-            tracker->UpdatePagesCachedCount(addr + offset * BYTES_PER_PAGE, size * BYTES_PER_PAGE,
+    auto MakeRasterizerNotifier() const {
+        return PageRunCollector{[this](size_t page_begin, size_t page_end) {
+            tracker->UpdatePagesCachedCount(cpu_addr + page_begin * BYTES_PER_PAGE,
+                                            (page_end - page_begin) * BYTES_PER_PAGE,
                                             add_to_tracker ? 1 : -1);
-        });
+        }};
     }
 
     VAddr cpu_addr = 0;
@@ -24,9 +24,9 @@ constexpr u32 MacroRegistersStart = 0xE00;
 
 Maxwell3D::Maxwell3D(Core::System& system_, MemoryManager& memory_manager_)
     : draw_manager{std::make_unique<DrawManager>(this)}, system{system_},
-      memory_manager{memory_manager_}, macro_engine{GetMacroEngine(*this)}, upload_state{
-                                                                                memory_manager,
-                                                                                regs.upload} {
+      memory_manager{memory_manager_},
+      macro_engine{GetMacroEngine(*this, system.GPU().MacroProfiler())},
+      upload_state{memory_manager, regs.upload} {
     dirty.flags.flip();
     InitializeRegisterDefaults();
     execution_mask.reset();
@@ -201,25 +201,41 @@ void Maxwell3D::ProcessMacro(u32 method, const u32* base_start, u32 amount, bool
         executing_macro = method;
     }
 
-    macro_params.insert(macro_params.end(), base_start, base_start + amount);
-    for (size_t i = 0; i < amount; i++) {
-        macro_addresses.push_back(current_dma_segment + i * sizeof(u32));
-    }
     macro_segments.emplace_back(current_dma_segment, amount);
     current_macro_dirty |= current_dirty;
     current_dirty = false;
 
+    // Parameters sent in a single call are read in place from the command list, unless they have
+    // to be refreshed from memory while the macro runs
+    if (is_last_call && macro_params.empty() && !current_macro_dirty) {
+        ConsumeSink();
+        CallMacroMethod(executing_macro, std::span<const u32>(base_start, amount));
+        macro_segments.clear();
+        return;
+    }
+
+    macro_params.insert(macro_params.end(), base_start, base_start + amount);
+
     // Call the macro when there are no more parameters in the command buffer
     if (is_last_call) {
         ConsumeSink();
         CallMacroMethod(executing_macro, macro_params);
         macro_params.clear();
-        macro_addresses.clear();
         macro_segments.clear();
         current_macro_dirty = false;
     }
 }
 
+GPUVAddr Maxwell3D::GetMacroAddress(size_t index) const {
+    for (const auto& [segment_address, segment_size] : macro_segments) {
+        if (index < segment_size) {
+            return segment_address + index * sizeof(u32);
+        }
+        index -= segment_size;
+    }
+    return 0;
+}
+
 void Maxwell3D::RefreshParametersImpl() {
     if (!Settings::IsGPULevelHigh()) {
         return;
@@ -396,7 +412,7 @@ void Maxwell3D::ProcessMethodCall(u32 method, u32 argument, u32 nonshadow_argume
     }
 }
 
-void Maxwell3D::CallMacroMethod(u32 method, const std::vector<u32>& parameters) {
+void Maxwell3D::CallMacroMethod(u32 method, std::span<const u32> parameters) {
     // Reset the current macro.
     executing_macro = 0;
 
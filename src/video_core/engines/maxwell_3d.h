@@ -8,6 +8,7 @@
 #include <cmath>
 #include <limits>
 #include <optional>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -3102,9 +3103,7 @@ public:
     std::unique_ptr<DrawManager> draw_manager;
     friend class DrawManager;
 
-    GPUVAddr GetMacroAddress(size_t index) const {
-        return macro_addresses[index];
-    }
+    GPUVAddr GetMacroAddress(size_t index) const;
 
     void RefreshParameters() {
         if (!current_macro_dirty) {
@@ -3156,7 +3155,7 @@ private:
      * @param method Method to call
      * @param parameters Arguments to the method call
      */
-    void CallMacroMethod(u32 method, const std::vector<u32>& parameters);
+    void CallMacroMethod(u32 method, std::span<const u32> parameters);
 
     /// Handles writes to the macro uploading register.
     void ProcessMacroUpload(u32 data);
@@ -3207,7 +3206,6 @@ private:
     bool execute_on{true};
 
     std::vector<std::pair<GPUVAddr, size_t>> macro_segments;
-    std::vector<GPUVAddr> macro_addresses;
     bool current_macro_dirty{};
 };
 
@@ -30,6 +30,7 @@
 #include "video_core/gpu_thread.h"
 #include "video_core/host1x/host1x.h"
 #include "video_core/host1x/syncpoint_manager.h"
+#include "video_core/macro/macro.h"
 #include "video_core/memory_manager.h"
 #include "video_core/renderer_base.h"
 #include "video_core/shader_notify.h"
@@ -39,7 +40,8 @@ namespace Tegra {
 struct GPU::Impl {
     explicit Impl(GPU& gpu_, Core::System& system_, bool is_async_, bool use_nvdec_)
         : gpu{gpu_}, system{system_}, host1x{system.Host1x()}, use_nvdec{use_nvdec_},
-          shader_notify{std::make_unique<VideoCore::ShaderNotify>()}, is_async{is_async_},
+          shader_notify{std::make_unique<VideoCore::ShaderNotify>()},
+          macro_profiler{std::make_unique<Tegra::MacroProfiler>()}, is_async{is_async_},
           gpu_thread{system_, is_async_}, scheduler{std::make_unique<Control::Scheduler>(gpu)} {}
 
     ~Impl() = default;
@@ -196,6 +198,11 @@ struct GPU::Impl {
         return *shader_notify;
     }
 
+    /// Returns a reference to the macro profiler shared by the channels.
+    [[nodiscard]] Tegra::MacroProfiler& MacroProfiler() {
+        return *macro_profiler;
+    }
+
     [[nodiscard]] u64 GetTicks() const {
         u64 gpu_tick = system.CoreTiming().GetGPUTicks();
 
@@ -345,6 +352,8 @@ struct GPU::Impl {
     s32 new_channel_id{1};
     /// Shader build notifier
     std::unique_ptr<VideoCore::ShaderNotify> shader_notify;
+    /// Macro execution statistics of every channel
+    std::unique_ptr<Tegra::MacroProfiler> macro_profiler;
     /// When true, we are about to shut down emulation session, so terminate outstanding tasks
     std::atomic_bool shutting_down{};
 
@@ -486,6 +495,10 @@ const VideoCore::ShaderNotify& GPU::ShaderNotify() const {
     return impl->ShaderNotify();
 }
 
+Tegra::MacroProfiler& GPU::MacroProfiler() {
+    return impl->MacroProfiler();
+}
+
 void GPU::RequestComposite(std::vector<Tegra::FramebufferConfig>&& layers,
                            std::vector<Service::Nvidia::NvFence>&& fences) {
     impl->RequestComposite(std::move(layers), std::move(fences));
@@ -1,10 +1,15 @@
 // SPDX-FileCopyrightText: Copyright 2020 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <cstring>
 #include <fstream>
+#include <mutex>
 #include <optional>
 #include <span>
+#include <vector>
 
 #include "common/container_hash.h"
 
@@ -24,6 +29,7 @@
 #endif
 
 MICROPROFILE_DEFINE(MacroHLE, "GPU", "Execute macro HLE", MP_RGB(128, 192, 192));
+MICROPROFILE_DEFINE(MacroLLE, "GPU", "Execute macro LLE", MP_RGB(192, 128, 192));
 
 namespace Tegra {
 
@@ -54,8 +60,74 @@ static void Dump(u64 hash, std::span<const u32> code, bool decompiled = false) {
     macro_file.write(reinterpret_cast<const char*>(code.data()), code.size_bytes());
 }
 
-MacroEngine::MacroEngine(Engines::Maxwell3D& maxwell3d_)
-    : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d_)}, maxwell3d{maxwell3d_} {}
+void MacroProfiler::Entry::Record(size_t num_parameters, std::chrono::nanoseconds time) {
+    const size_t bucket = num_parameters == 0 ? 0 : 1 + std::bit_width(num_parameters - 1);
+    ++parameter_histogram[std::min(bucket, NUM_BUCKETS - 1)];
+    ++num_calls;
+    total_time += time;
+}
+
+MacroProfiler::MacroProfiler() = default;
+
+MacroProfiler::~MacroProfiler() {
+    if (!entries.empty()) {
+        Dump();
+    }
+}
+
+MacroProfiler::Entry& MacroProfiler::GetEntry(u64 hash, u32 method, bool is_hle) {
+    std::scoped_lock lk{mutex};
+    const auto [it, is_new] = entries.try_emplace(hash);
+    if (is_new) {
+        it->second.method = method;
+        it->second.is_hle = is_hle;
+    }
+    return it->second;
+}
+
+void MacroProfiler::Dump() const {
+    const auto base_dir{Common::FS::GetSudachiPath(Common::FS::SudachiPath::DumpDir)};
+    const auto macro_dir{base_dir / "macros"};
+    if (!Common::FS::CreateDir(base_dir) || !Common::FS::CreateDir(macro_dir)) {
+        LOG_ERROR(Common_Filesystem, "Failed to create macro dump directories");
+        return;
+    }
+    const auto name{macro_dir / "profile.csv"};
+    std::fstream report(name, std::ios::out | std::ios::trunc);
+    if (!report) {
+        LOG_ERROR(Common_Filesystem, "Unable to open or create file at {}",
+                  Common::FS::PathToUTF8String(name));
+        return;
+    }
+
+    std::scoped_lock lk{mutex};
+
+    // Most expensive macros first, those are the best candidates to implement in HLE
+    std::vector<std::pair<u64, const Entry*>> sorted_entries;
+    for (const auto& [hash, entry] : entries) {
+        sorted_entries.emplace_back(hash, &entry);
+    }
+    std::ranges::sort(sorted_entries, [](const auto& lhs, const auto& rhs) {
+        return lhs.second->total_time > rhs.second->total_time;
+    });
+
+    report << "hash,method,hle,calls,total_us,average_ns,params_0,params_1,params_2,params_3_4,"
+              "params_5_8,params_9_16,params_17_32,params_33_64,params_65_plus\n";
+    for (const auto& [hash, entry] : sorted_entries) {
+        const auto total_ns = static_cast<u64>(entry->total_time.count());
+        report << fmt::format("{:016x},0x{:x},{},{},{},{}", hash, entry->method,
+                              entry->is_hle ? 1 : 0, entry->num_calls, total_ns / 1000,
+                              entry->num_calls != 0 ? total_ns / entry->num_calls : 0);
+        for (const u64 count : entry->parameter_histogram) {
+            report << fmt::format(",{}", count);
+        }
+        report << '\n';
+    }
+}
+
+MacroEngine::MacroEngine(Engines::Maxwell3D& maxwell3d_, MacroProfiler& profiler_)
+    : hle_macros{std::make_unique<Tegra::HLEMacro>(maxwell3d_)}, maxwell3d{maxwell3d_},
+      profiler{profiler_} {}
 
 MacroEngine::~MacroEngine() = default;
 
@@ -68,74 +140,91 @@ void MacroEngine::ClearCode(u32 method) {
     uploaded_macro_code.erase(method);
 }
 
-void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
-    auto compiled_macro = macro_cache.find(method);
-    if (compiled_macro != macro_cache.end()) {
-        const auto& cache_info = compiled_macro->second;
-        if (cache_info.has_hle_program) {
-            MICROPROFILE_SCOPE(MacroHLE);
-            cache_info.hle_program->Execute(parameters, method);
-        } else {
-            maxwell3d.RefreshParameters();
-            cache_info.lle_program->Execute(parameters, method);
-        }
+void MacroEngine::Execute(u32 method, std::span<const u32> parameters) {
+    const auto compiled_macro = macro_cache.find(method);
+    CacheInfo* const cache_info =
+        compiled_macro != macro_cache.end() ? &compiled_macro->second : CompileMacro(method);
+    if (!cache_info) {
+        return;
+    }
+    if (!cache_info->profile) [[likely]] {
+        ExecuteProgram(*cache_info, method, parameters);
+        return;
+    }
+    const auto start_time = std::chrono::steady_clock::now();
+    ExecuteProgram(*cache_info, method, parameters);
+    const auto end_time = std::chrono::steady_clock::now();
+
+    cache_info->profile->Record(parameters.size(), end_time - start_time);
+}
+
+void MacroEngine::ExecuteProgram(const CacheInfo& cache_info, u32 method,
+                                 std::span<const u32> parameters) {
+    if (cache_info.has_hle_program) {
+        MICROPROFILE_SCOPE(MacroHLE);
+        cache_info.hle_program->Execute(parameters, method);
     } else {
-        // Macro not compiled, check if it's uploaded and if so, compile it
-        std::optional<u32> mid_method;
-        const auto macro_code = uploaded_macro_code.find(method);
-        if (macro_code == uploaded_macro_code.end()) {
-            for (const auto& [method_base, code] : uploaded_macro_code) {
-                if (method >= method_base && (method - method_base) < code.size()) {
-                    mid_method = method_base;
-                    break;
-                }
-            }
-            if (!mid_method.has_value()) {
-                ASSERT_MSG(false, "Macro 0x{0:x} was not uploaded", method);
-                return;
+        MICROPROFILE_SCOPE(MacroLLE);
+        maxwell3d.RefreshParameters();
+        cache_info.lle_program->Execute(parameters, method);
+    }
+}
+
+MacroEngine::CacheInfo* MacroEngine::CompileMacro(u32 method) {
+    // Macro not compiled, check if it's uploaded and if so, compile it
+    std::optional<u32> mid_method;
+    const auto macro_code = uploaded_macro_code.find(method);
+    if (macro_code == uploaded_macro_code.end()) {
+        for (const auto& [method_base, code] : uploaded_macro_code) {
+            if (method >= method_base && (method - method_base) < code.size()) {
+                mid_method = method_base;
+                break;
             }
         }
-        auto& cache_info = macro_cache[method];
-
         if (!mid_method.has_value()) {
-            cache_info.lle_program = Compile(macro_code->second);
-            cache_info.hash = Common::HashValue(macro_code->second);
-        } else {
-            const auto& macro_cached = uploaded_macro_code[mid_method.value()];
-            const auto rebased_method = method - mid_method.value();
-            auto& code = uploaded_macro_code[method];
-            code.resize(macro_cached.size() - rebased_method);
-            std::memcpy(code.data(), macro_cached.data() + rebased_method,
-                        code.size() * sizeof(u32));
-            cache_info.hash = Common::HashValue(code);
-            cache_info.lle_program = Compile(code);
+            ASSERT_MSG(false, "Macro 0x{0:x} was not uploaded", method);
+            return nullptr;
         }
+    }
+    auto& cache_info = macro_cache[method];
 
-        auto hle_program = hle_macros->GetHLEProgram(cache_info.hash);
-        if (!hle_program || Settings::values.disable_macro_hle) {
-            maxwell3d.RefreshParameters();
-            cache_info.lle_program->Execute(parameters, method);
-        } else {
-            cache_info.has_hle_program = true;
-            cache_info.hle_program = std::move(hle_program);
-            MICROPROFILE_SCOPE(MacroHLE);
-            cache_info.hle_program->Execute(parameters, method);
-        }
+    if (!mid_method.has_value()) {
+        cache_info.lle_program = Compile(macro_code->second);
+        cache_info.hash = Common::HashValue(macro_code->second);
+    } else {
+        const auto& macro_cached = uploaded_macro_code[mid_method.value()];
+        const auto rebased_method = method - mid_method.value();
+        auto& code = uploaded_macro_code[method];
+        code.resize(macro_cached.size() - rebased_method);
+        std::memcpy(code.data(), macro_cached.data() + rebased_method, code.size() * sizeof(u32));
+        cache_info.hash = Common::HashValue(code);
+        cache_info.lle_program = Compile(code);
+    }
 
-        if (Settings::values.dump_macros) {
-            Dump(cache_info.hash, macro_code->second, cache_info.has_hle_program);
-        }
+    auto hle_program = hle_macros->GetHLEProgram(cache_info.hash);
+    if (hle_program && !Settings::values.disable_macro_hle) {
+        cache_info.has_hle_program = true;
+        cache_info.hle_program = std::move(hle_program);
+    }
+
+    if (Settings::values.dump_macros) {
+        Dump(cache_info.hash, uploaded_macro_code[method], cache_info.has_hle_program);
+
+        cache_info.profile =
+            &profiler.GetEntry(cache_info.hash, method, cache_info.has_hle_program);
     }
+    return &cache_info;
 }
 
-std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d) {
+std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d,
+                                            MacroProfiler& profiler) {
     if (Settings::values.disable_macro_jit) {
-        return std::make_unique<MacroInterpreter>(maxwell3d);
+        return std::make_unique<MacroInterpreter>(maxwell3d, profiler);
     }
 #ifdef ARCHITECTURE_x86_64
-    return std::make_unique<MacroJITx64>(maxwell3d);
+    return std::make_unique<MacroJITx64>(maxwell3d, profiler);
 #else
-    return std::make_unique<MacroInterpreter>(maxwell3d);
+    return std::make_unique<MacroInterpreter>(maxwell3d, profiler);
 #endif
 }
 
@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <unordered_map>
 #include <vector>
 #include "common/bit_field.h"
@@ -106,12 +110,45 @@ public:
      * @param parameters The parameters of the macro
      * @param method     The method to execute
      */
-    virtual void Execute(const std::vector<u32>& parameters, u32 method) = 0;
+    virtual void Execute(std::span<const u32> parameters, u32 method) = 0;
+};
+
+/// Execution statistics of the macros run by every GPU channel, collected while macro dumping is
+/// enabled. They are written to the macro dump directory when the profiler is destroyed.
+class MacroProfiler {
+public:
+    /// Statistics of a macro, shared by every engine that runs the same code
+    struct Entry {
+        static constexpr size_t NUM_BUCKETS = 9;
+
+        u32 method{};
+        bool is_hle{};
+        u64 num_calls{};
+        std::chrono::nanoseconds total_time{};
+        /// Calls by number of parameters, in buckets of 0, 1, 2, 3-4, 5-8, ..., 33-64 and 65 or
+        /// more
+        std::array<u64, NUM_BUCKETS> parameter_histogram{};
+
+        void Record(size_t num_parameters, std::chrono::nanoseconds time);
+    };
+
+    MacroProfiler();
+    ~MacroProfiler();
+
+    /// Returns the statistics of the macro with the given hash, valid as long as the profiler
+    Entry& GetEntry(u64 hash, u32 method, bool is_hle);
+
+    /// Writes the statistics collected so far to the macro dump directory
+    void Dump() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<u64, Entry> entries;
 };
 
 class MacroEngine {
 public:
-    explicit MacroEngine(Engines::Maxwell3D& maxwell3d);
+    explicit MacroEngine(Engines::Maxwell3D& maxwell3d, MacroProfiler& profiler);
     virtual ~MacroEngine();
 
     // Store the uploaded macro code to compile them when they're called.
@@ -121,7 +158,7 @@ public:
     void ClearCode(u32 method);
 
     // Compiles the macro if its not in the cache, and executes the compiled macro
-    void Execute(u32 method, const std::vector<u32>& parameters);
+    void Execute(u32 method, std::span<const u32> parameters);
 
 protected:
     virtual std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) = 0;
@@ -132,14 +169,21 @@ private:
         std::unique_ptr<CachedMacro> hle_program{};
         u64 hash{};
         bool has_hle_program{};
+        MacroProfiler::Entry* profile{};
     };
 
+    CacheInfo* CompileMacro(u32 method);
+
+    void ExecuteProgram(const CacheInfo& cache_info, u32 method, std::span<const u32> parameters);
+
     std::unordered_map<u32, CacheInfo> macro_cache;
     std::unordered_map<u32, std::vector<u32>> uploaded_macro_code;
     std::unique_ptr<HLEMacro> hle_macros;
     Engines::Maxwell3D& maxwell3d;
+    MacroProfiler& profiler;
 };
 
-std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d);
+std::unique_ptr<MacroEngine> GetMacroEngine(Engines::Maxwell3D& maxwell3d,
+                                            MacroProfiler& profiler);
 
 } // namespace Tegra
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <optional>
+#include <span>
 
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -19,7 +20,7 @@ public:
     explicit MacroInterpreterImpl(Engines::Maxwell3D& maxwell3d_, const std::vector<u32>& code_)
         : maxwell3d{maxwell3d_}, code{code_} {}
 
-    void Execute(const std::vector<u32>& params, u32 method) override;
+    void Execute(std::span<const u32> params, u32 method) override;
 
 private:
     /// Resets the execution engine state, zeroing registers, etc.
@@ -79,9 +80,7 @@ private:
     Macro::MethodAddress method_address = {};
 
     /// Input parameters of the current macro.
-    std::unique_ptr<u32[]> parameters;
-    std::size_t num_parameters = 0;
-    std::size_t parameters_capacity = 0;
+    std::span<const u32> parameters;
     /// Index of the next parameter that will be fetched by the 'parm' instruction.
     u32 next_parameter_index = 0;
 
@@ -89,18 +88,12 @@ private:
     const std::vector<u32>& code;
 };
 
-void MacroInterpreterImpl::Execute(const std::vector<u32>& params, u32 method) {
+void MacroInterpreterImpl::Execute(std::span<const u32> params, u32 method) {
     MICROPROFILE_SCOPE(MacroInterp);
     Reset();
 
     registers[1] = params[0];
-    num_parameters = params.size();
-
-    if (num_parameters > parameters_capacity) {
-        parameters_capacity = num_parameters;
-        parameters = std::make_unique<u32[]>(num_parameters);
-    }
-    std::memcpy(parameters.get(), params.data(), num_parameters * sizeof(u32));
+    parameters = params;
 
     // Execute the code until we hit an exit condition.
     bool keep_executing = true;
@@ -109,7 +102,7 @@ void MacroInterpreterImpl::Execute(const std::vector<u32>& params, u32 method) {
     }
 
     // Assert the the macro used all the input parameters
-    ASSERT(next_parameter_index == num_parameters);
+    ASSERT(next_parameter_index == parameters.size());
 }
 
 void MacroInterpreterImpl::Reset() {
@@ -117,7 +110,7 @@ void MacroInterpreterImpl::Reset() {
     pc = 0;
     delayed_pc = {};
     method_address.raw = 0;
-    num_parameters = 0;
+    parameters = {};
     // The next parameter index starts at 1, because $r1 already has the value of the first
     // parameter.
     next_parameter_index = 1;
@@ -348,13 +341,13 @@ u32 MacroInterpreterImpl::Read(u32 method) const {
 }
 
 u32 MacroInterpreterImpl::FetchParameter() {
-    ASSERT(next_parameter_index < num_parameters);
+    ASSERT(next_parameter_index < parameters.size());
     return parameters[next_parameter_index++];
 }
 } // Anonymous namespace
 
-MacroInterpreter::MacroInterpreter(Engines::Maxwell3D& maxwell3d_)
-    : MacroEngine{maxwell3d_}, maxwell3d{maxwell3d_} {}
+MacroInterpreter::MacroInterpreter(Engines::Maxwell3D& maxwell3d_, MacroProfiler& profiler_)
+    : MacroEngine{maxwell3d_, profiler_}, maxwell3d{maxwell3d_} {}
 
 std::unique_ptr<CachedMacro> MacroInterpreter::Compile(const std::vector<u32>& code) {
     return std::make_unique<MacroInterpreterImpl>(maxwell3d, code);
@@ -52,7 +52,7 @@ public:
         Compile();
     }
 
-    void Execute(const std::vector<u32>& parameters, u32 method) override;
+    void Execute(std::span<const u32> parameters, u32 method) override;
 
     void Compile_ALU(Macro::Opcode opcode);
     void Compile_AddImmediate(Macro::Opcode opcode);
@@ -108,7 +108,7 @@ private:
     Engines::Maxwell3D& maxwell3d;
 };
 
-void MacroJITx64Impl::Execute(const std::vector<u32>& parameters, u32 method) {
+void MacroJITx64Impl::Execute(std::span<const u32> parameters, u32 method) {
     MICROPROFILE_SCOPE(MacroJitExecute);
     ASSERT_OR_EXECUTE(program != nullptr, { return; });
     JITState state{};
@@ -662,8 +662,8 @@ Macro::Opcode MacroJITx64Impl::GetOpCode() const {
 }
 } // Anonymous namespace
 
-MacroJITx64::MacroJITx64(Engines::Maxwell3D& maxwell3d_)
-    : MacroEngine{maxwell3d_}, maxwell3d{maxwell3d_} {}
+MacroJITx64::MacroJITx64(Engines::Maxwell3D& maxwell3d_, MacroProfiler& profiler_)
+    : MacroEngine{maxwell3d_, profiler_}, maxwell3d{maxwell3d_} {}
 
 std::unique_ptr<CachedMacro> MacroJITx64::Compile(const std::vector<u32>& code) {
     return std::make_unique<MacroJITx64Impl>(maxwell3d, code);
@@ -14,7 +14,7 @@ class Maxwell3D;
 
 class MacroJITx64 final : public MacroEngine {
 public:
-    explicit MacroJITx64(Engines::Maxwell3D& maxwell3d_);
+    explicit MacroJITx64(Engines::Maxwell3D& maxwell3d_, MacroProfiler& profiler_);
 
 protected:
     std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) override;
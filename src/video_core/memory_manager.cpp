@@ -368,6 +368,13 @@ inline void MemoryManager::MemoryOperation(GPUVAddr gpu_src_addr, std::size_t si
 template <bool is_safe>
 void MemoryManager::ReadBlockImpl(GPUVAddr gpu_src_addr, void* dest_buffer, std::size_t size,
                                   [[maybe_unused]] VideoCommon::CacheType which) const {
+    if (const auto dev_addr = GpuToCpuRange(gpu_src_addr, size)) [[likely]] {
+        if constexpr (is_safe) {
+            rasterizer->FlushRegion(*dev_addr, size, which);
+        }
+        memory.ReadBlockUnsafe(*dev_addr, dest_buffer, size);
+        return;
+    }
     auto set_to_zero = [&]([[maybe_unused]] std::size_t page_index,
                            [[maybe_unused]] std::size_t offset, std::size_t copy_amount) {
         std::memset(dest_buffer, 0, copy_amount);
@@ -418,6 +425,13 @@ void MemoryManager::ReadBlockUnsafe(GPUVAddr gpu_src_addr, void* dest_buffer,
 template <bool is_safe>
 void MemoryManager::WriteBlockImpl(GPUVAddr gpu_dest_addr, const void* src_buffer, std::size_t size,
                                    [[maybe_unused]] VideoCommon::CacheType which) {
+    if (const auto dev_addr = GpuToCpuRange(gpu_dest_addr, size)) [[likely]] {
+        if constexpr (is_safe) {
+            rasterizer->InvalidateRegion(*dev_addr, size, which);
+        }
+        memory.WriteBlockUnsafe(*dev_addr, src_buffer, size);
+        return;
+    }
     auto just_advance = [&]([[maybe_unused]] std::size_t page_index,
                             [[maybe_unused]] std::size_t offset, std::size_t copy_amount) {
         src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
@@ -472,6 +486,10 @@ void MemoryManager::WriteBlockCached(GPUVAddr gpu_dest_addr, const void* src_buf
 
 void MemoryManager::FlushRegion(GPUVAddr gpu_addr, size_t size,
                                 VideoCommon::CacheType which) const {
+    if (const auto dev_addr = GpuToCpuRange(gpu_addr, size)) [[likely]] {
+        rasterizer->FlushRegion(*dev_addr, size, which);
+        return;
+    }
     auto do_nothing = [&]([[maybe_unused]] std::size_t page_index,
                           [[maybe_unused]] std::size_t offset,
                           [[maybe_unused]] std::size_t copy_amount) {};
@@ -496,6 +514,9 @@ void MemoryManager::FlushRegion(GPUVAddr gpu_addr, size_t size,
 
 bool MemoryManager::IsMemoryDirty(GPUVAddr gpu_addr, size_t size,
                                   VideoCommon::CacheType which) const {
+    if (const auto dev_addr = GpuToCpuRange(gpu_addr, size)) [[likely]] {
+        return rasterizer->MustFlushRegion(*dev_addr, size, which);
+    }
     bool result = false;
     auto do_nothing = [&]([[maybe_unused]] std::size_t page_index,
                           [[maybe_unused]] std::size_t offset,
@@ -570,6 +591,10 @@ size_t MemoryManager::GetMemoryLayoutSize(GPUVAddr gpu_addr, size_t max_size) co
 
 void MemoryManager::InvalidateRegion(GPUVAddr gpu_addr, size_t size,
                                      VideoCommon::CacheType which) const {
+    if (const auto dev_addr = GpuToCpuRange(gpu_addr, size)) [[likely]] {
+        rasterizer->InvalidateRegion(*dev_addr, size, which);
+        return;
+    }
     auto do_nothing = [&]([[maybe_unused]] std::size_t page_index,
                           [[maybe_unused]] std::size_t offset,
                           [[maybe_unused]] std::size_t copy_amount) {};
@@ -655,6 +680,59 @@ bool MemoryManager::IsContinuousRange(GPUVAddr gpu_addr, std::size_t size) const
     return result;
 }
 
+std::optional<DAddr> MemoryManager::GpuToCpuRange(GPUVAddr gpu_addr, std::size_t size) const {
+    if (size == 0) {
+        return GpuToCpuAddress(gpu_addr);
+    }
+    // Most regions fit in a mapped big page, which is always backed by continuous device memory
+    if ((gpu_addr & big_page_mask) + size <= big_page_size && IsWithinGPUAddressRange(gpu_addr) &&
+        GetEntry<true>(gpu_addr) == EntryType::Mapped) [[likely]] {
+        const DAddr dev_addr_base =
+            static_cast<DAddr>(big_page_table_dev[PageEntryIndex<true>(gpu_addr)]) << cpu_page_bits;
+        return dev_addr_base + (gpu_addr & big_page_mask);
+    }
+    std::optional<DAddr> first_page_addr{};
+    std::optional<DAddr> old_page_addr{};
+    bool result{true};
+    auto fail = [&]([[maybe_unused]] std::size_t page_index, [[maybe_unused]] std::size_t offset,
+                    [[maybe_unused]] std::size_t copy_amount) {
+        result = false;
+        return true;
+    };
+    const auto check = [&](DAddr dev_addr_base, std::size_t copy_amount) {
+        if (old_page_addr && *old_page_addr != dev_addr_base) {
+            result = false;
+            return true;
+        }
+        if (!first_page_addr) {
+            first_page_addr = dev_addr_base;
+        }
+        old_page_addr = {dev_addr_base + copy_amount};
+        return false;
+    };
+    auto short_check = [&](std::size_t page_index, std::size_t offset, std::size_t copy_amount) {
+        const DAddr dev_addr_base =
+            (static_cast<DAddr>(page_table[page_index]) << cpu_page_bits) + offset;
+        return check(dev_addr_base, copy_amount);
+    };
+    auto big_check = [&](std::size_t page_index, std::size_t offset, std::size_t copy_amount) {
+        const DAddr dev_addr_base =
+            (static_cast<DAddr>(big_page_table_dev[page_index]) << cpu_page_bits) + offset;
+        return check(dev_addr_base, copy_amount);
+    };
+    auto check_short_pages = [&](std::size_t page_index, std::size_t offset,
+                                 std::size_t copy_amount) {
+        GPUVAddr base = (page_index << big_page_bits) + offset;
+        MemoryOperation<false>(base, copy_amount, short_check, fail, fail);
+        return !result;
+    };
+    MemoryOperation<true>(gpu_addr, size, big_check, fail, check_short_pages);
+    if (!result) {
+        return std::nullopt;
+    }
+    return first_page_addr;
+}
+
 bool MemoryManager::IsFullyMappedRange(GPUVAddr gpu_addr, std::size_t size) const {
     bool result{true};
     auto fail = [&]([[maybe_unused]] std::size_t page_index, [[maybe_unused]] std::size_t offset,
@@ -763,25 +841,19 @@ void MemoryManager::FlushCaching() {
 }
 
 const u8* MemoryManager::GetSpan(const GPUVAddr src_addr, const std::size_t size) const {
-    if (!IsContinuousRange(src_addr, size)) {
+    const auto dev_addr = GpuToCpuRange(src_addr, size);
+    if (!dev_addr) {
         return nullptr;
     }
-    auto dev_addr = GpuToCpuAddress(src_addr);
-    if (dev_addr) {
-        return memory.GetSpan(*dev_addr, size);
-    }
-    return nullptr;
+    return memory.GetSpan(*dev_addr, size);
 }
 
 u8* MemoryManager::GetSpan(const GPUVAddr src_addr, const std::size_t size) {
-    if (!IsContinuousRange(src_addr, size)) {
+    const auto dev_addr = GpuToCpuRange(src_addr, size);
+    if (!dev_addr) {
         return nullptr;
     }
-    auto dev_addr = GpuToCpuAddress(src_addr);
-    if (dev_addr) {
-        return memory.GetSpan(*dev_addr, size);
-    }
-    return nullptr;
+    return memory.GetSpan(*dev_addr, size);
 }
 
 } // namespace Tegra
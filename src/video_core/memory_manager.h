@@ -56,6 +56,12 @@ public:
 
     [[nodiscard]] std::optional<DAddr> GpuToCpuAddress(GPUVAddr addr, std::size_t size) const;
 
+    /**
+     * Returns the device address a gpu region starts at if all of it is mapped by a single range
+     * of device addresses, so it can be accessed with a single device memory operation.
+     */
+    [[nodiscard]] std::optional<DAddr> GpuToCpuRange(GPUVAddr gpu_addr, std::size_t size) const;
+
     template <typename T>
     [[nodiscard]] T Read(GPUVAddr addr) const;
 
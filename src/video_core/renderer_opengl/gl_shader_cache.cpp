@@ -51,7 +51,7 @@ using VideoCommon::LoadPipelines;
 using VideoCommon::SerializePipeline;
 using Context = ShaderContext::Context;
 
-constexpr u32 CACHE_VERSION = 10;
+constexpr u32 CACHE_VERSION = 12;
 
 template <typename Container>
 auto MakeSpan(Container& container) {
@@ -290,12 +290,18 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
             workers->QueueWork(std::move(work));
         }
     }};
-    const auto load_compute{[&](std::ifstream& file, FileEnvironment env) {
-        ComputePipelineKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
-        queue_work([this, key, env_ = std::move(env), &state, &callback](Context* ctx) mutable {
-            ctx->pools.ReleaseContents();
-            auto pipeline{CreateComputePipeline(ctx->pools, key, env_, true)};
+    const auto load_compute{[&](VideoCommon::PipelineCacheEntry entry) {
+        const auto key{entry.ReadKey<ComputePipelineKey>()};
+        if (!key) {
+            return;
+        }
+        queue_work([this, key = *key, entry = std::move(entry), &state, &callback](Context* ctx) {
+            std::unique_ptr<ComputePipeline> pipeline;
+            std::vector<FileEnvironment> envs{entry.Deserialize()};
+            if (!envs.empty()) {
+                ctx->pools.ReleaseContents();
+                pipeline = CreateComputePipeline(ctx->pools, key, envs.front(), true);
+            }
             std::scoped_lock lock{state.mutex};
             if (pipeline) {
                 compute_cache.emplace(key, std::move(pipeline));
@@ -307,16 +313,22 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         });
         ++state.total;
     }};
-    const auto load_graphics{[&](std::ifstream& file, std::vector<FileEnvironment> envs) {
-        GraphicsPipelineKey key;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key));
-        queue_work([this, key, envs_ = std::move(envs), &state, &callback](Context* ctx) mutable {
-            boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
-            for (auto& env : envs_) {
-                env_ptrs.push_back(&env);
+    const auto load_graphics{[&](VideoCommon::PipelineCacheEntry entry) {
+        const auto key{entry.ReadKey<GraphicsPipelineKey>()};
+        if (!key) {
+            return;
+        }
+        queue_work([this, key = *key, entry = std::move(entry), &state, &callback](Context* ctx) {
+            std::unique_ptr<GraphicsPipeline> pipeline;
+            std::vector<FileEnvironment> envs{entry.Deserialize()};
+            if (!envs.empty()) {
+                boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
+                for (auto& env : envs) {
+                    env_ptrs.push_back(&env);
+                }
+                ctx->pools.ReleaseContents();
+                pipeline = CreateGraphicsPipeline(ctx->pools, key, MakeSpan(env_ptrs), false, true);
             }
-            ctx->pools.ReleaseContents();
-            auto pipeline{CreateGraphicsPipeline(ctx->pools, key, MakeSpan(env_ptrs), false, true)};
             std::scoped_lock lock{state.mutex};
             if (pipeline) {
                 graphics_cache.emplace(key, std::move(pipeline));
@@ -328,7 +340,8 @@ void ShaderCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
         });
         ++state.total;
     }};
-    LoadPipelines(stop_loading, shader_cache_filename, CACHE_VERSION, load_compute, load_graphics);
+    LoadPipelines(stop_loading, shader_cache_filename, CACHE_VERSION, shader_cache_blobs,
+                  load_compute, load_graphics);
 
     LOG_INFO(Render_OpenGL, "Total Pipeline Count: {}", state.total);
 
@@ -442,7 +455,8 @@ std::unique_ptr<GraphicsPipeline> ShaderCache::CreateGraphicsPipeline() {
             env_ptrs.push_back(&environments.envs[index]);
         }
     }
-    SerializePipeline(graphics_key, env_ptrs, shader_cache_filename, CACHE_VERSION);
+    SerializePipeline(graphics_key, env_ptrs, shader_cache_filename, CACHE_VERSION,
+                      shader_cache_blobs);
     return pipeline;
 }
 
@@ -565,7 +579,7 @@ std::unique_ptr<ComputePipeline> ShaderCache::CreateComputePipeline(
         return pipeline;
     }
     SerializePipeline(key, std::array<const GenericEnvironment*, 1>{&env}, shader_cache_filename,
-                      CACHE_VERSION);
+                      CACHE_VERSION, shader_cache_blobs);
     return pipeline;
 }
 
@@ -85,6 +85,7 @@ private:
     Shader::HostTranslateInfo host_info;
 
     std::filesystem::path shader_cache_filename;
+    VideoCommon::ShaderBlobStore shader_cache_blobs;
     std::unique_ptr<ShaderWorker> workers;
 };
 
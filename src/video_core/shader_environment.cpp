@@ -2,20 +2,25 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <utility>
 
 #include "common/assert.h"
 #include "common/cityhash.h"
 #include "common/common_types.h"
 #include "common/div_ceil.h"
+#include "common/fs/file.h"
 #include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
 #include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "common/polyfill_ranges.h"
+#include "common/zstd_compression.h"
 #include "shader_recompiler/environment.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/memory_manager.h"
@@ -29,6 +34,34 @@ constexpr std::array<char, 8> MAGIC_NUMBER{'s', 'u', 'd', 'a', 'c', 'h', 'i', '0
 
 constexpr size_t INST_SIZE = sizeof(u64);
 
+/// Compression level used for serialized environments, favouring fast compression since
+/// pipelines are serialized while the game is running.
+constexpr s32 ENV_COMPRESSION_LEVEL = 3;
+
+enum class CacheEntryType : u32 {
+    Environment, ///< Compressed serialized environment, addressed by the hash of its contents
+    Pipeline,    ///< Pipeline key and the hashes of the environments it uses
+};
+
+/// Header preceding every entry in the cache file, it allows the loader to index all entries
+/// without deserializing them.
+struct CacheEntryHeader {
+    u64 size;            ///< Size in bytes of the entry following this header
+    CacheEntryType type; ///< Type of the entry
+    u32 num_envs;        ///< Number of environments used by a pipeline entry
+    Shader::Stage stage; ///< Stage of the environment, or of the first one in a pipeline
+    u32 reserved;
+};
+static_assert(sizeof(CacheEntryHeader) == 24);
+static_assert(std::is_trivially_copyable_v<CacheEntryHeader>);
+
+/// Header of an environment entry, followed by the Zstandard compressed environment
+struct EnvironmentBlobHeader {
+    u64 hash;
+    u64 uncompressed_size;
+};
+static_assert(sizeof(EnvironmentBlobHeader) == 16);
+
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
 static u64 MakeCbufKey(u32 index, u32 offset) {
@@ -67,6 +100,20 @@ static Shader::TexturePixelFormat ConvertTexturePixelFormat(const Tegra::Texture
                                    entry.a_type, entry.srgb_conversion));
 }
 
+static void ReadBytes(std::span<const u8>& data, void* dest, size_t size) {
+    if (data.size() < size) {
+        throw std::ios_base::failure("Unexpected end of pipeline cache entry");
+    }
+    std::memcpy(dest, data.data(), size);
+    data = data.subspan(size);
+}
+
+template <typename T>
+static void ReadObject(std::span<const u8>& data, T& object) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    ReadBytes(data, &object, sizeof(T));
+}
+
 static std::string_view StageToPrefix(Shader::Stage stage) {
     switch (stage) {
     case Shader::Stage::VertexB:
@@ -193,7 +240,7 @@ void GenericEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
     DumpImpl(pipeline_hash, shader_hash, code, read_highest, read_lowest, initial_offset, stage);
 }
 
-void GenericEnvironment::Serialize(std::ofstream& file) const {
+void GenericEnvironment::Serialize(std::ostream& file) const {
     const u64 code_size{static_cast<u64>(CachedSizeBytes())};
     const u64 num_texture_types{static_cast<u64>(texture_types.size())};
     const u64 num_texture_pixel_formats{static_cast<u64>(texture_pixel_formats.size())};
@@ -448,65 +495,70 @@ u32 ComputeEnvironment::ReadViewportTransformState() {
     return viewport_transform_state;
 }
 
-void FileEnvironment::Deserialize(std::ifstream& file) {
+void FileEnvironment::Deserialize(std::span<const u8>& data) {
     u64 code_size{};
     u64 num_texture_types{};
     u64 num_texture_pixel_formats{};
     u64 num_cbuf_values{};
     u64 num_cbuf_replacement_values{};
-    file.read(reinterpret_cast<char*>(&code_size), sizeof(code_size))
-        .read(reinterpret_cast<char*>(&num_texture_types), sizeof(num_texture_types))
-        .read(reinterpret_cast<char*>(&num_texture_pixel_formats),
-              sizeof(num_texture_pixel_formats))
-        .read(reinterpret_cast<char*>(&num_cbuf_values), sizeof(num_cbuf_values))
-        .read(reinterpret_cast<char*>(&num_cbuf_replacement_values),
-              sizeof(num_cbuf_replacement_values))
-        .read(reinterpret_cast<char*>(&local_memory_size), sizeof(local_memory_size))
-        .read(reinterpret_cast<char*>(&texture_bound), sizeof(texture_bound))
-        .read(reinterpret_cast<char*>(&start_address), sizeof(start_address))
-        .read(reinterpret_cast<char*>(&read_lowest), sizeof(read_lowest))
-        .read(reinterpret_cast<char*>(&read_highest), sizeof(read_highest))
-        .read(reinterpret_cast<char*>(&viewport_transform_state), sizeof(viewport_transform_state))
-        .read(reinterpret_cast<char*>(&stage), sizeof(stage));
+    ReadObject(data, code_size);
+    ReadObject(data, num_texture_types);
+    ReadObject(data, num_texture_pixel_formats);
+    ReadObject(data, num_cbuf_values);
+    ReadObject(data, num_cbuf_replacement_values);
+    ReadObject(data, local_memory_size);
+    ReadObject(data, texture_bound);
+    ReadObject(data, start_address);
+    ReadObject(data, read_lowest);
+    ReadObject(data, read_highest);
+    ReadObject(data, viewport_transform_state);
+    ReadObject(data, stage);
+    if (code_size > data.size()) {
+        throw std::ios_base::failure("Invalid shader code size in pipeline cache entry");
+    }
     code.resize(Common::DivCeil(code_size, sizeof(u64)));
-    file.read(reinterpret_cast<char*>(code.data()), code_size);
+    ReadBytes(data, code.data(), code_size);
+    texture_types.reserve(num_texture_types);
     for (size_t i = 0; i < num_texture_types; ++i) {
         u32 key;
         Shader::TextureType type;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&type), sizeof(type));
+        ReadObject(data, key);
+        ReadObject(data, type);
         texture_types.emplace(key, type);
     }
+    texture_pixel_formats.reserve(num_texture_pixel_formats);
     for (size_t i = 0; i < num_texture_pixel_formats; ++i) {
         u32 key;
         Shader::TexturePixelFormat format;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&format), sizeof(format));
+        ReadObject(data, key);
+        ReadObject(data, format);
         texture_pixel_formats.emplace(key, format);
     }
+    cbuf_values.reserve(num_cbuf_values);
     for (size_t i = 0; i < num_cbuf_values; ++i) {
         u64 key;
         u32 value;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&value), sizeof(value));
+        ReadObject(data, key);
+        ReadObject(data, value);
         cbuf_values.emplace(key, value);
     }
+    cbuf_replacements.reserve(num_cbuf_replacement_values);
     for (size_t i = 0; i < num_cbuf_replacement_values; ++i) {
         u64 key;
         Shader::ReplaceConstant value;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&value), sizeof(value));
+        ReadObject(data, key);
+        ReadObject(data, value);
         cbuf_replacements.emplace(key, value);
     }
     if (stage == Shader::Stage::Compute) {
-        file.read(reinterpret_cast<char*>(&workgroup_size), sizeof(workgroup_size))
-            .read(reinterpret_cast<char*>(&shared_memory_size), sizeof(shared_memory_size));
+        ReadObject(data, workgroup_size);
+        ReadObject(data, shared_memory_size);
         initial_offset = 0;
     } else {
-        file.read(reinterpret_cast<char*>(&sph), sizeof(sph));
+        ReadObject(data, sph);
         initial_offset = sizeof(sph);
         if (stage == Shader::Stage::Geometry) {
-            file.read(reinterpret_cast<char*>(&gp_passthrough_mask), sizeof(gp_passthrough_mask));
+            ReadObject(data, gp_passthrough_mask);
         }
     }
     is_proprietary_driver = texture_bound == 2;
@@ -582,8 +634,37 @@ std::optional<Shader::ReplaceConstant> FileEnvironment::GetReplaceConstBuffer(u3
     return it->second;
 }
 
+static void WriteEntry(std::ofstream& file, const CacheEntryHeader& header,
+                       std::span<const char> first, std::span<const char> second) {
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header))
+        .write(first.data(), first.size())
+        .write(second.data(), second.size());
+}
+
 void SerializePipeline(std::span<const char> key, std::span<const GenericEnvironment* const> envs,
-                       const std::filesystem::path& filename, u32 cache_version) try {
+                       const std::filesystem::path& filename, u32 cache_version,
+                       ShaderBlobStore& blobs) try {
+    if (!std::ranges::all_of(envs, &GenericEnvironment::CanBeSerialized)) {
+        return;
+    }
+    // Serialize the environments in memory first, they are addressed by the hash of their
+    // contents. Hashing the serialized data instead of the guest code keeps apart environments
+    // sharing the same code but recording different constant buffer or texture state.
+    std::vector<u64> hashes;
+    std::vector<std::string> serialized_envs;
+    hashes.reserve(envs.size());
+    serialized_envs.reserve(envs.size());
+    for (const GenericEnvironment* const env : envs) {
+        std::ostringstream stream;
+        stream.exceptions(std::ios::failbit);
+        env->Serialize(stream);
+        std::string& data{serialized_envs.emplace_back(std::move(stream).str())};
+        hashes.push_back(Common::CityHash64(data.data(), data.size()));
+    }
+
+    // Keep appends to the file serialized, so entries written by concurrent workers don't
+    // interleave and the set of stored blobs always matches the file contents.
+    std::scoped_lock lock{blobs.mutex};
     std::ofstream file(filename, std::ios::binary | std::ios::ate | std::ios::app);
     file.exceptions(std::ifstream::failbit);
     if (!file.is_open()) {
@@ -595,48 +676,208 @@ void SerializePipeline(std::span<const char> key, std::span<const GenericEnviron
         // Write header
         file.write(MAGIC_NUMBER.data(), MAGIC_NUMBER.size())
             .write(reinterpret_cast<const char*>(&cache_version), sizeof(cache_version));
+        blobs.hashes.clear();
     }
-    if (!std::ranges::all_of(envs, &GenericEnvironment::CanBeSerialized)) {
-        return;
-    }
-    const u32 num_envs{static_cast<u32>(envs.size())};
-    file.write(reinterpret_cast<const char*>(&num_envs), sizeof(num_envs));
-    for (const GenericEnvironment* const env : envs) {
-        env->Serialize(file);
-    }
-    file.write(key.data(), key.size_bytes());
+    for (size_t index = 0; index < envs.size(); ++index) {
+        if (!blobs.hashes.insert(hashes[index]).second) {
+            continue;
+        }
+        const std::string& data{serialized_envs[index]};
+        const std::vector<u8> compressed{Common::Compression::CompressDataZSTD(
+            reinterpret_cast<const u8*>(data.data()), data.size(), ENV_COMPRESSION_LEVEL)};
+        const EnvironmentBlobHeader blob_header{
+            .hash = hashes[index],
+            .uncompressed_size = static_cast<u64>(data.size()),
+        };
+        const CacheEntryHeader header{
+            .size = static_cast<u64>(sizeof(blob_header) + compressed.size()),
+            .type = CacheEntryType::Environment,
+            .num_envs = 1,
+            .stage = envs[index]->ShaderStage(),
+            .reserved = 0,
+        };
+        WriteEntry(file, header,
+                   std::span(reinterpret_cast<const char*>(&blob_header), sizeof(blob_header)),
+                   std::span(reinterpret_cast<const char*>(compressed.data()), compressed.size()));
+    }
+    const CacheEntryHeader header{
+        .size = static_cast<u64>(hashes.size() * sizeof(u64) + key.size_bytes()),
+        .type = CacheEntryType::Pipeline,
+        .num_envs = static_cast<u32>(envs.size()),
+        .stage = envs.front()->ShaderStage(),
+        .reserved = 0,
+    };
+    WriteEntry(file, header,
+               std::span(reinterpret_cast<const char*>(hashes.data()), hashes.size() * sizeof(u64)),
+               key);
 
 } catch (const std::ios_base::failure& e) {
     LOG_ERROR(Common_Filesystem, "{}", e.what());
+    std::scoped_lock lock{blobs.mutex};
+    blobs.hashes.clear();
     if (!Common::FS::RemoveFile(filename)) {
         LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
                   Common::FS::PathToUTF8String(filename));
     }
 }
 
-void LoadPipelines(
-    std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics) try {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
+std::vector<FileEnvironment> PipelineCacheEntry::Deserialize() const try {
+    std::vector<FileEnvironment> envs(env_blobs.size());
+    for (size_t index = 0; index < env_blobs.size(); ++index) {
+        std::span<const u8> blob{env_blobs[index]};
+        EnvironmentBlobHeader blob_header;
+        ReadObject(blob, blob_header);
+        const std::vector<u8> data{Common::Compression::DecompressDataZSTD(blob)};
+        if (data.size() != blob_header.uncompressed_size) {
+            throw std::ios_base::failure("Failed to decompress environment");
+        }
+        std::span<const u8> env_data{data};
+        envs[index].Deserialize(env_data);
+    }
+    return envs;
+} catch (const std::ios_base::failure& e) {
+    LOG_ERROR(Common_Filesystem, "Failed to deserialize pipeline cache entry: {}", e.what());
+    return {};
+}
+
+std::optional<PipelineCacheContents> ReadPipelineCache(const std::filesystem::path& filename) {
+    auto file{std::make_shared<Common::FS::MappedFile>(filename)};
+    if (!file->IsOpen()) {
+        return std::nullopt;
+    }
+    std::span<const u8> data{file->Data()};
+
+    std::array<char, 8> magic_number{};
+    PipelineCacheContents contents;
+    if (data.size() < magic_number.size() + sizeof(contents.cache_version)) {
+        LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
+        return std::nullopt;
+    }
+    std::memcpy(magic_number.data(), data.data(), magic_number.size());
+    std::memcpy(&contents.cache_version, data.data() + magic_number.size(),
+                sizeof(contents.cache_version));
+    if (magic_number != MAGIC_NUMBER) {
+        LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
+        return std::nullopt;
+    }
+    data = data.subspan(magic_number.size() + sizeof(contents.cache_version));
+    contents.valid_size = file->Size() - data.size();
+
+    // Index every entry by hopping over the headers before dispatching any of them, this only
+    // touches the headers and lets the environments be deserialized later on the worker threads.
+    std::unordered_map<u64, std::span<const u8>> env_blobs;
+    std::vector<std::pair<CacheEntryHeader, std::span<const u8>>> pipelines;
+    bool is_corrupted{};
+    while (!data.empty()) {
+        CacheEntryHeader header;
+        if (data.size() < sizeof(header)) {
+            is_corrupted = true;
+            break;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        data = data.subspan(sizeof(header));
+        if (header.size > data.size()) {
+            is_corrupted = true;
+            break;
+        }
+        const std::span<const u8> entry_data{data.first(header.size)};
+        data = data.subspan(header.size);
+
+        switch (header.type) {
+        case CacheEntryType::Environment: {
+            EnvironmentBlobHeader blob_header;
+            if (entry_data.size() < sizeof(blob_header)) {
+                is_corrupted = true;
+                break;
+            }
+            std::memcpy(&blob_header, entry_data.data(), sizeof(blob_header));
+            env_blobs.emplace(blob_header.hash, entry_data);
+            break;
+        }
+        case CacheEntryType::Pipeline:
+            if (header.num_envs == 0 || entry_data.size() < header.num_envs * sizeof(u64)) {
+                is_corrupted = true;
+                break;
+            }
+            pipelines.emplace_back(header, entry_data);
+            break;
+        default:
+            is_corrupted = true;
+            break;
+        }
+        if (is_corrupted) {
+            break;
+        }
+        contents.valid_size += sizeof(header) + header.size;
+    }
+    if (is_corrupted) {
+        // Entries are only ever appended, so everything before the first bad entry is intact.
+        // This is usually the torn tail of a write that was interrupted.
+        LOG_WARNING(Common_Filesystem, "Ignoring corrupted pipeline cache entries from offset {}",
+                    contents.valid_size);
+        contents.is_corrupted = true;
+    }
+
+    contents.env_hashes.reserve(env_blobs.size());
+    for (const auto& blob : env_blobs) {
+        contents.env_hashes.push_back(blob.first);
+    }
+    contents.entries.reserve(pipelines.size());
+    for (const auto& [header, entry_data] : pipelines) {
+        const size_t hashes_size{header.num_envs * sizeof(u64)};
+        std::vector<std::span<const u8>> entry_blobs;
+        entry_blobs.reserve(header.num_envs);
+        for (size_t index = 0; index < header.num_envs; ++index) {
+            u64 hash;
+            std::memcpy(&hash, entry_data.data() + index * sizeof(u64), sizeof(hash));
+            const auto it{env_blobs.find(hash)};
+            if (it == env_blobs.end()) {
+                break;
+            }
+            entry_blobs.push_back(it->second);
+        }
+        if (entry_blobs.size() != header.num_envs) {
+            ++contents.num_missing_envs;
+            continue;
+        }
+        contents.entries.emplace_back(file, std::move(entry_blobs),
+                                      entry_data.subspan(hashes_size), header.stage);
+    }
+    return contents;
+}
+
+void LoadPipelines(std::stop_token stop_loading, const std::filesystem::path& filename,
+                   u32 expected_cache_version, ShaderBlobStore& blobs,
+                   Common::UniqueFunction<void, PipelineCacheEntry> load_compute,
+                   Common::UniqueFunction<void, PipelineCacheEntry> load_graphics) {
+    {
+        std::scoped_lock lock{blobs.mutex};
+        blobs.hashes.clear();
+    }
+    if (!Common::FS::Exists(filename)) {
         return;
     }
-    file.exceptions(std::ifstream::failbit);
-    const auto end{file.tellg()};
-    file.seekg(0, std::ios::beg);
-
-    std::array<char, 8> magic_number;
-    u32 cache_version;
-    file.read(magic_number.data(), magic_number.size())
-        .read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version));
-    if (magic_number != MAGIC_NUMBER || cache_version != expected_cache_version) {
-        file.close();
+    std::optional<PipelineCacheContents> contents{ReadPipelineCache(filename)};
+    if (contents && contents->cache_version == expected_cache_version && contents->is_corrupted) {
+        // Cut the file at the last intact entry, so that new entries are appended after it
+        // instead of after the corrupted data. The mapping has to be released first.
+        const u64 valid_size{contents->valid_size};
+        contents.reset();
+        Common::FS::IOFile file{filename, Common::FS::FileAccessMode::ReadWrite,
+                                Common::FS::FileType::BinaryFile};
+        if (!file.IsOpen() || !file.SetSize(valid_size)) {
+            LOG_ERROR(Common_Filesystem, "Failed to truncate pipeline cache file {}",
+                      Common::FS::PathToUTF8String(filename));
+        }
+        file.Close();
+        contents = ReadPipelineCache(filename);
+    }
+    if (!contents || contents->cache_version != expected_cache_version) {
+        const bool is_old_version{contents.has_value()};
+        // Release the mapping before removing the file
+        contents.reset();
         if (Common::FS::RemoveFile(filename)) {
-            if (magic_number != MAGIC_NUMBER) {
-                LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
-            }
-            if (cache_version != expected_cache_version) {
+            if (is_old_version) {
                 LOG_INFO(Common_Filesystem, "Deleting old pipeline cache");
             }
         } else {
@@ -646,29 +887,24 @@ void LoadPipelines(
         }
         return;
     }
-    while (file.tellg() != end) {
+    {
+        std::scoped_lock lock{blobs.mutex};
+        blobs.hashes.insert(contents->env_hashes.begin(), contents->env_hashes.end());
+    }
+    if (contents->num_missing_envs != 0) {
+        LOG_WARNING(Common_Filesystem, "Skipped {} pipelines with missing environments",
+                    contents->num_missing_envs);
+    }
+    for (PipelineCacheEntry& entry : contents->entries) {
         if (stop_loading.stop_requested()) {
             return;
         }
-        u32 num_envs{};
-        file.read(reinterpret_cast<char*>(&num_envs), sizeof(num_envs));
-        std::vector<FileEnvironment> envs(num_envs);
-        for (FileEnvironment& env : envs) {
-            env.Deserialize(file);
-        }
-        if (envs.front().ShaderStage() == Shader::Stage::Compute) {
-            load_compute(file, std::move(envs.front()));
+        if (entry.IsCompute()) {
+            load_compute(std::move(entry));
         } else {
-            load_graphics(file, std::move(envs));
+            load_graphics(std::move(entry));
         }
     }
-
-} catch (const std::ios_base::failure& e) {
-    LOG_ERROR(Common_Filesystem, "{}", e.what());
-    if (!Common::FS::RemoveFile(filename)) {
-        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
-                  Common::FS::PathToUTF8String(filename));
-    }
 }
 
 } // namespace VideoCommon
@@ -4,14 +4,17 @@
 #pragma once
 
 #include <array>
+#include <cstring>
 #include <filesystem>
 #include <iosfwd>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "common/common_types.h"
@@ -20,6 +23,10 @@
 #include "shader_recompiler/environment.h"
 #include "video_core/engines/maxwell_3d.h"
 
+namespace Common::FS {
+class MappedFile;
+}
+
 namespace Tegra {
 class Memorymanager;
 }
@@ -60,7 +67,7 @@ public:
 
     void Dump(u64 pipeline_hash, u64 shader_hash) override;
 
-    void Serialize(std::ofstream& file) const;
+    void Serialize(std::ostream& file) const;
 
     bool HasHLEMacroState() const override {
         return has_hle_engine_state;
@@ -165,7 +172,9 @@ public:
     FileEnvironment& operator=(const FileEnvironment&) = delete;
     FileEnvironment(const FileEnvironment&) = delete;
 
-    void Deserialize(std::ifstream& file);
+    /// Deserializes the environment from the front of data, advancing it past the bytes read.
+    /// Throws std::ios_base::failure when data is too short.
+    void Deserialize(std::span<const u8>& data);
 
     [[nodiscard]] u64 ReadInstruction(u32 address) override;
 
@@ -212,21 +221,82 @@ private:
     u32 viewport_transform_state = 1;
 };
 
+/// Set of the environment blobs already stored in a pipeline cache file.
+/// Pipelines reference their environments by content hash, so an environment shared by many
+/// pipelines is only written once.
+struct ShaderBlobStore {
+    std::mutex mutex;
+    std::unordered_set<u64> hashes;
+};
+
 void SerializePipeline(std::span<const char> key, std::span<const GenericEnvironment* const> envs,
-                       const std::filesystem::path& filename, u32 cache_version);
+                       const std::filesystem::path& filename, u32 cache_version,
+                       ShaderBlobStore& blobs);
 
 template <typename Key, typename Envs>
 void SerializePipeline(const Key& key, const Envs& envs, const std::filesystem::path& filename,
-                       u32 cache_version) {
+                       u32 cache_version, ShaderBlobStore& blobs) {
     static_assert(std::is_trivially_copyable_v<Key>);
     static_assert(std::has_unique_object_representations_v<Key>);
     SerializePipeline(std::span(reinterpret_cast<const char*>(&key), sizeof(key)),
-                      std::span(envs.data(), envs.size()), filename, cache_version);
+                      std::span(envs.data(), envs.size()), filename, cache_version, blobs);
 }
 
-void LoadPipelines(
-    std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics);
+/// Serialized pipeline inside a mapped pipeline cache file.
+/// Entries are cheap to copy and keep the mapping alive, so they can be handed to worker threads
+/// that decompress and deserialize the environments in parallel.
+class PipelineCacheEntry {
+public:
+    explicit PipelineCacheEntry(std::shared_ptr<const Common::FS::MappedFile> file_,
+                                std::vector<std::span<const u8>> env_blobs_,
+                                std::span<const u8> key_data_, Shader::Stage stage_)
+        : file{std::move(file_)}, env_blobs{std::move(env_blobs_)}, key_data{key_data_},
+          stage{stage_} {}
+
+    [[nodiscard]] bool IsCompute() const noexcept {
+        return stage == Shader::Stage::Compute;
+    }
+
+    /// Reads the pipeline key stored in the entry
+    template <typename Key>
+    [[nodiscard]] std::optional<Key> ReadKey() const {
+        static_assert(std::is_trivially_copyable_v<Key>);
+        if (key_data.size() != sizeof(Key)) {
+            return std::nullopt;
+        }
+        Key key;
+        std::memcpy(&key, key_data.data(), sizeof(Key));
+        return key;
+    }
+
+    /// Deserializes all the environments of the entry, returns an empty vector on failure
+    [[nodiscard]] std::vector<FileEnvironment> Deserialize() const;
+
+private:
+    std::shared_ptr<const Common::FS::MappedFile> file;
+    std::vector<std::span<const u8>> env_blobs;
+    std::span<const u8> key_data;
+    Shader::Stage stage{};
+};
+
+struct PipelineCacheContents {
+    u32 cache_version{};                     ///< Version of the backend that wrote the cache
+    std::vector<u64> env_hashes;             ///< Hashes of the environments stored in the file
+    std::vector<PipelineCacheEntry> entries; ///< Pipelines with all their environments present
+    size_t num_missing_envs{};               ///< Pipelines skipped for referencing missing blobs
+    u64 valid_size{};                        ///< Size of the file up to the last intact entry
+    bool is_corrupted{};                     ///< Whether entries past valid_size were ignored
+};
+
+/// Indexes the pipelines stored in a cache file without validating its version or modifying it.
+/// Returns std::nullopt if the file does not exist or is not a valid pipeline cache. Entries from
+/// the first corrupted one onwards are ignored, the ones before it are still returned.
+[[nodiscard]] std::optional<PipelineCacheContents> ReadPipelineCache(
+    const std::filesystem::path& filename);
+
+void LoadPipelines(std::stop_token stop_loading, const std::filesystem::path& filename,
+                   u32 expected_cache_version, ShaderBlobStore& blobs,
+                   Common::UniqueFunction<void, PipelineCacheEntry> load_compute,
+                   Common::UniqueFunction<void, PipelineCacheEntry> load_graphics);
 
 } // namespace VideoCommon
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: Copyright 2024 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+/**
+ * Maps page numbers to the ids registered on them.
+ *
+ * Pages are grouped in fixed size leaves indexed directly by the upper bits of the page number,
+ * so a lookup is two dependent loads instead of a hash and a probe. The ids of a page are stored
+ * inline in its entry; only pages shared by more than INLINE_IDS ids spill to the heap. Leaves are
+ * allocated the first time one of their pages is written and are never released, since the
+ * address spaces they cover are small and get reused.
+ */
+template <typename Id>
+class ImagePageTable {
+    static constexpr u32 LEAF_BITS = 10;
+    static constexpr u64 LEAF_SIZE = 1ULL << LEAF_BITS;
+    static constexpr u64 LEAF_MASK = LEAF_SIZE - 1;
+    static constexpr size_t INLINE_IDS = 4;
+
+public:
+    using Entry = boost::container::small_vector<Id, INLINE_IDS>;
+
+    /// Returns the ids of a page, or nullptr if no id has been registered on its leaf
+    [[nodiscard]] Entry* Find(u64 page) noexcept {
+        const u64 leaf_index = page >> LEAF_BITS;
+        if (leaf_index >= leaves.size() || !leaves[leaf_index]) {
+            return nullptr;
+        }
+        return &(*leaves[leaf_index])[page & LEAF_MASK];
+    }
+
+    [[nodiscard]] const Entry* Find(u64 page) const noexcept {
+        return const_cast<ImagePageTable*>(this)->Find(page);
+    }
+
+    /// Returns the ids of a page, allocating its leaf if needed
+    [[nodiscard]] Entry& operator[](u64 page) {
+        const u64 leaf_index = page >> LEAF_BITS;
+        if (leaf_index >= leaves.size()) {
+            leaves.resize(leaf_index + 1);
+        }
+        auto& leaf = leaves[leaf_index];
+        if (!leaf) {
+            leaf = std::make_unique<Leaf>();
+        }
+        return (*leaf)[page & LEAF_MASK];
+    }
+
+private:
+    using Leaf = std::array<Entry, LEAF_SIZE>;
+
+    std::vector<std::unique_ptr<Leaf>> leaves;
+};
+
+} // namespace VideoCommon
@@ -732,13 +732,12 @@ template <class P>
 std::pair<typename P::ImageView*, bool> TextureCache<P>::TryFindFramebufferImageView(
     const Tegra::FramebufferConfig& config, DAddr cpu_addr) {
     // TODO: Properly implement this
-    const auto it = page_table.find(cpu_addr >> SUDACHI_PAGEBITS);
-    if (it == page_table.end()) {
+    const auto* const image_map_ids = page_table.Find(cpu_addr >> SUDACHI_PAGEBITS);
+    if (!image_map_ids) {
         return {};
     }
-    const auto& image_map_ids = it->second;
     boost::container::small_vector<ImageId, 4> valid_image_ids;
-    for (const ImageMapId map_id : image_map_ids) {
+    for (const ImageMapId map_id : *image_map_ids) {
         const ImageMapView& map = slot_map_views[map_id];
         const ImageBase& image = slot_images[map.image_id];
         if (image.cpu_addr != cpu_addr) {
@@ -1812,15 +1811,15 @@ void TextureCache<P>::ForEachImageInRegion(DAddr cpu_addr, size_t size, Func&& f
     boost::container::small_vector<ImageId, 32> images;
     boost::container::small_vector<ImageMapId, 32> maps;
     ForEachCPUPage(cpu_addr, size, [this, &images, &maps, cpu_addr, size, func](u64 page) {
-        const auto it = page_table.find(page);
-        if (it == page_table.end()) {
+        const auto* const map_ids = page_table.Find(page);
+        if (!map_ids) {
             if constexpr (BOOL_BREAK) {
                 return false;
             } else {
                 return;
             }
         }
-        for (const ImageMapId map_id : it->second) {
+        for (const ImageMapId map_id : *map_ids) {
             ImageMapView& map = slot_map_views[map_id];
             if (map.picked) {
                 continue;
@@ -1870,15 +1869,15 @@ void TextureCache<P>::ForEachImageInRegionGPU(size_t as_id, GPUVAddr gpu_addr, s
     auto& gpu_page_table = gpu_page_table_storage[*storage_id * 2];
     ForEachGPUPage(gpu_addr, size,
                    [this, &gpu_page_table, &images, gpu_addr, size, func](u64 page) {
-                       const auto it = gpu_page_table.find(page);
-                       if (it == gpu_page_table.end()) {
+                       const auto* const image_ids = gpu_page_table.Find(page);
+                       if (!image_ids) {
                            if constexpr (BOOL_BREAK) {
                                return false;
                            } else {
                                return;
                            }
                        }
-                       for (const ImageId image_id : it->second) {
+                       for (const ImageId image_id : *image_ids) {
                            Image& image = slot_images[image_id];
                            if (True(image.flags & ImageFlagBits::Picked)) {
                                continue;
@@ -1919,15 +1918,15 @@ void TextureCache<P>::ForEachSparseImageInRegion(size_t as_id, GPUVAddr gpu_addr
     auto& sparse_page_table = gpu_page_table_storage[*storage_id * 2 + 1];
     ForEachGPUPage(gpu_addr, size,
                    [this, &sparse_page_table, &images, gpu_addr, size, func](u64 page) {
-                       const auto it = sparse_page_table.find(page);
-                       if (it == sparse_page_table.end()) {
+                       const auto* const image_ids = sparse_page_table.Find(page);
+                       if (!image_ids) {
                            if constexpr (BOOL_BREAK) {
                                return false;
                            } else {
                                return;
                            }
                        }
-                       for (const ImageId image_id : it->second) {
+                       for (const ImageId image_id : *image_ids) {
                            Image& image = slot_images[image_id];
                            if (True(image.flags & ImageFlagBits::Picked)) {
                                continue;
@@ -2034,16 +2033,14 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
     image.flags &= ~ImageFlagBits::BadOverlap;
     lru_cache.Free(image.lru_index);
     const auto& clear_page_table =
-        [image_id](u64 page,
-                   std::unordered_map<u64, std::vector<ImageId>, Common::IdentityHash<u64>>&
-                       selected_page_table) {
-            const auto page_it = selected_page_table.find(page);
-            if (page_it == selected_page_table.end()) {
+        [image_id](u64 page, TextureCacheGPUMap& selected_page_table) {
+            auto* const page_image_ids = selected_page_table.Find(page);
+            if (!page_image_ids) {
                 ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}",
                            page << SUDACHI_PAGEBITS);
                 return;
             }
-            std::vector<ImageId>& image_ids = page_it->second;
+            auto& image_ids = *page_image_ids;
             const auto vector_it = std::ranges::find(image_ids, image_id);
             if (vector_it == image_ids.end()) {
                 ASSERT_MSG(false, "Unregistering unregistered image in page=0x{:x}",
@@ -2058,13 +2055,13 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
     if (False(image.flags & ImageFlagBits::Sparse)) {
         const auto map_id = image.map_view_id;
         ForEachCPUPage(image.cpu_addr, image.guest_size_bytes, [this, map_id](u64 page) {
-            const auto page_it = page_table.find(page);
-            if (page_it == page_table.end()) {
+            auto* const page_map_ids = page_table.Find(page);
+            if (!page_map_ids) {
                 ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}",
                            page << SUDACHI_PAGEBITS);
                 return;
             }
-            std::vector<ImageMapId>& image_map_ids = page_it->second;
+            auto& image_map_ids = *page_map_ids;
             const auto vector_it = std::ranges::find(image_map_ids, map_id);
             if (vector_it == image_map_ids.end()) {
                 ASSERT_MSG(false, "Unregistering unregistered image in page=0x{:x}",
@@ -2087,13 +2084,13 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
         const DAddr cpu_addr = map_range.cpu_addr;
         const std::size_t size = map_range.size;
         ForEachCPUPage(cpu_addr, size, [this, image_id](u64 page) {
-            const auto page_it = page_table.find(page);
-            if (page_it == page_table.end()) {
+            auto* const page_map_ids = page_table.Find(page);
+            if (!page_map_ids) {
                 ASSERT_MSG(false, "Unregistering unregistered page=0x{:x}",
                            page << SUDACHI_PAGEBITS);
                 return;
             }
-            std::vector<ImageMapId>& image_map_ids = page_it->second;
+            auto& image_map_ids = *page_map_ids;
             auto vector_it = image_map_ids.begin();
             while (vector_it != image_map_ids.end()) {
                 ImageMapView& map = slot_map_views[*vector_it];
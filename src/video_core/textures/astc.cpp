@@ -5,6 +5,7 @@
 // <http://gamma.cs.unc.edu/FasTC/>
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <cassert>
 #include <cstring>
@@ -1079,7 +1080,8 @@ static void UnquantizeTexelWeights(u32 out[2][144], const IntegerEncodedVector&
                                    const TexelWeightParams& params, const u32 blockWidth,
                                    const u32 blockHeight) {
     u32 weightIdx = 0;
-    u32 unquantized[2][144];
+    // Leave room after the largest grid for the padding read by the infill
+    u32 unquantized[2][144 + 13];
 
     for (auto itr = weights.begin(); itr != weights.end(); ++itr) {
         unquantized[0][weightIdx] = UnquantizeTexelWeight(*itr);
@@ -1097,50 +1099,60 @@ static void UnquantizeTexelWeights(u32 out[2][144], const IntegerEncodedVector&
     }
 
     // Do infill if necessary (Section C.2.18) ...
-    u32 Ds = (1024 + (blockWidth / 2)) / (blockWidth - 1);
-    u32 Dt = (1024 + (blockHeight / 2)) / (blockHeight - 1);
+    // The bilinear taps only depend on the column or on the row of the texel, so they are computed
+    // once per axis instead of once per texel and plane.
+    const u32 Ds = (1024 + (blockWidth / 2)) / (blockWidth - 1);
+    const u32 Dt = (1024 + (blockHeight / 2)) / (blockHeight - 1);
+
+    std::array<u32, 12> js, fs;
+    bool identity = blockWidth == params.m_Width && blockHeight == params.m_Height;
+    for (u32 s = 0; s < blockWidth; s++) {
+        const u32 gs = (Ds * s * (params.m_Width - 1) + 32) >> 6;
+        js[s] = gs >> 4;
+        fs[s] = gs & 0xF;
+        identity &= js[s] == s && fs[s] == 0;
+    }
+    std::array<u32, 12> jt, ft;
+    for (u32 t = 0; t < blockHeight; t++) {
+        const u32 gt = (Dt * t * (params.m_Height - 1) + 32) >> 6;
+        jt[t] = gt >> 4;
+        ft[t] = gt & 0xF;
+        identity &= jt[t] == t && ft[t] == 0;
+    }
 
     const u32 kPlaneScale = params.m_bDualPlane ? 2U : 1U;
-    for (u32 plane = 0; plane < kPlaneScale; plane++)
-        for (u32 t = 0; t < blockHeight; t++)
-            for (u32 s = 0; s < blockWidth; s++) {
-                u32 cs = Ds * s;
-                u32 ct = Dt * t;
-
-                u32 gs = (cs * (params.m_Width - 1) + 32) >> 6;
-                u32 gt = (ct * (params.m_Height - 1) + 32) >> 6;
-
-                u32 js = gs >> 4;
-                u32 fs = gs & 0xF;
-
-                u32 jt = gt >> 4;
-                u32 ft = gt & 0x0F;
-
-                u32 w11 = (fs * ft + 8) >> 4;
-                u32 w10 = ft - w11;
-                u32 w01 = fs - w11;
-                u32 w00 = 16 - fs - ft + w11;
-
-                u32 v0 = js + jt * params.m_Width;
-
-#define FIND_TEXEL(tidx, bidx)                                                                     \
-    u32 p##bidx = 0;                                                                               \
-    do {                                                                                           \
-        if ((tidx) < (params.m_Width * params.m_Height)) {                                         \
-            p##bidx = unquantized[plane][(tidx)];                                                  \
-        }                                                                                          \
-    } while (0)
-
-                FIND_TEXEL(v0, 00);
-                FIND_TEXEL(v0 + 1, 01);
-                FIND_TEXEL(v0 + params.m_Width, 10);
-                FIND_TEXEL(v0 + params.m_Width + 1, 11);
+    const u32 numWeights = params.m_Width * params.m_Height;
+    if (identity) {
+        // The weight grid has the same resolution as the block, every texel takes its own weight
+        for (u32 plane = 0; plane < kPlaneScale; plane++) {
+            std::memcpy(out[plane], unquantized[plane], numWeights * sizeof(u32));
+        }
+        return;
+    }
 
-#undef FIND_TEXEL
+    for (u32 plane = 0; plane < kPlaneScale; plane++) {
+        // Taps past the end of the grid read zero, pad the grid so the loop below needs no checks
+        std::fill_n(unquantized[plane] + numWeights, params.m_Width + 1, 0U);
 
-                out[plane][t * blockWidth + s] =
-                    (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11 + 8) >> 4;
+        for (u32 t = 0; t < blockHeight; t++) {
+            const u32* const row = unquantized[plane] + jt[t] * params.m_Width;
+            u32* const outRow = out[plane] + t * blockWidth;
+            for (u32 s = 0; s < blockWidth; s++) {
+                const u32 w11 = (fs[s] * ft[t] + 8) >> 4;
+                const u32 w10 = ft[t] - w11;
+                const u32 w01 = fs[s] - w11;
+                const u32 w00 = 16 - fs[s] - ft[t] + w11;
+
+                const u32* const p = row + js[s];
+                const u32 p00 = p[0];
+                const u32 p01 = p[1];
+                const u32 p10 = p[params.m_Width];
+                const u32 p11 = p[params.m_Width + 1];
+
+                outRow[s] = (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11 + 8) >> 4;
             }
+        }
+    }
 }
 
 // Transfers a bit as described in C.2.14
@@ -1619,36 +1631,48 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
 
     // Now that we have endpoints and weights, we can interpolate and generate
     // the proper decoding...
-    for (u32 j = 0; j < blockHeight; j++)
+    // Expand the endpoints to 16 bits once per partition instead of once per texel
+    std::array<std::array<u32, 4>, 4> lowEndpoints;
+    std::array<std::array<u32, 4>, 4> highEndpoints;
+    for (u32 i = 0; i < nPartitions; i++) {
+        for (u32 c = 0; c < 4; c++) {
+            lowEndpoints[i][c] = ReplicateByteTo16(endpoints[i][0].Component(c));
+            highEndpoints[i][c] = ReplicateByteTo16(endpoints[i][1].Component(c));
+        }
+    }
+
+    // Weight plane read by each component, the selected component takes the second plane
+    std::array<const u32*, 4> componentWeights{weights[0], weights[0], weights[0], weights[0]};
+    if (weightParams.m_bDualPlane) {
+        componentWeights[(planeIdx + 1) & 3] = weights[1];
+    }
+
+    // Components are stored as ARGB, pack them as R8G8B8A8
+    static constexpr std::array<u32, 4> componentShifts{24, 0, 8, 16};
+
+    const bool smallBlock = (blockHeight * blockWidth) < 32;
+    for (u32 j = 0; j < blockHeight; j++) {
         for (u32 i = 0; i < blockWidth; i++) {
-            u32 partition = Select2DPartition(partitionIndex, i, j, nPartitions,
-                                              (blockHeight * blockWidth) < 32);
+            const u32 partition =
+                nPartitions == 1
+                    ? 0
+                    : Select2DPartition(partitionIndex, i, j, nPartitions, smallBlock);
             assert(partition < nPartitions);
 
-            Pixel p;
+            const u32 texel = j * blockWidth + i;
+            const std::array<u32, 4>& C0 = lowEndpoints[partition];
+            const std::array<u32, 4>& C1 = highEndpoints[partition];
+            u32 packed = 0;
             for (u32 c = 0; c < 4; c++) {
-                u32 C0 = endpoints[partition][0].Component(c);
-                C0 = ReplicateByteTo16(C0);
-                u32 C1 = endpoints[partition][1].Component(c);
-                C1 = ReplicateByteTo16(C1);
-
-                u32 plane = 0;
-                if (weightParams.m_bDualPlane && (((planeIdx + 1) & 3) == c)) {
-                    plane = 1;
-                }
-
-                u32 weight = weights[plane][j * blockWidth + i];
-                u32 C = (C0 * (64 - weight) + C1 * weight + 32) / 64;
-                if (C == 65535) {
-                    p.Component(c) = 255;
-                } else {
-                    double Cf = static_cast<double>(C);
-                    p.Component(c) = static_cast<u16>(255.0 * (Cf / 65536.0) + 0.5);
-                }
+                const u32 weight = componentWeights[c][texel];
+                const u32 C = (C0[c] * (64 - weight) + C1[c] * weight + 32) / 64;
+                // Integer form of round(255 * C / 65536), it is exact for every 16-bit C
+                const u32 value = (C * 255 + 32768) >> 16;
+                packed |= value << componentShifts[c];
             }
-
-            outBuf[j * blockWidth + i] = p.Pack();
+            outBuf[texel] = packed;
         }
+    }
 }
 
 void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
@@ -1656,38 +1680,56 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
     const u32 rows = Common::DivideUp(height, block_height);
     const u32 cols = Common::DivideUp(width, block_width);
 
-    Common::ThreadWorker& workers{GetThreadWorkers()};
-
-    for (u32 z = 0; z < depth; ++z) {
-        const u32 depth_offset = z * height * width * 4;
-        for (u32 y_index = 0; y_index < rows; ++y_index) {
-            auto decompress_stride = [data, width, height, block_width, block_height, output, rows,
-                                      cols, z, depth_offset, y_index] {
-                const u32 y = y_index * block_height;
-                for (u32 x_index = 0; x_index < cols; ++x_index) {
-                    const u32 block_index = (z * rows * cols) + (y_index * cols) + x_index;
-                    const u32 x = x_index * block_width;
-
-                    const std::span<const u8, 16> blockPtr{data.subspan(block_index * 16, 16)};
-
-                    // Blocks can be at most 12x12
-                    std::array<u32, 12 * 12> uncompData;
-                    DecompressBlock(blockPtr, block_width, block_height, uncompData);
-
-                    u32 decompWidth = std::min(block_width, width - x);
-                    u32 decompHeight = std::min(block_height, height - y);
-
-                    const std::span<u8> outRow = output.subspan(depth_offset + (y * width + x) * 4);
-                    for (u32 h = 0; h < decompHeight; ++h) {
-                        std::memcpy(outRow.data() + h * width * 4,
-                                    uncompData.data() + h * block_width, decompWidth * 4);
-                    }
+    // Rows of all slices are independent, each job decodes a contiguous range of them
+    const auto decompress_rows = [data, width, height, block_width, block_height, output, rows,
+                                  cols](u32 first_row, u32 last_row) {
+        for (u32 row = first_row; row < last_row; ++row) {
+            const u32 z = row / rows;
+            const u32 y_index = row % rows;
+            const u32 depth_offset = z * height * width * 4;
+            const u32 y = y_index * block_height;
+            for (u32 x_index = 0; x_index < cols; ++x_index) {
+                const u32 block_index = (row * cols) + x_index;
+                const u32 x = x_index * block_width;
+
+                const std::span<const u8, 16> blockPtr{data.subspan(block_index * 16, 16)};
+
+                // Blocks can be at most 12x12
+                std::array<u32, 12 * 12> uncompData;
+                DecompressBlock(blockPtr, block_width, block_height, uncompData);
+
+                u32 decompWidth = std::min(block_width, width - x);
+                u32 decompHeight = std::min(block_height, height - y);
+
+                const std::span<u8> outRow = output.subspan(depth_offset + (y * width + x) * 4);
+                for (u32 h = 0; h < decompHeight; ++h) {
+                    std::memcpy(outRow.data() + h * width * 4,
+                                uncompData.data() + h * block_width, decompWidth * 4);
                 }
-            };
-            workers.QueueWork(std::move(decompress_stride));
+            }
         }
-        workers.WaitForRequests();
+    };
+
+    // Batch small rows together, queueing a job costs more than decoding a handful of blocks
+    static constexpr u32 MIN_BLOCKS_PER_JOB = 64;
+    const u32 rows_per_job = std::max(1U, MIN_BLOCKS_PER_JOB / cols);
+    const u32 total_rows = rows * depth;
+    if (total_rows <= rows_per_job) {
+        decompress_rows(0, total_rows);
+        return;
+    }
+
+    std::vector<Common::UniqueFunction<void>> jobs;
+    jobs.reserve(Common::DivideUp(total_rows, rows_per_job));
+    for (u32 first_row = 0; first_row < total_rows; first_row += rows_per_job) {
+        const u32 last_row = std::min(first_row + rows_per_job, total_rows);
+        jobs.emplace_back([decompress_rows, first_row, last_row] {
+            decompress_rows(first_row, last_row);
+        });
     }
+    Common::ThreadWorker& workers{GetThreadWorkers()};
+    workers.QueueWorkBatch(std::move(jobs));
+    workers.WaitForRequests();
 }
 
 } // namespace Tegra::Texture::ASTC
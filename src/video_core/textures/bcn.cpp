@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2023 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <vector>
+
 #include <stb_dxt.h>
 #include <string.h>
 #include "common/alignment.h"
@@ -18,7 +20,8 @@ void CompressBCN(std::span<const uint8_t> data, uint32_t width, uint32_t height,
     constexpr u32 bytes_per_px = 4;
     const u32 plane_dim = width * height;
 
-    Common::ThreadWorker& workers{GetThreadWorkers()};
+    std::vector<Common::UniqueFunction<void>> rows;
+    rows.reserve(depth * Common::DivideUp(height, 4U));
 
     for (u32 z = 0; z < depth; z++) {
         for (u32 y = 0; y < height; y += 4) {
@@ -60,10 +63,13 @@ void CompressBCN(std::span<const uint8_t> data, uint32_t width, uint32_t height,
                       reinterpret_cast<u8*>(input_colors), any_alpha);
                 }
             };
-            workers.QueueWork(std::move(compress_row));
+            rows.emplace_back(std::move(compress_row));
         }
-        workers.WaitForRequests();
     }
+
+    Common::ThreadWorker& workers{GetThreadWorkers()};
+    workers.QueueWorkBatch(std::move(rows));
+    workers.WaitForRequests();
 }
 
 void CompressBC1(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
@@ -1,7 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2018 sudachi Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
 #include <cstring>
 #include <span>
@@ -33,6 +35,46 @@ void incrpdep(u32& value) {
     value = ((value | ~mask) + swizzled_incr) & mask;
 }
 
+/// Bytes along X that are stored contiguously inside a GOB
+constexpr u32 GOB_RUN_SIZE = 16;
+
+/**
+ * Copies bytes [begin_x, end_x) of a line between linear and block linear memory.
+ * Inside a GOB every aligned run of 16 bytes along X is stored contiguously, so the line is
+ * copied in whole runs, each of them a single unaligned vector move, instead of pixel by pixel.
+ * Only the unaligned head and tail of the line are copied with a variable size.
+ */
+template <bool TO_LINEAR>
+void SwizzleLine(u8* output, const u8* input, u32 begin_x, u32 end_x, u32 base_swizzled_offset,
+                 u32 swizzled_y, u32 x_shift, u32 unswizzled_offset) {
+    const auto copy_run = [&](u32 x, u32 swizzled_x, u32 size) {
+        const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
+        const u32 swizzled_offset = base_swizzled_offset + offset_x + (swizzled_x | swizzled_y);
+        const u32 linear_offset = unswizzled_offset + (x - begin_x);
+        u8* const dst = output + (TO_LINEAR ? swizzled_offset : linear_offset);
+        const u8* const src = input + (TO_LINEAR ? linear_offset : swizzled_offset);
+        if (size == GOB_RUN_SIZE) {
+            std::memcpy(dst, src, GOB_RUN_SIZE);
+        } else {
+            std::memcpy(dst, src, size);
+        }
+    };
+    u32 x = begin_x;
+    const u32 head_end = std::min(Common::AlignUp(x, GOB_RUN_SIZE), end_x);
+    if (x != head_end) {
+        copy_run(x, pdep<SWIZZLE_X_BITS>(x), head_end - x);
+        x = head_end;
+    }
+    u32 swizzled_x = pdep<SWIZZLE_X_BITS>(x);
+    for (; x + GOB_RUN_SIZE <= end_x;
+         x += GOB_RUN_SIZE, incrpdep<SWIZZLE_X_BITS, GOB_RUN_SIZE>(swizzled_x)) {
+        copy_run(x, swizzled_x, GOB_RUN_SIZE);
+    }
+    if (x != end_x) {
+        copy_run(x, swizzled_x, end_x - x);
+    }
+}
+
 template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
 void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height, u32 depth,
                  u32 block_height, u32 block_depth, u32 stride) {
@@ -67,23 +109,9 @@ void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
-            u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
-            for (u32 column = 0; column < width;
-                 ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
-                const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
-
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * BYTES_PER_PIXEL;
-
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
-
-                std::memcpy(dst, src, BYTES_PER_PIXEL);
-            }
+            SwizzleLine<TO_LINEAR>(output.data(), input.data(), origin_x * BYTES_PER_PIXEL,
+                                   (origin_x + width) * BYTES_PER_PIXEL, offset_z + offset_y,
+                                   swizzled_y, x_shift, slice * pitch * height + line * pitch);
         }
     }
 }
@@ -126,23 +154,9 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
-            u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
-            for (u32 column = 0; column < extent_x;
-                 ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
-                const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
-
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * BYTES_PER_PIXEL;
-
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
-
-                std::memcpy(dst, src, BYTES_PER_PIXEL);
-            }
+            SwizzleLine<TO_LINEAR>(output.data(), input.data(), origin_x * BYTES_PER_PIXEL,
+                                   (origin_x + extent_x) * BYTES_PER_PIXEL, offset_z + offset_y,
+                                   swizzled_y, x_shift, slice * pitch * height + line * pitch);
         }
         unprocessed_lines -= lines_in_y;
         if (unprocessed_lines == 0) {